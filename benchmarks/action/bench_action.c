@@ -0,0 +1,95 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "benchmark.h"
+#include "bench_keyboard.h"
+#include "action.h"
+#include "action_layer.h"
+#include "keyboard.h"
+#include "timer.h"
+
+// A plain key, straight through action_exec
+static void bench_action_exec_tap(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        action_exec(MAKE_KEYEVENT(0, 0, true));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(0, 0, false));
+        advance_time(1);
+    }
+    state->items_processed = state->iterations * 2;
+}
+BENCHMARK(bench_action_exec_tap);
+
+// A mod-tap, buffered by action_tapping until released
+static void bench_action_exec_mod_tap(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        action_exec(MAKE_KEYEVENT(0, 1, true));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(0, 1, false));
+        advance_time(1);
+    }
+    state->items_processed = state->iterations * 2;
+}
+BENCHMARK(bench_action_exec_mod_tap);
+
+// A key rolled over while another is held
+static void bench_action_exec_roll(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        action_exec(MAKE_KEYEVENT(1, 0, true));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(1, 1, true));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(1, 0, false));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(1, 1, false));
+        advance_time(1);
+    }
+    state->items_processed = state->iterations * 4;
+}
+BENCHMARK(bench_action_exec_roll);
+
+// Keycode lookup with only the base layer active
+static void bench_layer_resolve_base(bench_state_t *state) {
+    uint8_t col = 0;
+    while (bench_keep_running(state)) {
+        BENCH_DO_NOT_OPTIMIZE(layer_switch_get_action(MAKE_KEYPOS(2, col)));
+        col = col + 1 < MATRIX_COLS ? col + 1 : 0;
+    }
+    state->items_processed = state->iterations;
+}
+BENCHMARK(bench_layer_resolve_base);
+
+// Keycode lookup falling through three transparent layers
+static void bench_layer_resolve_transparent(bench_state_t *state) {
+    layer_state_set((1 << 0) | (1 << 1) | (1 << 2) | (1 << 3));
+    uint8_t col = 0;
+    while (bench_keep_running(state)) {
+        BENCH_DO_NOT_OPTIMIZE(layer_switch_get_action(MAKE_KEYPOS(2, col)));
+        col = col + 1 < MATRIX_COLS ? col + 1 : 0;
+    }
+    state->items_processed = state->iterations;
+}
+BENCHMARK(bench_layer_resolve_transparent);
+
+// A complete keyboard_task pass with nothing changing
+static void bench_keyboard_task_idle(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        keyboard_task();
+        advance_time(1);
+    }
+}
+BENCHMARK(bench_keyboard_task_idle);
+
+// Complete keyboard_task passes scanning a key press and release
+static void bench_keyboard_task_tap(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        bench_press_key(0, 0);
+        keyboard_task();
+        advance_time(1);
+        bench_release_key(0, 0);
+        keyboard_task();
+        advance_time(1);
+    }
+    state->items_processed = state->iterations * 2;
+}
+BENCHMARK(bench_keyboard_task_tap);
@@ -0,0 +1,33 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A,    LSFT_T(KC_B), MO(1),   KC_D,    KC_E,    KC_F,    KC_G,    KC_H,    KC_I,    KC_J},
+        {KC_K,    KC_L,         KC_M,    KC_N,    KC_O,    KC_P,    KC_Q,    KC_R,    KC_S,    KC_T},
+        {KC_U,    KC_V,         KC_W,    KC_X,    KC_Y,    KC_Z,    KC_1,    KC_2,    KC_3,    KC_4},
+        {KC_5,    KC_6,         KC_7,    KC_8,    KC_9,    KC_0,    KC_LSFT, KC_LCTL, KC_LALT, KC_LGUI},
+    },
+    [1] = {
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+    },
+    [2] = {
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+    },
+    [3] = {
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______,      _______, _______, _______, _______, _______, _______, _______, _______},
+    },
+};
+// clang-format on
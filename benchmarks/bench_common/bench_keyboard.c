@@ -0,0 +1,99 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "bench_keyboard.h"
+#include "benchmark.h"
+#include <string.h>
+#include "action.h"
+#include "action_layer.h"
+#include "action_util.h"
+#include "eeconfig.h"
+#include "host.h"
+#include "keyboard.h"
+#include "matrix.h"
+#include "print.h"
+#include "timer.h"
+
+static matrix_row_t matrix[MATRIX_ROWS];
+static uint32_t     reports_sent;
+
+void matrix_init(void) {
+    memset(matrix, 0, sizeof(matrix));
+    matrix_init_kb();
+}
+
+uint8_t matrix_scan(void) {
+    matrix_scan_kb();
+    return 1;
+}
+
+matrix_row_t matrix_get_row(uint8_t row) {
+    return matrix[row];
+}
+
+void matrix_print(void) {}
+
+void matrix_init_kb(void) {}
+
+void matrix_scan_kb(void) {}
+
+bool matrix_is_on(uint8_t row, uint8_t col) {
+    return matrix[row] & ((matrix_row_t)1 << col);
+}
+
+void bench_press_key(uint8_t row, uint8_t col) {
+    matrix[row] |= (matrix_row_t)1 << col;
+}
+
+void bench_release_key(uint8_t row, uint8_t col) {
+    matrix[row] &= ~((matrix_row_t)1 << col);
+}
+
+static uint8_t bench_keyboard_leds(void) {
+    return 0;
+}
+
+static void bench_send_keyboard(report_keyboard_t *report) {
+    reports_sent++;
+}
+
+static void bench_send_nkro(report_nkro_t *report) {
+    reports_sent++;
+}
+
+static void bench_send_mouse(report_mouse_t *report) {
+    reports_sent++;
+}
+
+static void bench_send_extra(report_extra_t *report) {
+    reports_sent++;
+}
+
+static host_driver_t bench_driver = {bench_keyboard_leds, bench_send_keyboard, bench_send_nkro, bench_send_mouse, bench_send_extra};
+
+uint32_t bench_reports_sent(void) {
+    return reports_sent;
+}
+
+static int8_t bench_sendchar(uint8_t c) {
+    return 0;
+}
+
+void bench_keyboard_init(void) {
+    print_set_sendchar(bench_sendchar);
+    timer_clear();
+    eeconfig_init_quantum();
+    host_set_driver(&bench_driver);
+    keyboard_init();
+}
+
+void bench_keyboard_reset(void) {
+    memset(matrix, 0, sizeof(matrix));
+    clear_keyboard();
+    layer_clear();
+    reports_sent = 0;
+}
+
+__attribute__((weak)) void bench_setup(void) {
+    bench_keyboard_reset();
+}
@@ -0,0 +1,26 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** \brief Bring up the keyboard as main() would, with a host driver discarding all reports
+ */
+void bench_keyboard_init(void);
+
+/** \brief Return the keyboard to its idle state: no keys held, no layers, empty reports
+ */
+void bench_keyboard_reset(void);
+
+/** \brief Number of reports handed to the host driver since the last reset
+ */
+uint32_t bench_reports_sent(void);
+
+void bench_press_key(uint8_t row, uint8_t col);
+void bench_release_key(uint8_t row, uint8_t col);
+
+/* Simulated time, provided by the test platform */
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
@@ -0,0 +1,198 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "benchmark.h"
+#include "bench_keyboard.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef BENCH_MAX_BENCHMARKS
+#    define BENCH_MAX_BENCHMARKS 256
+#endif
+
+#define BENCH_MAX_ITERATIONS 1000000000ULL
+
+typedef struct bench_entry_t {
+    const char  *name;
+    bench_func_t func;
+    intptr_t     arg;
+} bench_entry_t;
+
+typedef struct bench_result_t {
+    const char *name;
+    uint64_t    iterations;
+    double      real_ns;
+    double      cpu_ns;
+    double      items_per_second;
+} bench_result_t;
+
+static bench_entry_t  benchmarks[BENCH_MAX_BENCHMARKS];
+static bench_result_t results[BENCH_MAX_BENCHMARKS];
+static uint16_t       benchmark_count = 0;
+
+static uint64_t clock_ns(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void bench_register(const char *name, bench_func_t func, intptr_t arg) {
+    if (benchmark_count >= BENCH_MAX_BENCHMARKS) {
+        fprintf(stderr, "Too many benchmarks, increase BENCH_MAX_BENCHMARKS\n");
+        exit(1);
+    }
+    benchmarks[benchmark_count++] = (bench_entry_t){.name = name, .func = func, .arg = arg};
+}
+
+bool bench_keep_running(bench_state_t *state) {
+    if (state->remaining == state->iterations) {
+        state->start_ns     = clock_ns(CLOCK_MONOTONIC);
+        state->start_cpu_ns = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+    }
+    if (state->remaining == 0) {
+        return false;
+    }
+    --state->remaining;
+    return true;
+}
+
+void bench_pause_timing(bench_state_t *state) {
+    state->pause_start_ns     = clock_ns(CLOCK_MONOTONIC);
+    state->pause_start_cpu_ns = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+void bench_resume_timing(bench_state_t *state) {
+    state->paused_ns += clock_ns(CLOCK_MONOTONIC) - state->pause_start_ns;
+    state->paused_cpu_ns += clock_ns(CLOCK_PROCESS_CPUTIME_ID) - state->pause_start_cpu_ns;
+}
+
+static void run_once(const bench_entry_t *entry, uint64_t iterations, double *real_ns, double *cpu_ns, uint64_t *items) {
+    bench_state_t state = {.iterations = iterations, .remaining = iterations, .arg = entry->arg};
+
+    bench_setup();
+    entry->func(&state);
+
+    uint64_t end_ns     = clock_ns(CLOCK_MONOTONIC);
+    uint64_t end_cpu_ns = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+    *real_ns            = (double)(end_ns - state.start_ns - state.paused_ns);
+    *cpu_ns             = (double)(end_cpu_ns - state.start_cpu_ns - state.paused_cpu_ns);
+    *items              = state.items_processed;
+}
+
+static void run_benchmark(const bench_entry_t *entry, double min_time_ns, bench_result_t *result) {
+    uint64_t iterations = 1;
+    double   real_ns, cpu_ns;
+    uint64_t items;
+
+    for (;;) {
+        run_once(entry, iterations, &real_ns, &cpu_ns, &items);
+        if (real_ns >= min_time_ns || iterations >= BENCH_MAX_ITERATIONS) {
+            break;
+        }
+        // Aim slightly past the minimum time, growing by at most 10x per attempt
+        double multiplier = real_ns > 0 ? min_time_ns * 1.4 / real_ns : 10;
+        if (multiplier > 10) {
+            multiplier = 10;
+        }
+        uint64_t next = (uint64_t)(iterations * multiplier);
+        iterations    = next > iterations ? next : iterations + 1;
+        if (iterations > BENCH_MAX_ITERATIONS) {
+            iterations = BENCH_MAX_ITERATIONS;
+        }
+    }
+
+    result->name             = entry->name;
+    result->iterations       = iterations;
+    result->real_ns          = real_ns / iterations;
+    result->cpu_ns           = cpu_ns / iterations;
+    result->items_per_second = items && real_ns > 0 ? items * 1e9 / real_ns : 0;
+}
+
+static void write_json(const char *path, const char *executable, const bench_result_t *results, uint16_t count) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Could not open %s for writing\n", path);
+        return;
+    }
+
+    char      date[32];
+    time_t    now = time(NULL);
+    struct tm tm;
+    localtime_r(&now, &tm);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", &tm);
+
+    fprintf(file, "{\n  \"context\": {\n");
+    fprintf(file, "    \"date\": \"%s\",\n", date);
+    fprintf(file, "    \"executable\": \"%s\",\n", executable);
+    fprintf(file, "    \"num_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(file, "    \"library_build_type\": \"release\"\n");
+    fprintf(file, "  },\n  \"benchmarks\": [\n");
+    for (uint16_t i = 0; i < count; ++i) {
+        const bench_result_t *r = &results[i];
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"name\": \"%s\",\n", r->name);
+        fprintf(file, "      \"run_name\": \"%s\",\n", r->name);
+        fprintf(file, "      \"run_type\": \"iteration\",\n");
+        fprintf(file, "      \"repetitions\": 1,\n");
+        fprintf(file, "      \"repetition_index\": 0,\n");
+        fprintf(file, "      \"threads\": 1,\n");
+        fprintf(file, "      \"iterations\": %llu,\n", (unsigned long long)r->iterations);
+        fprintf(file, "      \"real_time\": %.3f,\n", r->real_ns);
+        fprintf(file, "      \"cpu_time\": %.3f,\n", r->cpu_ns);
+        if (r->items_per_second > 0) {
+            fprintf(file, "      \"items_per_second\": %.3f,\n", r->items_per_second);
+        }
+        fprintf(file, "      \"time_unit\": \"ns\"\n");
+        fprintf(file, "    }%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+}
+
+static void usage(const char *executable) {
+    printf("Usage: %s [--filter=<substring>] [--min-time=<seconds>] [--json=<path>]\n", executable);
+}
+
+int main(int argc, char **argv) {
+    const char *filter    = NULL;
+    const char *json_path = NULL;
+    double      min_time  = 0.05;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        } else if (strncmp(argv[i], "--min-time=", 11) == 0) {
+            min_time = atof(argv[i] + 11);
+        } else if (strncmp(argv[i], "--json=", 7) == 0) {
+            json_path = argv[i] + 7;
+        } else {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    bench_keyboard_init();
+
+    printf("%-48s %14s %14s %12s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations");
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < benchmark_count; ++i) {
+        if (filter && !strstr(benchmarks[i].name, filter)) {
+            continue;
+        }
+        bench_result_t *result = &results[count++];
+        run_benchmark(&benchmarks[i], min_time * 1e9, result);
+        printf("%-48s %14.1f %14.1f %12llu", result->name, result->real_ns, result->cpu_ns, (unsigned long long)result->iterations);
+        if (result->items_per_second > 0) {
+            printf("   items/s=%.4g", result->items_per_second);
+        }
+        printf("\n");
+    }
+
+    if (json_path) {
+        write_json(json_path, argv[0], results, count);
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \file
+ *
+ * \defgroup benchmark Microbenchmarks
+ *
+ * \brief A minimal, Google Benchmark style harness for measuring QMK hot paths on the host.
+ *
+ * Benchmarks are plain functions, repeating the measured code for as long as bench_keep_running() returns true. The
+ * number of iterations is scaled up until a run takes at least the minimum time, and the average time per iteration
+ * is reported -- as a table on stdout, and in Google Benchmark's JSON format.
+ *
+ * Usage example:
+ *
+ *     static void bench_hsv_to_rgb(bench_state_t *state) {
+ *         hsv_t hsv = {0, 255, 255};
+ *         while (bench_keep_running(state)) {
+ *             BENCH_DO_NOT_OPTIMIZE(hsv_to_rgb(hsv));
+ *             hsv.h++;
+ *         }
+ *     }
+ *     BENCHMARK(bench_hsv_to_rgb);
+ *
+ * \{
+ */
+
+typedef struct bench_state_t {
+    uint64_t iterations;      // Number of iterations in the current run
+    uint64_t remaining;       // Number of iterations left in the current run
+    uint64_t items_processed; // Optional number of items processed in the current run, for throughput
+    intptr_t arg;             // Argument given at registration
+    uint64_t start_ns;
+    uint64_t start_cpu_ns;
+    uint64_t paused_ns;
+    uint64_t paused_cpu_ns;
+    uint64_t pause_start_ns;
+    uint64_t pause_start_cpu_ns;
+} bench_state_t;
+
+typedef void (*bench_func_t)(bench_state_t *state);
+
+/** \brief Register a benchmark, usually through BENCHMARK()
+ */
+void bench_register(const char *name, bench_func_t func, intptr_t arg);
+
+/** \brief Whether another iteration should be run, starting the clock on the first call of a run
+ */
+bool bench_keep_running(bench_state_t *state);
+
+/** \brief Stop the clock, for example while resetting state between iterations
+ */
+void bench_pause_timing(bench_state_t *state);
+
+/** \brief Restart the clock after bench_pause_timing()
+ */
+void bench_resume_timing(bench_state_t *state);
+
+/** \brief Set up the keyboard before each benchmark, overridable by suites
+ */
+void bench_setup(void);
+
+#define BENCHMARK_WITH_ARG(func, name, arg)                                \
+    static void __attribute__((constructor)) bench_register_##func##_##arg(void) { \
+        bench_register(name, func, arg);                                   \
+    }
+
+#define BENCHMARK(func) BENCHMARK_WITH_ARG(func, #func, 0)
+
+/** \brief Prevent the compiler from optimising away a value
+ */
+#define BENCH_DO_NOT_OPTIMIZE(value)                             \
+    do {                                                         \
+        __typeof__(value) bench_value_ = (value);                \
+        __asm__ volatile("" : : "g"(&bench_value_) : "memory"); \
+    } while (0)
+
+/** \brief Force all pending memory writes to be considered observable
+ */
+#define BENCH_CLOBBER_MEMORY() __asm__ volatile("" : : : "memory")
+
+/** \} */
@@ -0,0 +1,55 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "benchmark.h"
+#include "color.h"
+
+static void bench_hsv_to_rgb(bench_state_t *state) {
+    hsv_t hsv = {0, 255, 255};
+    while (bench_keep_running(state)) {
+        BENCH_DO_NOT_OPTIMIZE(hsv_to_rgb(hsv));
+        hsv.h++;
+        hsv.v -= 3;
+    }
+    state->items_processed = state->iterations;
+}
+BENCHMARK(bench_hsv_to_rgb);
+
+static void bench_hsv_to_rgb_nocie(bench_state_t *state) {
+    hsv_t hsv = {0, 255, 255};
+    while (bench_keep_running(state)) {
+        BENCH_DO_NOT_OPTIMIZE(hsv_to_rgb_nocie(hsv));
+        hsv.h++;
+        hsv.v -= 3;
+    }
+    state->items_processed = state->iterations;
+}
+BENCHMARK(bench_hsv_to_rgb_nocie);
+
+// A full rainbow at fixed saturation and brightness, as drawn by most effects
+static void bench_hsv_to_rgb_sweep(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        for (uint16_t h = 0; h < 256; h++) {
+            BENCH_DO_NOT_OPTIMIZE(hsv_to_rgb((hsv_t){h, 255, 128}));
+        }
+    }
+    state->items_processed = state->iterations * 256;
+}
+BENCHMARK(bench_hsv_to_rgb_sweep);
+
+// The same rainbow, converted a batch at a time as the effect runners do
+static void bench_hsv_to_rgb_batch(bench_state_t *state) {
+    hsv_t hsv[128];
+    rgb_t rgb[128];
+    while (bench_keep_running(state)) {
+        for (uint16_t h = 0; h < 256; h += 128) {
+            for (uint8_t i = 0; i < 128; i++) {
+                hsv[i] = (hsv_t){h + i, 255, 128};
+            }
+            hsv_to_rgb_batch(hsv, rgb, 128);
+            BENCH_CLOBBER_MEMORY();
+        }
+    }
+    state->items_processed = state->iterations * 256;
+}
+BENCHMARK(bench_hsv_to_rgb_batch);
@@ -0,0 +1,52 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "benchmark.h"
+#include "bench_keyboard.h"
+#include "action.h"
+#include "keyboard.h"
+#include "process_combo.h"
+#include "timer.h"
+
+// A key which is not part of any combo, checked against all of them
+static void bench_combo_miss(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        action_exec(MAKE_KEYEVENT(3, 0, true));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(3, 0, false));
+        advance_time(1);
+    }
+    state->items_processed = state->iterations * 2;
+}
+BENCHMARK(bench_combo_miss);
+
+// Two keys pressed together, triggering a combo
+static void bench_combo_trigger(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        action_exec(MAKE_KEYEVENT(1, 6, true));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(1, 7, true));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(1, 6, false));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(1, 7, false));
+        advance_time(1);
+    }
+    state->items_processed = state->iterations * 4;
+}
+BENCHMARK(bench_combo_trigger);
+
+// A combo key on its own, buffered until the combo term expires
+static void bench_combo_timeout(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        bench_press_key(0, 1);
+        keyboard_task();
+        advance_time(COMBO_TERM + 1);
+        keyboard_task();
+        bench_release_key(0, 1);
+        keyboard_task();
+        advance_time(1);
+    }
+    state->items_processed = state->iterations * 2;
+}
+BENCHMARK(bench_combo_timeout);
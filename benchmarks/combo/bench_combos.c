@@ -0,0 +1,42 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+// clang-format off
+const uint16_t PROGMEM combo_we[]   = {KC_W, KC_E, COMBO_END};
+const uint16_t PROGMEM combo_er[]   = {KC_E, KC_R, COMBO_END};
+const uint16_t PROGMEM combo_ui[]   = {KC_U, KC_I, COMBO_END};
+const uint16_t PROGMEM combo_io[]   = {KC_I, KC_O, COMBO_END};
+const uint16_t PROGMEM combo_sd[]   = {KC_S, KC_D, COMBO_END};
+const uint16_t PROGMEM combo_df[]   = {KC_D, KC_F, COMBO_END};
+const uint16_t PROGMEM combo_jk[]   = {KC_J, KC_K, COMBO_END};
+const uint16_t PROGMEM combo_kl[]   = {KC_K, KC_L, COMBO_END};
+const uint16_t PROGMEM combo_xc[]   = {KC_X, KC_C, COMBO_END};
+const uint16_t PROGMEM combo_cv[]   = {KC_C, KC_V, COMBO_END};
+const uint16_t PROGMEM combo_mc[]   = {KC_M, KC_COMM, COMBO_END};
+const uint16_t PROGMEM combo_cd[]   = {KC_COMM, KC_DOT, COMBO_END};
+const uint16_t PROGMEM combo_sdf[]  = {KC_S, KC_D, KC_F, COMBO_END};
+const uint16_t PROGMEM combo_jkl[]  = {KC_J, KC_K, KC_L, COMBO_END};
+const uint16_t PROGMEM combo_wer[]  = {KC_W, KC_E, KC_R, COMBO_END};
+const uint16_t PROGMEM combo_uio[]  = {KC_U, KC_I, KC_O, COMBO_END};
+
+combo_t key_combos[] = {
+    COMBO(combo_we, KC_ESC),
+    COMBO(combo_er, KC_TAB),
+    COMBO(combo_ui, KC_BSPC),
+    COMBO(combo_io, KC_DEL),
+    COMBO(combo_sd, KC_LPRN),
+    COMBO(combo_df, KC_RPRN),
+    COMBO(combo_jk, KC_LBRC),
+    COMBO(combo_kl, KC_RBRC),
+    COMBO(combo_xc, KC_MINS),
+    COMBO(combo_cv, KC_EQL),
+    COMBO(combo_mc, KC_QUOT),
+    COMBO(combo_cd, KC_GRV),
+    COMBO(combo_sdf, KC_ENT),
+    COMBO(combo_jkl, KC_SPC),
+    COMBO(combo_wer, KC_HOME),
+    COMBO(combo_uio, KC_END),
+};
+// clang-format on
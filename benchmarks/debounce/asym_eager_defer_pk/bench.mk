@@ -0,0 +1,6 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+DEBOUNCE_TYPE = asym_eager_defer_pk
+
+SRC += benchmarks/debounce/bench_debounce.c
@@ -0,0 +1,66 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "benchmark.h"
+#include "bench_keyboard.h"
+#include <string.h>
+#include "debounce.h"
+#include "timer.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+static matrix_row_t raw[MATRIX_ROWS];
+static matrix_row_t cooked[MATRIX_ROWS];
+
+void bench_setup(void) {
+    memset(raw, 0, sizeof(raw));
+    memset(cooked, 0, sizeof(cooked));
+    debounce_free();
+    debounce_init(MATRIX_ROWS);
+}
+
+// Scanning a matrix with no keys changing
+static void bench_debounce_idle(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        BENCH_DO_NOT_OPTIMIZE(debounce(raw, cooked, MATRIX_ROWS, false));
+        advance_time(1);
+    }
+}
+BENCHMARK(bench_debounce_idle);
+
+// A clean key press and release, scanning every millisecond until each has settled
+static void bench_debounce_tap(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        raw[1] ^= 1 << 3;
+        bool changed = true;
+        for (uint8_t ms = 0; ms <= DEBOUNCE; ms++) {
+            BENCH_DO_NOT_OPTIMIZE(debounce(raw, cooked, MATRIX_ROWS, changed));
+            changed = false;
+            advance_time(1);
+        }
+    }
+    state->items_processed = state->iterations * (DEBOUNCE + 1);
+}
+BENCHMARK(bench_debounce_tap);
+
+// A key chattering for a few milliseconds before settling, with other keys held
+static void bench_debounce_chatter(bench_state_t *state) {
+    raw[0] = 0x5;
+    raw[3] = 0x200;
+    while (bench_keep_running(state)) {
+        for (uint8_t ms = 0; ms < 4; ms++) {
+            raw[2] ^= 1 << 7;
+            BENCH_DO_NOT_OPTIMIZE(debounce(raw, cooked, MATRIX_ROWS, true));
+            advance_time(1);
+        }
+        raw[2] ^= 1 << 7;
+        for (uint8_t ms = 0; ms <= DEBOUNCE; ms++) {
+            BENCH_DO_NOT_OPTIMIZE(debounce(raw, cooked, MATRIX_ROWS, ms == 0));
+            advance_time(1);
+        }
+    }
+    state->items_processed = state->iterations * (DEBOUNCE + 5);
+}
+BENCHMARK(bench_debounce_chatter);
@@ -0,0 +1,6 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+DEBOUNCE_TYPE = none
+
+SRC += benchmarks/debounce/bench_debounce.c
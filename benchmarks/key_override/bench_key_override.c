@@ -0,0 +1,36 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "benchmark.h"
+#include "bench_keyboard.h"
+#include "action.h"
+#include "keyboard.h"
+#include "timer.h"
+
+// A key with no modifiers held, checked against all overrides
+static void bench_key_override_miss(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        action_exec(MAKE_KEYEVENT(0, 0, true));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(0, 0, false));
+        advance_time(1);
+    }
+    state->items_processed = state->iterations * 2;
+}
+BENCHMARK(bench_key_override_miss);
+
+// Shift + Backspace, activating and deactivating an override
+static void bench_key_override_trigger(bench_state_t *state) {
+    while (bench_keep_running(state)) {
+        action_exec(MAKE_KEYEVENT(3, 0, true));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(3, 3, true));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(3, 3, false));
+        advance_time(1);
+        action_exec(MAKE_KEYEVENT(3, 0, false));
+        advance_time(1);
+    }
+    state->items_processed = state->iterations * 4;
+}
+BENCHMARK(bench_key_override_trigger);
@@ -0,0 +1,26 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+const key_override_t bspc_override = ko_make_basic(MOD_MASK_SHIFT, KC_BSPC, KC_DEL);
+const key_override_t vol_override  = ko_make_basic(MOD_MASK_SHIFT, KC_VOLU, KC_BRIU);
+const key_override_t vold_override = ko_make_basic(MOD_MASK_SHIFT, KC_VOLD, KC_BRID);
+const key_override_t play_override = ko_make_basic(MOD_MASK_CTRL, KC_MPLY, KC_MNXT);
+const key_override_t esc_override  = ko_make_basic(MOD_MASK_SHIFT, KC_ESC, KC_GRV);
+const key_override_t comm_override = ko_make_basic(MOD_MASK_SHIFT, KC_COMM, KC_SCLN);
+const key_override_t dot_override  = ko_make_basic(MOD_MASK_SHIFT, KC_DOT, KC_COLN);
+const key_override_t spc_override  = ko_make_basic(MOD_MASK_CA, KC_SPC, KC_TAB);
+
+// clang-format off
+const key_override_t *key_overrides[] = {
+    &bspc_override,
+    &vol_override,
+    &vold_override,
+    &play_override,
+    &esc_override,
+    &comm_override,
+    &dot_override,
+    &spc_override,
+};
+// clang-format on
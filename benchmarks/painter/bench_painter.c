@@ -0,0 +1,157 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "benchmark.h"
+#include <stdio.h>
+#include "qp.h"
+#include "qp_draw.h"
+#include "qp_internal.h"
+#include "qp_surface.h"
+
+#define IMAGE_WIDTH 128
+#define IMAGE_HEIGHT 64
+#define IMAGE_PIXELS (IMAGE_WIDTH * IMAGE_HEIGHT)
+
+// The benchmark argument packs the bits per pixel together with the compression
+#define CODEC_ARG(bpp, compression) ((bpp) | ((compression) << 8))
+#define CODEC_BPP(arg) ((arg) & 0xFF)
+#define CODEC_COMPRESSION(arg) ((painter_compression_t)((arg) >> 8))
+
+static uint8_t          raw_image[IMAGE_PIXELS];
+static uint8_t          rle_image[IMAGE_PIXELS + IMAGE_PIXELS / 128 + 1];
+static uint32_t         rle_image_length;
+static uint8_t          surface_buffer[SURFACE_REQUIRED_BUFFER_BYTE_SIZE(IMAGE_WIDTH, IMAGE_HEIGHT, 16)];
+static painter_device_t surface;
+
+// Encode in the same format as the QGF converter: a marker byte below 128 repeats the next byte, from 128 upwards
+// starts a run of (marker - 127) literal bytes.
+static uint32_t rle_encode(const uint8_t *input, uint32_t length, uint8_t *output) {
+    uint32_t out = 0;
+    uint32_t pos = 0;
+    while (pos < length) {
+        uint32_t run = 1;
+        while (pos + run < length && run < 127 && input[pos + run] == input[pos]) {
+            run++;
+        }
+        if (run > 2) {
+            output[out++] = run;
+            output[out++] = input[pos];
+            pos += run;
+            continue;
+        }
+        uint32_t literal = 0;
+        while (pos + literal < length && literal < 128 && !(pos + literal + 2 < length && input[pos + literal] == input[pos + literal + 1] && input[pos + literal] == input[pos + literal + 2])) {
+            literal++;
+        }
+        output[out++] = 127 + literal;
+        for (uint32_t i = 0; i < literal; i++) {
+            output[out++] = input[pos++];
+        }
+    }
+    return out;
+}
+
+// Something resembling an icon: flat background, with a detailed region in the middle
+static void __attribute__((constructor)) generate_images(void) {
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < IMAGE_PIXELS; i++) {
+        uint16_t x = i % IMAGE_WIDTH;
+        uint16_t y = i / IMAGE_WIDTH;
+        seed       = seed * 1103515245 + 12345;
+        if (x >= 32 && x < 96 && y >= 16 && y < 48) {
+            raw_image[i] = seed >> 24;
+        } else {
+            raw_image[i] = (y / 8) % 2 ? 0x00 : 0xFF;
+        }
+    }
+    rle_image_length = rle_encode(raw_image, sizeof(raw_image), rle_image);
+}
+
+void bench_setup(void) {
+    if (!surface) {
+        surface = qp_make_rgb565_surface(IMAGE_WIDTH, IMAGE_HEIGHT, surface_buffer);
+        qp_init(surface, QP_ROTATION_0);
+    }
+}
+
+static bool count_pixel(qp_pixel_t *palette, uint8_t index, void *cb_arg) {
+    *(uint32_t *)cb_arg += index;
+    return true;
+}
+
+static qp_memory_stream_t image_stream(painter_compression_t compression) {
+    return compression == IMAGE_COMPRESSED_RLE ? qp_make_memory_stream(rle_image, rle_image_length) : qp_make_memory_stream(raw_image, sizeof(raw_image));
+}
+
+// Decoding a palette image of the same byte size, with pixels consumed by a trivial callback
+static void bench_painter_decode_palette(bench_state_t *state) {
+    uint8_t               bpp         = CODEC_BPP(state->arg);
+    painter_compression_t compression = CODEC_COMPRESSION(state->arg);
+    uint32_t              pixels      = sizeof(raw_image) * 8 / bpp;
+    uint32_t              sum         = 0;
+    while (bench_keep_running(state)) {
+        qp_memory_stream_t             stream      = image_stream(compression);
+        qp_internal_byte_input_state_t input_state = {.device = surface, .src_stream = (qp_stream_t *)&stream};
+        qp_internal_byte_input_callback input      = qp_internal_prepare_input_state(&input_state, compression);
+        qp_internal_decode_palette(surface, pixels, bpp, input, &input_state, qp_internal_global_pixel_lookup_table, count_pixel, &sum);
+    }
+    BENCH_DO_NOT_OPTIMIZE(sum);
+    state->items_processed = state->iterations * pixels;
+}
+
+// Decoding a grayscale image with a fresh recolor palette each time, as when drawing text in changing colours
+static void bench_painter_decode_recolor(bench_state_t *state) {
+    uint8_t               bpp         = CODEC_BPP(state->arg);
+    painter_compression_t compression = CODEC_COMPRESSION(state->arg);
+    uint32_t              pixels      = sizeof(raw_image) * 8 / bpp;
+    uint32_t              sum         = 0;
+    qp_pixel_t            fg          = {.hsv888 = {.h = 0, .s = 255, .v = 255}};
+    qp_pixel_t            bg          = {.hsv888 = {.h = 0, .s = 0, .v = 0}};
+    while (bench_keep_running(state)) {
+        qp_memory_stream_t             stream      = image_stream(compression);
+        qp_internal_byte_input_state_t input_state = {.device = surface, .src_stream = (qp_stream_t *)&stream};
+        qp_internal_byte_input_callback input      = qp_internal_prepare_input_state(&input_state, compression);
+        qp_internal_decode_recolor(surface, pixels, bpp, input, &input_state, fg, bg, count_pixel, &sum);
+        fg.hsv888.h++;
+    }
+    BENCH_DO_NOT_OPTIMIZE(sum);
+    state->items_processed = state->iterations * pixels;
+}
+
+// Decoding and streaming pixels into an RGB565 surface, as done when drawing an image
+static void bench_painter_appender(bench_state_t *state) {
+    uint8_t               bpp         = CODEC_BPP(state->arg);
+    painter_compression_t compression = CODEC_COMPRESSION(state->arg);
+    painter_driver_t     *driver      = (painter_driver_t *)surface;
+    qp_pixel_t            fg          = {.hsv888 = {.h = 85, .s = 255, .v = 255}};
+    qp_pixel_t            bg          = {.hsv888 = {.h = 0, .s = 0, .v = 0}};
+    qp_internal_invalidate_palette();
+    qp_internal_interpolate_palette(fg, bg, 1 << bpp);
+    driver->driver_vtable->palette_convert(surface, 1 << bpp, qp_internal_global_pixel_lookup_table);
+    while (bench_keep_running(state)) {
+        qp_memory_stream_t             stream      = image_stream(compression);
+        qp_internal_byte_input_state_t input_state = {.device = surface, .src_stream = (qp_stream_t *)&stream};
+        qp_internal_byte_input_callback input      = qp_internal_prepare_input_state(&input_state, compression);
+        qp_viewport(surface, 0, 0, IMAGE_WIDTH - 1, IMAGE_HEIGHT - 1);
+        qp_internal_appender(surface, bpp, IMAGE_PIXELS, input, &input_state);
+    }
+    BENCH_CLOBBER_MEMORY();
+    state->items_processed = state->iterations * IMAGE_PIXELS;
+}
+
+static void __attribute__((constructor)) register_painter_benchmarks(void) {
+    static const uint8_t bpps[] = {1, 2, 4, 8};
+    static char          names[3][2][4][48];
+    for (uint8_t c = 0; c < 2; c++) {
+        const char *compression = c == IMAGE_COMPRESSED_RLE ? "rle" : "raw";
+        for (uint8_t b = 0; b < 4; b++) {
+            intptr_t arg = CODEC_ARG(bpps[b], c);
+            snprintf(names[0][c][b], sizeof(names[0][c][b]), "painter_decode_palette/%s/%ubpp", compression, bpps[b]);
+            bench_register(names[0][c][b], bench_painter_decode_palette, arg);
+            snprintf(names[1][c][b], sizeof(names[1][c][b]), "painter_decode_recolor/%s/%ubpp", compression, bpps[b]);
+            bench_register(names[1][c][b], bench_painter_decode_recolor, arg);
+            snprintf(names[2][c][b], sizeof(names[2][c][b]), "painter_appender/%s/%ubpp", compression, bpps[b]);
+            bench_register(names[2][c][b], bench_painter_appender, arg);
+        }
+    }
+}
@@ -0,0 +1,8 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "bench_common.h"
+
+#define QUANTUM_PAINTER_SUPPORTS_256_PALETTE TRUE
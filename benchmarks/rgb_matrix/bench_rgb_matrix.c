@@ -0,0 +1,84 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "benchmark.h"
+#include "bench_keyboard.h"
+#include "rgb_matrix.h"
+#include "timer.h"
+
+// clang-format off
+led_config_t g_led_config = {
+    {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+        {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+        {30, 31, 32, 33, 34, 35, 36, 37, 38, 39}
+    }, {
+        {  0,  0}, { 25,  0}, { 50,  0}, { 75,  0}, {100,  0}, {124,  0}, {149,  0}, {174,  0}, {199,  0}, {224,  0},
+        {  0, 21}, { 25, 21}, { 50, 21}, { 75, 21}, {100, 21}, {124, 21}, {149, 21}, {174, 21}, {199, 21}, {224, 21},
+        {  0, 43}, { 25, 43}, { 50, 43}, { 75, 43}, {100, 43}, {124, 43}, {149, 43}, {174, 43}, {199, 43}, {224, 43},
+        {  0, 64}, { 25, 64}, { 50, 64}, { 75, 64}, {100, 64}, {124, 64}, {149, 64}, {174, 64}, {199, 64}, {224, 64}
+    }, {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+    }
+};
+// clang-format on
+
+static uint32_t frames_flushed;
+
+static void bench_driver_init(void) {}
+
+static void bench_driver_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+    BENCH_CLOBBER_MEMORY();
+}
+
+static void bench_driver_set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    BENCH_CLOBBER_MEMORY();
+}
+
+static void bench_driver_flush(void) {
+    frames_flushed++;
+}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = bench_driver_init,
+    .set_color     = bench_driver_set_color,
+    .set_color_all = bench_driver_set_color_all,
+    .flush         = bench_driver_flush,
+};
+
+// Render and flush one complete frame, which takes several task passes
+static void render_frame(void) {
+    uint32_t frame = frames_flushed;
+    advance_time(RGB_MATRIX_LED_FLUSH_LIMIT);
+    while (frames_flushed == frame) {
+        rgb_matrix_task();
+    }
+}
+
+// One frame of an effect, with a key pressed every few frames to drive the reactive effects
+static void bench_rgb_matrix_effect(bench_state_t *state) {
+    rgb_matrix_mode_noeeprom(state->arg);
+    // Let the effect initialise, which may take more than one frame
+    render_frame();
+    render_frame();
+
+    uint8_t  led   = 0;
+    uint32_t frame = 0;
+    while (bench_keep_running(state)) {
+        if (frame++ % 4 == 0) {
+            rgb_matrix_handle_key_event(led / MATRIX_COLS, led % MATRIX_COLS, true);
+            rgb_matrix_handle_key_event(led / MATRIX_COLS, led % MATRIX_COLS, false);
+            led = (led + 7) % RGB_MATRIX_LED_COUNT;
+        }
+        render_frame();
+    }
+    state->items_processed = state->iterations * RGB_MATRIX_LED_COUNT;
+}
+
+#define RGB_MATRIX_EFFECT(name, ...) BENCHMARK_WITH_ARG(bench_rgb_matrix_effect, "rgb_matrix_effect/" #name, RGB_MATRIX_##name)
+#include "rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
@@ -0,0 +1 @@
+BENCH_LIST = $(sort $(patsubst %/bench.mk,%, $(shell find $(ROOT_DIR)benchmarks -type f -name bench.mk)))
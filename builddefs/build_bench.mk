@@ -0,0 +1,67 @@
+ifndef VERBOSE
+.SILENT:
+endif
+
+.DEFAULT_GOAL := all
+
+# Benchmarks measure optimised code, unlike tests
+OPT = 2
+
+include paths.mk
+include $(BUILDDEFS_PATH)/message.mk
+
+TARGET=bench/$(BENCH_OUTPUT)
+
+BENCH_OBJ = $(BUILD_DIR)/bench_obj
+
+OUTPUTS := $(BENCH_OBJ)/$(BENCH_OUTPUT)
+
+LDFLAGS += -lm
+CREATE_MAP := no
+
+# The suite comes first, so that it can provide its own keymap.c
+VPATH += \
+	$(BENCH_PATH) \
+	$(COMMON_VPATH) \
+	$(TOP_DIR)/benchmarks/bench_common
+
+all: elf
+
+PLATFORM:=TEST
+PLATFORM_KEY:=test
+BOOTLOADER_TYPE:=none
+
+include benchmarks/bench_common/build.mk
+include $(BENCH_PATH)/bench.mk
+
+include $(BUILDDEFS_PATH)/common_features.mk
+include $(BUILDDEFS_PATH)/generic_features.mk
+include $(PLATFORM_PATH)/common.mk
+include $(TMK_PATH)/protocol.mk
+include $(QUANTUM_PATH)/logging/print.mk
+
+$(BENCH_OUTPUT)_SRC := \
+	$(QUANTUM_SRC) \
+	$(SRC) \
+	$(QUANTUM_PATH)/keymap_introspection.c \
+	benchmarks/bench_common/benchmark.c \
+	benchmarks/bench_common/bench_keyboard.c \
+	$(patsubst $(ROOTDIR)/%,%,$(filter-out %/keymap.c %/$(INTROSPECTION_KEYMAP_C),$(wildcard $(BENCH_PATH)/*.c)))
+
+$(BENCH_OUTPUT)_DEFS := $(OPT_DEFS) "-DKEYMAP_C=\"keymap.c\""
+
+ifneq ($(strip $(INTROSPECTION_KEYMAP_C)),)
+$(BENCH_OUTPUT)_DEFS += -DINTROSPECTION_KEYMAP_C=\"$(strip $(INTROSPECTION_KEYMAP_C))\"
+endif
+
+$(BENCH_OBJ)/$(BENCH_OUTPUT)_SRC := $($(BENCH_OUTPUT)_SRC)
+$(BENCH_OBJ)/$(BENCH_OUTPUT)_INC := $($(BENCH_OUTPUT)_INC) $(VPATH)
+$(BENCH_OBJ)/$(BENCH_OUTPUT)_DEFS := $($(BENCH_OUTPUT)_DEFS)
+$(BENCH_OBJ)/$(BENCH_OUTPUT)_CONFIG := $(BENCH_PATH)/config.h $(POST_CONFIG_H)
+
+include $(PLATFORM_PATH)/$(PLATFORM_KEY)/platform.mk
+include $(BUILDDEFS_PATH)/common_rules.mk
+
+
+$(shell mkdir -p $(BUILD_DIR)/bench 2>/dev/null)
+$(shell mkdir -p $(BENCH_OBJ) 2>/dev/null)
@@ -30,10 +30,23 @@ $(TEST_OUTPUT)_SRC := \
 	tests/test_common/test_fixture.cpp \
 	tests/test_common/test_keymap_key.cpp \
 	tests/test_common/test_logger.cpp \
+	tests/test_common/test_polling_host.cpp \
+	tests/test_common/test_trace_replay.cpp \
 	$(patsubst $(ROOTDIR)/%,%,$(wildcard $(TEST_PATH)/*.cpp))
 
 $(TEST_OUTPUT)_DEFS := $(OPT_DEFS) "-DKEYMAP_C=\"keymap.c\""
 
+# Idle keyboard task passes are only fast-forwarded when every enabled feature is known to either report its deadlines
+# through keyboard_next_deadline(), or not poll timers at all. Any other feature makes every pass run.
+TEST_FAST_FORWARD_FEATURES := \
+	COMBO CONSOLE DEFERRED_EXEC EEPROM EXTRAKEY GRAVE_ESC LEADER LED_MATRIX MAGIC MOUSE NKRO REPEAT_KEY \
+	RGB_MATRIX SEND_STRING SHARED_EP SPACE_CADET TAP_DANCE TICKLESS_IDLE TRI_LAYER UCIS UNICODE UNICODE_COMMON \
+	UNICODEMAP
+
+ifeq ($(filter-out $(patsubst %,-D%_ENABLE,$(TEST_FAST_FORWARD_FEATURES)),$(filter -D%_ENABLE,$(OPT_DEFS))),)
+    $(TEST_OUTPUT)_DEFS += -DTEST_FAST_FORWARD_FEATURES_KNOWN
+endif
+
 $(TEST_OUTPUT)_CONFIG := $(TEST_PATH)/config.h
 
 VPATH += $(TOP_DIR)/tests/test_common
@@ -26,6 +26,7 @@ QUANTUM_SRC += \
     $(QUANTUM_DIR)/keymap_common.c \
     $(QUANTUM_DIR)/keycode_config.c \
     $(QUANTUM_DIR)/sync_timer.c \
+    $(QUANTUM_DIR)/task_scheduler.c \
     $(QUANTUM_DIR)/logging/debug.c \
     $(QUANTUM_DIR)/logging/sendchar.c \
     $(QUANTUM_DIR)/process_keycode/process_default_layer.c \
@@ -592,6 +593,12 @@ ifeq ($(strip $(SLEEP_LED_ENABLE)), yes)
     NO_SUSPEND_POWER_DOWN := yes
 endif
 
+ifeq ($(strip $(TICKLESS_IDLE_ENABLE)), yes)
+    SRC += $(QUANTUM_DIR)/tickless_idle.c
+    SRC += $(PLATFORM_PATH)/$(PLATFORM_KEY)/tickless_idle.c
+    OPT_DEFS += -DTICKLESS_IDLE_ENABLE
+endif
+
 VALID_BACKLIGHT_TYPES := pwm timer software custom
 
 BACKLIGHT_ENABLE ?= no
@@ -635,6 +642,10 @@ ifeq ($(strip $(VIA_ENABLE)), yes)
     TRI_LAYER_ENABLE := yes
 endif
 
+ifeq ($(strip $(RAW_HID_STREAM_ENABLE)), yes)
+    RAW_ENABLE := yes
+endif
+
 VALID_CUSTOM_MATRIX_TYPES:= yes lite no
 
 CUSTOM_MATRIX ?= no
@@ -19,6 +19,7 @@ SEND_STRING_ENABLE ?= yes
 SPACE_CADET_ENABLE ?= yes
 
 GENERIC_FEATURES = \
+    ADAPTIVE_TAPPING_TERM \
     AUTO_SHIFT \
     AUTOCORRECT \
     BOOTMAGIC \
@@ -32,18 +33,24 @@ GENERIC_FEATURES = \
     DYNAMIC_KEYMAP \
     DYNAMIC_MACRO \
     DYNAMIC_TAPPING_TERM \
+    EVENT_TRACE \
     GRAVE_ESC \
     HAPTIC \
     KEY_LOCK \
     KEY_OVERRIDE \
+    KV_STORE \
     LAYER_LOCK \
     LEADER \
     MAGIC \
     MOUSEKEY \
     MUSIC \
     OS_DETECTION \
+    OUTPUT_QUEUE \
+    PROFILING \
     PROGRAMMABLE_BUTTON \
+    RAW_HID_STREAM \
     REPEAT_KEY \
+    REPORT_LATENCY \
     SECURE \
     SEND_STRING \
     SEQUENCER \
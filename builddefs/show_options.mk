@@ -38,6 +38,7 @@ OTHER_OPTION_NAMES = \
   UNICODE_COMMON \
   AUTO_SHIFT_ENABLE \
   DYNAMIC_TAPPING_TERM_ENABLE \
+  ADAPTIVE_TAPPING_TERM_ENABLE \
   COMBO_ENABLE \
   KEY_LOCK_ENABLE \
   KEY_OVERRIDE_ENABLE \
@@ -82,7 +83,9 @@ OTHER_OPTION_NAMES = \
   CAPS_WORD_ENABLE \
   AUTOCORRECT_ENABLE \
   TRI_LAYER_ENABLE \
-  REPEAT_KEY_ENABLE
+  REPEAT_KEY_ENABLE \
+  OUTPUT_QUEUE_ENABLE \
+  RAW_HID_STREAM_ENABLE
 
 define NAME_ECHO
        @printf "  %-30s = %-16s # %s\\n" "$1" "$($1)" "$(origin $1)"
@@ -83,3 +83,10 @@ void eeprom_driver_format(bool erase) {
     (void)erase; /* The default implementation assumes that the eeprom must be erased in order to be usable. */
     eeprom_driver_erase();
 }
+
+/* Drivers which buffer writes should write out anything pending, either after a period of inactivity or when flushed. */
+void eeprom_driver_task(void) __attribute__((weak));
+void eeprom_driver_task(void) {}
+
+void eeprom_driver_flush(void) __attribute__((weak));
+void eeprom_driver_flush(void) {}
@@ -33,7 +33,8 @@
     there is nothing to override during linkage.
 */
 
-#include "wait.h"
+#include "timer.h"
+#include "util.h"
 #include "i2c_master.h"
 #include "eeprom.h"
 #include "eeprom_driver.h"
@@ -42,10 +43,36 @@
 // #define DEBUG_EEPROM_OUTPUT
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-#    include "timer.h"
 #    include "debug.h"
 #endif // DEBUG_EEPROM_OUTPUT
 
+/*
+    Writes are gathered into a page-sized buffer for as long as they continue
+    on from (or overwrite) the bytes already buffered within the same page,
+    and the page is only transmitted once full, once a non-contiguous write
+    arrives, or after EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT milliseconds without
+    further writes (see eeprom_driver_task()).
+
+    After transmitting a page, the device's internal write cycle is left to
+    complete in the background. The device does not acknowledge its address
+    until the write cycle has finished, so the next transaction polls for an
+    ACK rather than waiting for EXTERNAL_EEPROM_WRITE_TIME unconditionally.
+
+    A page which fails to write stays buffered and is retried. Before the
+    buffer is reused for another page, or by eeprom_driver_flush(), the page
+    is retried for up to EXTERNAL_EEPROM_WRITE_TIME, polling for an ACK
+    between attempts. Only when the buffer is needed for another page and the
+    device still doesn't accept it is the page dropped.
+*/
+
+static uint8_t   write_buffer[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
+static uintptr_t write_buffer_addr;
+static size_t    write_buffer_len = 0;
+static uint32_t  write_buffer_time;
+static bool      write_in_progress = false;
+static uint8_t   write_device_address;
+static uint32_t  write_start_time;
+
 static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     uintptr_t p = (uintptr_t)addr;
     for (int i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; ++i) {
@@ -54,6 +81,89 @@ static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     }
 }
 
+static void eeprom_i2c_wait_for_write(void) {
+    if (!write_in_progress) {
+        return;
+    }
+    while (i2c_ping_address(write_device_address, 100) != I2C_STATUS_SUCCESS) {
+        if (timer_elapsed32(write_start_time) > EXTERNAL_EEPROM_WRITE_TIME) {
+            break;
+        }
+    }
+    write_in_progress = false;
+}
+
+/**
+ * Transmits the buffered page. On failure the bytes are kept, and transmission is retried once
+ * EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT has elapsed again, or by eeprom_i2c_write_buffer().
+ *
+ * @return true if the buffer is now empty
+ */
+static bool eeprom_i2c_flush_buffer(void) {
+    if (write_buffer_len == 0) {
+        return true;
+    }
+
+    eeprom_i2c_wait_for_write();
+
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    dprintf("[EEPROM W] 0x%04X: ", ((int)write_buffer_addr));
+    for (size_t i = 0; i < write_buffer_len; i++) {
+        dprintf(" %02X", (int)(write_buffer[EXTERNAL_EEPROM_ADDRESS_SIZE + i]));
+    }
+    dprintf("\n");
+#endif // DEBUG_EEPROM_OUTPUT
+
+#if defined(EXTERNAL_EEPROM_WP_PIN)
+    gpio_set_pin_output(EXTERNAL_EEPROM_WP_PIN);
+    gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 0);
+#endif
+
+    fill_target_address(write_buffer, (const void *)write_buffer_addr);
+    i2c_status_t status = i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(write_buffer_addr), write_buffer, EXTERNAL_EEPROM_ADDRESS_SIZE + write_buffer_len, 100);
+
+#if defined(EXTERNAL_EEPROM_WP_PIN)
+    /* We are setting the WP pin to high in a way that requires at least two bit-flips to change back to 0 */
+    gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 1);
+    gpio_set_pin_input_high(EXTERNAL_EEPROM_WP_PIN);
+#endif
+
+    if (status != I2C_STATUS_SUCCESS) {
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+        dprintf("[EEPROM W] 0x%04X: failed (%d)\n", ((int)write_buffer_addr), (int)status);
+#endif // DEBUG_EEPROM_OUTPUT
+        write_buffer_time = timer_read32();
+        return false;
+    }
+
+    write_buffer_len     = 0;
+    write_in_progress    = EXTERNAL_EEPROM_WRITE_TIME > 0;
+    write_device_address = EXTERNAL_EEPROM_I2C_ADDRESS(write_buffer_addr);
+    write_start_time     = timer_read32();
+    return true;
+}
+
+/**
+ * Transmits the buffered page, retrying until it is written. A device busy with a write cycle does
+ * not acknowledge its address, so between attempts it is polled for an ACK, for up to
+ * EXTERNAL_EEPROM_WRITE_TIME in total.
+ *
+ * @return true if the buffer is now empty
+ */
+static bool eeprom_i2c_write_buffer(void) {
+    uint32_t start = timer_read32();
+
+    while (!eeprom_i2c_flush_buffer()) {
+        if (timer_elapsed32(start) > EXTERNAL_EEPROM_WRITE_TIME) {
+            return false;
+        }
+
+        while (i2c_ping_address(EXTERNAL_EEPROM_I2C_ADDRESS(write_buffer_addr), 100) != I2C_STATUS_SUCCESS && timer_elapsed32(start) <= EXTERNAL_EEPROM_WRITE_TIME) {
+        }
+    }
+    return true;
+}
+
 void eeprom_driver_init(void) {
     i2c_init();
 #if defined(EXTERNAL_EEPROM_WP_PIN)
@@ -80,6 +190,7 @@ void eeprom_driver_erase(void) {
     for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
         eeprom_write_block(buf, (void *)(uintptr_t)addr, EXTERNAL_EEPROM_PAGE_SIZE);
     }
+    eeprom_driver_flush();
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
@@ -90,9 +201,17 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
     uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
     fill_target_address(complete_packet, addr);
 
+    eeprom_i2c_wait_for_write();
     i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
     i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), buf, len, 100);
 
+    // Overlay any bytes which are still waiting in the write buffer
+    uintptr_t start = MAX((uintptr_t)addr, write_buffer_addr);
+    uintptr_t end   = MIN((uintptr_t)addr + len, write_buffer_addr + write_buffer_len);
+    if (write_buffer_len > 0 && start < end) {
+        memcpy((uint8_t *)buf + (start - (uintptr_t)addr), &write_buffer[EXTERNAL_EEPROM_ADDRESS_SIZE + (start - write_buffer_addr)], end - start);
+    }
+
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("[EEPROM R] 0x%04X: ", ((int)addr));
     for (size_t i = 0; i < len; ++i) {
@@ -103,46 +222,55 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
 }
 
 void eeprom_write_block(const void *buf, void *addr, size_t len) {
-    uint8_t   complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
-    uint8_t * read_buf    = (uint8_t *)buf;
-    uintptr_t target_addr = (uintptr_t)addr;
-
-#if defined(EXTERNAL_EEPROM_WP_PIN)
-    gpio_set_pin_output(EXTERNAL_EEPROM_WP_PIN);
-    gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 0);
-#endif
+    const uint8_t *read_buf    = (const uint8_t *)buf;
+    uintptr_t      target_addr = (uintptr_t)addr;
 
     while (len > 0) {
-        uintptr_t page_offset  = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
-        int       write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
+        size_t write_length = EXTERNAL_EEPROM_PAGE_SIZE - (target_addr % EXTERNAL_EEPROM_PAGE_SIZE);
         if (write_length > len) {
             write_length = len;
         }
 
-        fill_target_address(complete_packet, (const void *)target_addr);
-        for (uint8_t i = 0; i < write_length; i++) {
-            complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + i] = read_buf[i];
-        }
-
+        // Merge into the buffer if this lands within, or directly after, the buffered bytes of the same page
+        bool mergeable = write_buffer_len > 0 && target_addr >= write_buffer_addr && target_addr <= write_buffer_addr + write_buffer_len && (target_addr / EXTERNAL_EEPROM_PAGE_SIZE) == (write_buffer_addr / EXTERNAL_EEPROM_PAGE_SIZE);
+        if (!mergeable) {
+            // Only one page can be buffered, so the previous one has to be written first
+            if (!eeprom_i2c_write_buffer()) {
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-        dprintf("[EEPROM W] 0x%04X: ", ((int)target_addr));
-        for (uint8_t i = 0; i < write_length; i++) {
-            dprintf(" %02X", (int)(read_buf[i]));
-        }
-        dprintf("\n");
+                dprintf("[EEPROM W] 0x%04X: dropped %d bytes\n", ((int)write_buffer_addr), (int)write_buffer_len);
 #endif // DEBUG_EEPROM_OUTPUT
+                write_buffer_len = 0;
+            }
+            write_buffer_addr = target_addr;
+        }
+
+        size_t offset = target_addr - write_buffer_addr;
+        memcpy(&write_buffer[EXTERNAL_EEPROM_ADDRESS_SIZE + offset], read_buf, write_length);
+        write_buffer_len = MAX(write_buffer_len, offset + write_length);
 
-        i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
-        wait_ms(EXTERNAL_EEPROM_WRITE_TIME);
+        // Buffered bytes reaching the end of the page cannot be extended any further
+        if ((write_buffer_addr + write_buffer_len) % EXTERNAL_EEPROM_PAGE_SIZE == 0) {
+            eeprom_i2c_flush_buffer();
+        }
 
         read_buf += write_length;
         target_addr += write_length;
         len -= write_length;
     }
 
-#if defined(EXTERNAL_EEPROM_WP_PIN)
-    /* We are setting the WP pin to high in a way that requires at least two bit-flips to change back to 0 */
-    gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 1);
-    gpio_set_pin_input_high(EXTERNAL_EEPROM_WP_PIN);
+    write_buffer_time = timer_read32();
+#if EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT == 0
+    eeprom_i2c_flush_buffer();
 #endif
 }
+
+void eeprom_driver_task(void) {
+    if (write_buffer_len > 0 && timer_elapsed32(write_buffer_time) >= EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT) {
+        eeprom_i2c_flush_buffer();
+    }
+}
+
+void eeprom_driver_flush(void) {
+    eeprom_i2c_write_buffer();
+    eeprom_i2c_wait_for_write();
+}
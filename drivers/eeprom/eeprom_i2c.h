@@ -117,9 +117,19 @@
 #endif
 
 /*
-    The write cycle time of the EEPROM in milliseconds, as specified in the
-    datasheet.
+    The maximum write cycle time of the EEPROM in milliseconds, as specified in
+    the datasheet. The device is polled for an ACK after each page write, so
+    this is only used as a timeout.
 */
 #ifndef EXTERNAL_EEPROM_WRITE_TIME
 #    define EXTERNAL_EEPROM_WRITE_TIME 5
 #endif
+
+/*
+    The number of milliseconds without further writes after which partially
+    filled pages are written to the EEPROM. Set to 0 to write at the end of
+    each eeprom_write_block() call instead.
+*/
+#ifndef EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT
+#    define EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT 100
+#endif
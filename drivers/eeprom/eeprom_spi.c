@@ -30,9 +30,9 @@
     there is nothing to override during linkage.
 */
 
-#include "wait.h"
 #include "debug.h"
 #include "timer.h"
+#include "util.h"
 #include "spi_master.h"
 #include "eeprom.h"
 #include "eeprom_driver.h"
@@ -53,11 +53,39 @@
 #    define EXTERNAL_EEPROM_SPI_TIMEOUT 100
 #endif
 
+/*
+    Writes are gathered into a page-sized buffer for as long as they continue
+    on from (or overwrite) the bytes already buffered within the same page,
+    and the page is only transmitted once full, once a non-contiguous write
+    arrives, or after EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT milliseconds without
+    further writes (see eeprom_driver_task()).
+
+    After transmitting a page, the device's internal write cycle is left to
+    complete in the background, and the status register is only polled before
+    the next transaction.
+
+    A page which fails to write stays buffered and is retried. Before the
+    buffer is reused for another page, or by eeprom_driver_flush(), the page
+    is retried for up to EXTERNAL_EEPROM_SPI_TIMEOUT. Only when the buffer is
+    needed for another page and the device still doesn't accept it is the
+    page dropped, which is reported on the console.
+*/
+
+static uint8_t   write_buffer[EXTERNAL_EEPROM_PAGE_SIZE];
+static uintptr_t write_buffer_addr;
+static size_t    write_buffer_len = 0;
+static uint32_t  write_buffer_time;
+static bool      write_in_progress = false;
+
 static bool spi_eeprom_start(void) {
     return spi_start(EXTERNAL_EEPROM_SPI_SLAVE_SELECT_PIN, EXTERNAL_EEPROM_SPI_LSBFIRST, EXTERNAL_EEPROM_SPI_MODE, EXTERNAL_EEPROM_SPI_CLOCK_DIVISOR);
 }
 
 static spi_status_t spi_eeprom_wait_while_busy(int timeout) {
+    if (!write_in_progress) {
+        return SPI_STATUS_SUCCESS;
+    }
+
     uint32_t     deadline = timer_read32() + timeout;
     spi_status_t response = SR_WIP;
     while (response & SR_WIP) {
@@ -73,6 +101,7 @@ static spi_status_t spi_eeprom_wait_while_busy(int timeout) {
             return SPI_STATUS_TIMEOUT;
         }
     }
+    write_in_progress = false;
     return SPI_STATUS_SUCCESS;
 }
 
@@ -87,6 +116,96 @@ static void spi_eeprom_transmit_address(uintptr_t addr) {
     spi_transmit(buffer, EXTERNAL_EEPROM_ADDRESS_SIZE);
 }
 
+/**
+ * Transmits the buffered page. On failure the bytes are kept, and transmission is retried once
+ * EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT has elapsed again, or by spi_eeprom_write_buffer().
+ *
+ * @return true if the buffer is now empty
+ */
+static bool spi_eeprom_flush_buffer(void) {
+    bool res;
+
+    if (write_buffer_len == 0) {
+        return true;
+    }
+
+    // Until the page has been sent, a failure leaves it buffered for another attempt
+    write_buffer_time = timer_read32();
+
+    //-------------------------------------------------
+    // Wait for the write-in-progress bit to be cleared
+    spi_status_t response = spi_eeprom_wait_while_busy(EXTERNAL_EEPROM_SPI_TIMEOUT);
+    if (response != SPI_STATUS_SUCCESS) {
+        spi_stop();
+        dprint("SPI timeout for WIP check\n");
+        return false;
+    }
+
+    //-------------------------------------------------
+    // Enable writes
+    res = spi_eeprom_start();
+    if (!res) {
+        spi_stop();
+        dprint("failed to start SPI for write-enable\n");
+        return false;
+    }
+
+    spi_write(CMD_WREN);
+    spi_stop();
+
+    //-------------------------------------------------
+    // Perform the write
+    res = spi_eeprom_start();
+    if (!res) {
+        spi_stop();
+        dprint("failed to start SPI for write\n");
+        return false;
+    }
+
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    dprintf("[EEPROM W] 0x%08lX: ", ((uint32_t)(uintptr_t)write_buffer_addr));
+    for (size_t i = 0; i < write_buffer_len; i++) {
+        dprintf(" %02X", (int)(uint8_t)(write_buffer[i]));
+    }
+    dprintf("\n");
+#endif // DEBUG_EEPROM_OUTPUT
+
+    spi_write(CMD_WRITE);
+    spi_eeprom_transmit_address(write_buffer_addr);
+    spi_transmit(write_buffer, write_buffer_len);
+    spi_stop();
+    write_buffer_len  = 0;
+    write_in_progress = true;
+
+    //-------------------------------------------------
+    // Disable writes
+    res = spi_eeprom_start();
+    if (!res) {
+        dprint("failed to start SPI for write-disable\n");
+        return true;
+    }
+
+    spi_write(CMD_WRDI);
+    spi_stop();
+    return true;
+}
+
+/**
+ * Transmits the buffered page, retrying for up to EXTERNAL_EEPROM_SPI_TIMEOUT until it is written.
+ *
+ * @return true if the buffer is now empty
+ */
+static bool spi_eeprom_write_buffer(void) {
+    uint32_t start = timer_read32();
+
+    while (!spi_eeprom_flush_buffer()) {
+        if (timer_elapsed32(start) > EXTERNAL_EEPROM_SPI_TIMEOUT) {
+            return false;
+        }
+    }
+    return true;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
 void eeprom_driver_init(void) {
@@ -110,6 +229,7 @@ void eeprom_driver_erase(void) {
     for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
         eeprom_write_block(buf, (void *)(uintptr_t)addr, EXTERNAL_EEPROM_PAGE_SIZE);
     }
+    eeprom_driver_flush();
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
@@ -141,6 +261,13 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
     spi_eeprom_transmit_address((uintptr_t)addr);
     spi_receive(buf, len);
 
+    // Overlay any bytes which are still waiting in the write buffer
+    uintptr_t start = MAX((uintptr_t)addr, write_buffer_addr);
+    uintptr_t end   = MIN((uintptr_t)addr + len, write_buffer_addr + write_buffer_len);
+    if (write_buffer_len > 0 && start < end) {
+        memcpy((uint8_t *)buf + (start - (uintptr_t)addr), &write_buffer[start - write_buffer_addr], end - start);
+    }
+
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("[EEPROM R] 0x%08lX: ", ((uint32_t)(uintptr_t)addr));
     for (size_t i = 0; i < len; ++i) {
@@ -153,73 +280,56 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
 }
 
 void eeprom_write_block(const void *buf, void *addr, size_t len) {
-    bool      res;
-    uint8_t * read_buf    = (uint8_t *)buf;
-    uintptr_t target_addr = (uintptr_t)addr;
+    const uint8_t *read_buf    = (const uint8_t *)buf;
+    uintptr_t      target_addr = (uintptr_t)addr;
 
     while (len > 0) {
-        uintptr_t page_offset  = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
-        int       write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
+        size_t write_length = EXTERNAL_EEPROM_PAGE_SIZE - (target_addr % EXTERNAL_EEPROM_PAGE_SIZE);
         if (write_length > len) {
             write_length = len;
         }
 
-        //-------------------------------------------------
-        // Wait for the write-in-progress bit to be cleared
-        spi_status_t response = spi_eeprom_wait_while_busy(EXTERNAL_EEPROM_SPI_TIMEOUT);
-        if (response != SPI_STATUS_SUCCESS) {
-            spi_stop();
-            dprint("SPI timeout for WIP check\n");
-            return;
+        // Merge into the buffer if this lands within, or directly after, the buffered bytes of the same page
+        bool mergeable = write_buffer_len > 0 && target_addr >= write_buffer_addr && target_addr <= write_buffer_addr + write_buffer_len && (target_addr / EXTERNAL_EEPROM_PAGE_SIZE) == (write_buffer_addr / EXTERNAL_EEPROM_PAGE_SIZE);
+        if (!mergeable) {
+            // Only one page can be buffered, so the previous one has to be written first
+            if (!spi_eeprom_write_buffer()) {
+                dprintf("EEPROM page write failed, dropped %d bytes\n", (int)write_buffer_len);
+                write_buffer_len = 0;
+            }
+            write_buffer_addr = target_addr;
         }
 
-        //-------------------------------------------------
-        // Enable writes
-        res = spi_eeprom_start();
-        if (!res) {
-            spi_stop();
-            dprint("failed to start SPI for write-enable\n");
-            return;
-        }
-
-        spi_write(CMD_WREN);
-        spi_stop();
+        size_t offset = target_addr - write_buffer_addr;
+        memcpy(&write_buffer[offset], read_buf, write_length);
+        write_buffer_len = MAX(write_buffer_len, offset + write_length);
 
-        //-------------------------------------------------
-        // Perform the write
-        res = spi_eeprom_start();
-        if (!res) {
-            spi_stop();
-            dprint("failed to start SPI for write\n");
-            return;
+        // Buffered bytes reaching the end of the page cannot be extended any further
+        if ((write_buffer_addr + write_buffer_len) % EXTERNAL_EEPROM_PAGE_SIZE == 0) {
+            spi_eeprom_flush_buffer();
         }
 
-#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-        dprintf("[EEPROM W] 0x%08lX: ", ((uint32_t)(uintptr_t)target_addr));
-        for (size_t i = 0; i < write_length; i++) {
-            dprintf(" %02X", (int)(uint8_t)(read_buf[i]));
-        }
-        dprintf("\n");
-#endif // DEBUG_EEPROM_OUTPUT
-
-        spi_write(CMD_WRITE);
-        spi_eeprom_transmit_address(target_addr);
-        spi_transmit(read_buf, write_length);
-        spi_stop();
-
         read_buf += write_length;
         target_addr += write_length;
         len -= write_length;
     }
 
-    //-------------------------------------------------
-    // Disable writes
-    res = spi_eeprom_start();
-    if (!res) {
-        dprint("failed to start SPI for write-disable\n");
-        return;
+    write_buffer_time = timer_read32();
+#if EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT == 0
+    spi_eeprom_flush_buffer();
+#endif
+}
+
+void eeprom_driver_task(void) {
+    if (write_buffer_len > 0 && timer_elapsed32(write_buffer_time) >= EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT) {
+        spi_eeprom_flush_buffer();
     }
+}
 
-    spi_write(CMD_WRDI);
-    spi_stop();
+void eeprom_driver_flush(void) {
+    spi_eeprom_write_buffer();
+    if (spi_eeprom_wait_while_busy(EXTERNAL_EEPROM_SPI_TIMEOUT) != SPI_STATUS_SUCCESS) {
+        spi_stop();
+        dprint("SPI timeout for WIP check\n");
+    }
 }
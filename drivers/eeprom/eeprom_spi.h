@@ -90,3 +90,12 @@
 #ifndef EXTERNAL_EEPROM_ADDRESS_SIZE
 #    define EXTERNAL_EEPROM_ADDRESS_SIZE 2
 #endif
+
+/*
+    The number of milliseconds without further writes after which partially
+    filled pages are written to the EEPROM. Set to 0 to write at the end of
+    each eeprom_write_block() call instead.
+*/
+#ifndef EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT
+#    define EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT 100
+#endif
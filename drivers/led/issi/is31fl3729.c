@@ -22,6 +22,7 @@
 #include "wait.h"
 
 #define IS31FL3729_PWM_REGISTER_COUNT 143
+#define IS31FL3729_PWM_TRANSFER_SIZE 13
 #define IS31FL3729_SCALING_REGISTER_COUNT 16
 
 #ifndef IS31FL3729_I2C_TIMEOUT
@@ -79,16 +80,19 @@ const uint8_t i2c_addresses[IS31FL3729_DRIVER_COUNT] = {
 
 // These buffers match the PWM & scaling registers.
 // Storing them like this is optimal for I2C transfers to the registers.
+// pwm_buffer_dirty has a bit for each transfer in is31fl3729_write_pwm_buffer(),
+// so that only the transfers with changed registers are sent,
+// and cleared once a transfer has been written successfully.
 typedef struct is31fl3729_driver_t {
-    uint8_t pwm_buffer[IS31FL3729_PWM_REGISTER_COUNT];
-    bool    pwm_buffer_dirty;
-    uint8_t scaling_buffer[IS31FL3729_SCALING_REGISTER_COUNT];
-    bool    scaling_buffer_dirty;
+    uint8_t  pwm_buffer[IS31FL3729_PWM_REGISTER_COUNT];
+    uint16_t pwm_buffer_dirty;
+    uint8_t  scaling_buffer[IS31FL3729_SCALING_REGISTER_COUNT];
+    bool     scaling_buffer_dirty;
 } PACKED is31fl3729_driver_t;
 
 is31fl3729_driver_t driver_buffers[IS31FL3729_DRIVER_COUNT] = {{
     .pwm_buffer           = {0},
-    .pwm_buffer_dirty     = false,
+    .pwm_buffer_dirty     = 0,
     .scaling_buffer       = {0},
     .scaling_buffer_dirty = false,
 }};
@@ -104,16 +108,25 @@ void is31fl3729_write_register(uint8_t index, uint8_t reg, uint8_t data) {
 }
 
 void is31fl3729_write_pwm_buffer(uint8_t index) {
-    // Transmit PWM registers in 11 transfers of 13 bytes.
+    // Transmit PWM registers in up to 11 transfers of 13 bytes,
+    // leaving out those with no changed registers.
 
     // Iterate over the pwm_buffer contents at 13 byte intervals.
-    for (uint8_t i = 0; i <= IS31FL3729_PWM_REGISTER_COUNT; i += 13) {
+    for (uint8_t i = 0; i < IS31FL3729_PWM_REGISTER_COUNT; i += IS31FL3729_PWM_TRANSFER_SIZE) {
+        uint16_t transfer = 1 << (i / IS31FL3729_PWM_TRANSFER_SIZE);
+        if (!(driver_buffers[index].pwm_buffer_dirty & transfer)) continue;
+
 #if IS31FL3729_I2C_PERSISTENCE > 0
         for (uint8_t j = 0; j < IS31FL3729_I2C_PERSISTENCE; j++) {
-            if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, 13, IS31FL3729_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
+            if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, IS31FL3729_PWM_TRANSFER_SIZE, IS31FL3729_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) {
+                driver_buffers[index].pwm_buffer_dirty &= ~transfer;
+                break;
+            }
         }
 #else
-        i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, 13, IS31FL3729_I2C_TIMEOUT);
+        if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, IS31FL3729_PWM_TRANSFER_SIZE, IS31FL3729_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) {
+            driver_buffers[index].pwm_buffer_dirty &= ~transfer;
+        }
 #endif
     }
 }
@@ -155,19 +168,21 @@ void is31fl3729_init(uint8_t index) {
     wait_ms(10);
 }
 
+static void set_pwm_value(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (driver_buffers[driver].pwm_buffer[reg] != value) {
+        driver_buffers[driver].pwm_buffer[reg] = value;
+        driver_buffers[driver].pwm_buffer_dirty |= 1 << (reg / IS31FL3729_PWM_TRANSFER_SIZE);
+    }
+}
+
 void is31fl3729_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     is31fl3729_led_t led;
     if (index >= 0 && index < IS31FL3729_LED_COUNT) {
         memcpy_P(&led, (&g_is31fl3729_leds[index]), sizeof(led));
 
-        if (driver_buffers[led.driver].pwm_buffer[led.r] == red && driver_buffers[led.driver].pwm_buffer[led.g] == green && driver_buffers[led.driver].pwm_buffer[led.b] == blue) {
-            return;
-        }
-
-        driver_buffers[led.driver].pwm_buffer[led.r] = red;
-        driver_buffers[led.driver].pwm_buffer[led.g] = green;
-        driver_buffers[led.driver].pwm_buffer[led.b] = blue;
-        driver_buffers[led.driver].pwm_buffer_dirty  = true;
+        set_pwm_value(led.driver, led.r, red);
+        set_pwm_value(led.driver, led.g, green);
+        set_pwm_value(led.driver, led.b, blue);
     }
 }
 
@@ -197,8 +212,6 @@ void is31fl3729_set_scaling_register(uint8_t index, uint8_t red, uint8_t green,
 void is31fl3729_update_pwm_buffers(uint8_t index) {
     if (driver_buffers[index].pwm_buffer_dirty) {
         is31fl3729_write_pwm_buffer(index);
-
-        driver_buffers[index].pwm_buffer_dirty = false;
     }
 }
 
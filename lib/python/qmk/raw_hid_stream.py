@@ -0,0 +1,187 @@
+"""Host side of the raw HID stream, a reliable byte stream to and from a keyboard built with `RAW_HID_STREAM_ENABLE = yes`.
+
+    from qmk.raw_hid_stream import RawHidStream
+
+    with RawHidStream.open(0xFEED, 0x0000) as stream:
+        stream.write(b'hello')
+        print(stream.read(timeout=1.0))
+
+See docs/features/raw_hid_stream.md for the frame format.
+"""
+import time
+
+RAW_USAGE_PAGE = 0xFF60
+RAW_USAGE_ID = 0x61
+
+REPORT_SIZE = 32
+PAYLOAD_SIZE = REPORT_SIZE - 4
+MAX_WINDOW = 16
+
+STREAM_ID = 0xFD
+DATA = 0x01
+ACK = 0x02
+NAK = 0x03
+RESET = 0x04
+
+
+class RawHidStreamError(Exception):
+    """Raised when the keyboard does not answer in time.
+    """
+
+
+class RawHidStream:
+    """A byte stream over the raw HID interface of a keyboard.
+
+    `device` is anything with the `write(data)` and `read(size, timeout)` methods of `hid.Device`, where timeout is in
+    milliseconds.
+    """
+    def __init__(self, device, stream_id=STREAM_ID, retransmit_timeout=0.25):
+        self.device = device
+        self.stream_id = stream_id
+        self.retransmit_timeout = retransmit_timeout
+
+        self._tx_pending = bytearray()  # written, but not yet given a sequence number
+        self._tx_frames = []  # payloads from _tx_base, sent but not acknowledged
+        self._tx_base = 0
+        self._tx_next = 0
+        self._tx_time = 0.0
+        self._remote_window = 0
+
+        self._rx_data = bytearray()
+        self._rx_expected = 0
+        self._nak_sent = False
+
+    @classmethod
+    def open(cls, vid, pid, **kwargs):
+        """Open the raw HID interface of the first keyboard matching `vid` and `pid`, and reset the stream.
+        """
+        import hid
+
+        for info in hid.enumerate(vid, pid):
+            if info['usage_page'] == RAW_USAGE_PAGE and info['usage'] == RAW_USAGE_ID:
+                stream = cls(hid.Device(path=info['path']), **kwargs)
+                stream.reset()
+                return stream
+
+        raise RawHidStreamError(f'No raw HID interface found for {vid:04x}:{pid:04x}')
+
+    def close(self):
+        self.device.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def reset(self, timeout=1.0):
+        """Restart the sequence numbers of both directions, and wait for the keyboard to grant its window.
+        """
+        # Data sent but not acknowledged is sent again after the reset
+        self._tx_pending[:0] = b''.join(self._tx_frames)
+        self._tx_frames.clear()
+        self._tx_base = self._tx_next = 0
+        self._rx_expected = 0
+        self._nak_sent = False
+
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            self._send(RESET, 0, MAX_WINDOW)
+            retry = min(deadline, time.monotonic() + self.retransmit_timeout)
+            while time.monotonic() < retry:
+                frame = self._receive(retry)
+                if frame and frame[1] == ACK and frame[2] == 0:
+                    self._remote_window = min(frame[3], MAX_WINDOW)
+                    return
+
+        raise RawHidStreamError('Keyboard did not answer the stream reset')
+
+    def write(self, data, timeout=5.0):
+        """Send `data`, returning once the keyboard has acknowledged all of it.
+        """
+        self._tx_pending += data
+        deadline = time.monotonic() + timeout
+
+        while self._tx_pending or self._tx_frames:
+            self._send_data()
+            if time.monotonic() >= deadline:
+                raise RawHidStreamError('Keyboard did not acknowledge the data in time')
+            self._poll(min(deadline, time.monotonic() + self.retransmit_timeout))
+            if self._tx_frames and self._tx_next == len(self._tx_frames) and time.monotonic() - self._tx_time >= self.retransmit_timeout:
+                self._tx_next = 0
+
+    def read(self, size=None, timeout=0.0):
+        """Return up to `size` bytes received from the keyboard, waiting up to `timeout` seconds for any to arrive.
+        """
+        deadline = time.monotonic() + timeout
+        self._poll(time.monotonic())
+        while not self._rx_data and time.monotonic() < deadline:
+            self._poll(deadline)
+
+        size = len(self._rx_data) if size is None else size
+        data = bytes(self._rx_data[:size])
+        del self._rx_data[:size]
+        return data
+
+    def _send(self, frame_type, seq, length, payload=b''):
+        report = bytes([self.stream_id, frame_type, seq & 0xFF, length]) + payload
+        # Leading zero is the report ID
+        self.device.write(b'\x00' + report.ljust(REPORT_SIZE, b'\x00'))
+
+    def _receive(self, deadline):
+        remaining = max(0, int((deadline - time.monotonic()) * 1000))
+        frame = self.device.read(REPORT_SIZE, remaining)
+        if not frame or len(frame) < 4 or frame[0] != self.stream_id:
+            return None
+        return frame
+
+    def _send_data(self):
+        while self._tx_next < self._remote_window:
+            if self._tx_next == len(self._tx_frames):
+                if not self._tx_pending:
+                    break
+                self._tx_frames.append(bytes(self._tx_pending[:PAYLOAD_SIZE]))
+                del self._tx_pending[:PAYLOAD_SIZE]
+
+            payload = self._tx_frames[self._tx_next]
+            self._send(DATA, self._tx_base + self._tx_next, len(payload), payload)
+            self._tx_next += 1
+            self._tx_time = time.monotonic()
+
+    def _poll(self, deadline):
+        """Handle every frame from the keyboard until none arrives before `deadline`, acknowledging received data once.
+        """
+        acknowledge = False
+        frame = self._receive(deadline)
+        while frame:
+            acknowledge |= self._handle(frame)
+            frame = self._receive(time.monotonic())
+        if acknowledge:
+            self._send(ACK, self._rx_expected, MAX_WINDOW)
+
+    def _handle(self, frame):
+        frame_type, seq, length = frame[1], frame[2], frame[3]
+
+        if frame_type in (ACK, NAK):
+            count = (seq - self._tx_base) & 0xFF
+            if count <= len(self._tx_frames):
+                del self._tx_frames[:count]
+                self._tx_base = (self._tx_base + count) & 0xFF
+                self._tx_next = 0 if frame_type == NAK else max(0, self._tx_next - count)
+                self._remote_window = min(length, MAX_WINDOW)
+                self._tx_time = time.monotonic()
+
+        elif frame_type == DATA:
+            if seq == self._rx_expected and 1 <= length <= PAYLOAD_SIZE:
+                self._rx_data += bytes(frame[4:4 + length])
+                self._rx_expected = (self._rx_expected + 1) & 0xFF
+                self._nak_sent = False
+                return True
+            if ((self._rx_expected - seq) & 0xFF) <= MAX_WINDOW:
+                # Already received, the keyboard missed the acknowledgement
+                return True
+            if not self._nak_sent:
+                self._send(NAK, self._rx_expected, MAX_WINDOW)
+                self._nak_sent = True
+
+        return False
@@ -0,0 +1,150 @@
+from qmk.raw_hid_stream import ACK, DATA, MAX_WINDOW, NAK, PAYLOAD_SIZE, REPORT_SIZE, RESET, STREAM_ID, RawHidStream, RawHidStreamError
+
+
+class FakeKeyboard:
+    """Keyboard side of the stream, answering the host straight away.
+
+    DATA frames whose index, counted from the first one written, is in `drop` are lost on the way.
+    """
+    def __init__(self, window=4, drop=(), silent=False):
+        self.window = window
+        self.drop = set(drop)
+        self.silent = silent
+        self.expected = 0
+        self.received = bytearray()
+        self.host_frames = []
+        self.outbox = []
+        self.data_frames = 0
+
+    def write(self, data):
+        assert len(data) == REPORT_SIZE + 1
+        assert data[0] == 0
+        frame = bytes(data[1:])
+        self.host_frames.append(frame)
+        if self.silent or frame[0] != STREAM_ID:
+            return
+
+        frame_type, seq, length = frame[1], frame[2], frame[3]
+        if frame_type == RESET:
+            self.expected = 0
+            self.reply(ACK, 0, self.window)
+
+        elif frame_type == DATA:
+            index = self.data_frames
+            self.data_frames += 1
+            if index in self.drop:
+                return
+            if seq == self.expected:
+                self.received += frame[4:4 + length]
+                self.expected = (self.expected + 1) & 0xFF
+                self.reply(ACK, self.expected, self.window)
+            else:
+                self.reply(NAK, self.expected, self.window)
+
+    def read(self, size, timeout):
+        return self.outbox.pop(0) if self.outbox else b''
+
+    def close(self):
+        pass
+
+    def reply(self, frame_type, seq, length, payload=b''):
+        self.outbox.append((bytes([STREAM_ID, frame_type, seq, length]) + payload).ljust(REPORT_SIZE, b'\x00'))
+
+    def send(self, seq, payload):
+        self.reply(DATA, seq, len(payload), payload)
+
+    def sent_by_host(self, frame_type):
+        return [frame for frame in self.host_frames if frame[1] == frame_type]
+
+
+def open_stream(keyboard):
+    stream = RawHidStream(keyboard, retransmit_timeout=0.01)
+    stream.reset()
+    return stream
+
+
+def test_reset_grants_host_window():
+    keyboard = FakeKeyboard()
+    open_stream(keyboard)
+
+    resets = keyboard.sent_by_host(RESET)
+    assert len(resets) == 1
+    assert resets[0][3] == MAX_WINDOW
+
+
+def test_reset_without_answer_raises():
+    stream = RawHidStream(FakeKeyboard(silent=True), retransmit_timeout=0.01)
+
+    try:
+        stream.reset(timeout=0.05)
+        assert False, 'reset should have timed out'
+    except RawHidStreamError:
+        pass
+
+
+def test_write_splits_data_into_frames():
+    keyboard = FakeKeyboard()
+    stream = open_stream(keyboard)
+    data = bytes(range(100))
+
+    stream.write(data, timeout=1.0)
+
+    assert keyboard.received == data
+    frames = keyboard.sent_by_host(DATA)
+    assert [frame[3] for frame in frames] == [PAYLOAD_SIZE, PAYLOAD_SIZE, PAYLOAD_SIZE, 100 - 3 * PAYLOAD_SIZE]
+    assert [frame[2] for frame in frames] == [0, 1, 2, 3]
+
+
+def test_write_resends_lost_frame():
+    keyboard = FakeKeyboard(drop=[1])
+    stream = open_stream(keyboard)
+    data = bytes(range(4 * PAYLOAD_SIZE))
+
+    stream.write(data, timeout=1.0)
+
+    assert keyboard.received == data
+    assert keyboard.sent_by_host(DATA)[4][2] == 1
+
+
+def test_write_without_acknowledgement_raises():
+    keyboard = FakeKeyboard()
+    stream = open_stream(keyboard)
+    keyboard.silent = True
+
+    try:
+        stream.write(b'hello', timeout=0.05)
+        assert False, 'write should have timed out'
+    except RawHidStreamError:
+        pass
+
+
+def test_read_acknowledges_data():
+    keyboard = FakeKeyboard()
+    stream = open_stream(keyboard)
+    keyboard.send(0, b'hello ')
+    keyboard.send(1, b'world')
+
+    assert stream.read(timeout=0.1) == b'hello world'
+    assert keyboard.sent_by_host(ACK)[-1][2] == 2
+
+
+def test_read_drops_repeated_frame():
+    keyboard = FakeKeyboard()
+    stream = open_stream(keyboard)
+    keyboard.send(0, b'hello')
+    keyboard.send(0, b'hello')
+
+    assert stream.read(timeout=0.1) == b'hello'
+    assert stream.read() == b''
+    assert not keyboard.sent_by_host(NAK)
+
+
+def test_read_asks_for_missing_frame():
+    keyboard = FakeKeyboard()
+    stream = open_stream(keyboard)
+    keyboard.send(1, b'world')
+
+    assert stream.read() == b''
+    naks = keyboard.sent_by_host(NAK)
+    assert len(naks) == 1
+    assert naks[0][2] == 0
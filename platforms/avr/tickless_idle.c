@@ -0,0 +1,31 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+#include "tickless_idle.h"
+#include "timer.h"
+
+static volatile bool wake_pending = false;
+
+void tickless_idle_platform_wait(uint32_t timeout_ms) {
+    uint32_t start = timer_read32();
+    // The millisecond timer interrupt brings the CPU out of idle sleep, so the timeout is rechecked every tick
+    while (!wake_pending && timer_elapsed32(start) < timeout_ms) {
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        cli();
+        if (!wake_pending) {
+            sleep_enable();
+            sei();
+            sleep_cpu();
+            sleep_disable();
+        }
+        sei();
+    }
+    wake_pending = false;
+}
+
+void tickless_idle_platform_wake(void) {
+    wake_pending = true;
+}
@@ -0,0 +1,32 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+
+#include "tickless_idle.h"
+
+#define TICKLESS_IDLE_EVENT EVENT_MASK(0)
+
+static thread_t *idle_thread = NULL;
+
+void tickless_idle_platform_wait(uint32_t timeout_ms) {
+    // Wakeups signalled while the main loop was busy remain pending, so none are lost
+    if (idle_thread == NULL) {
+        idle_thread = chThdGetSelfX();
+    }
+    // The idle thread enters WFI until either the timeout or a wakeup occurs
+    chEvtWaitAnyTimeout(TICKLESS_IDLE_EVENT, TIME_MS2I(timeout_ms));
+}
+
+void tickless_idle_platform_wake(void) {
+    if (idle_thread == NULL) {
+        return;
+    }
+    if (port_is_isr_context()) {
+        chSysLockFromISR();
+        chEvtSignalI(idle_thread, TICKLESS_IDLE_EVENT);
+        chSysUnlockFromISR();
+    } else {
+        chEvtSignal(idle_thread, TICKLESS_IDLE_EVENT);
+    }
+}
@@ -69,8 +69,12 @@ void     eeprom_update_block(const void *__src, void *__dst, size_t __n);
 #    define TOTAL_EEPROM_BYTE_COUNT 4096
 #elif defined(EEPROM_TEST_HARNESS)
 #    ifndef LEGACY_FLASH_OPS_MOCKED
-// Normal tests
-#        define TOTAL_EEPROM_BYTE_COUNT 32
+// Normal tests, which can ask for more space when storing to EEPROM
+#        ifdef EEPROM_TEST_HARNESS_SIZE
+#            define TOTAL_EEPROM_BYTE_COUNT (EEPROM_TEST_HARNESS_SIZE)
+#        else
+#            define TOTAL_EEPROM_BYTE_COUNT 32
+#        endif
 #    else
 // Flash wear-leveling testing
 #        include "eeprom_legacy_emulated_flash_tests.h"
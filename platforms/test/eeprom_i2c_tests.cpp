@@ -0,0 +1,182 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "timer.h"
+#include "i2c_master.h"
+#include "eeprom.h"
+#include "eeprom_driver.h"
+
+void simulate_async_tick(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+/* Simulated I2C EEPROM. Like the real device, it ignores its address while
+ * busy, until busy_until, and takes EXTERNAL_EEPROM_WRITE_TIME - 1
+ * milliseconds to write a page. */
+static uint8_t  memory[EXTERNAL_EEPROM_BYTE_COUNT];
+static uint32_t address_pointer;
+static uint32_t busy_until;
+static int      transmits;
+static int      failing_transmits;
+static int      pings;
+
+static bool device_busy(void) {
+    return timer_read32() < busy_until;
+}
+
+extern "C" void i2c_init(void) {}
+
+extern "C" i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    if (device_busy()) {
+        return I2C_STATUS_ERROR;
+    }
+    if (failing_transmits > 0) {
+        failing_transmits--;
+        return I2C_STATUS_ERROR;
+    }
+
+    address_pointer = 0;
+    for (int i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; i++) {
+        address_pointer = (address_pointer << 8) | data[i];
+    }
+    if (length > EXTERNAL_EEPROM_ADDRESS_SIZE) {
+        transmits++;
+        memcpy(&memory[address_pointer], &data[EXTERNAL_EEPROM_ADDRESS_SIZE], length - EXTERNAL_EEPROM_ADDRESS_SIZE);
+        busy_until = timer_read32() + EXTERNAL_EEPROM_WRITE_TIME - 1;
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+extern "C" i2c_status_t i2c_receive(uint8_t address, uint8_t *data, uint16_t length, uint16_t timeout) {
+    if (device_busy()) {
+        return I2C_STATUS_ERROR;
+    }
+    memcpy(data, &memory[address_pointer], length);
+    return I2C_STATUS_SUCCESS;
+}
+
+extern "C" i2c_status_t i2c_ping_address(uint8_t address, uint16_t timeout) {
+    pings++;
+    return device_busy() ? I2C_STATUS_ERROR : I2C_STATUS_SUCCESS;
+}
+
+class EepromI2c : public testing::Test {
+   public:
+    void SetUp() override {
+        timer_clear();
+        // Time passes while the driver polls the device
+        simulate_async_tick(1);
+        memset(memory, 0, sizeof(memory));
+        busy_until        = 0;
+        transmits         = 0;
+        failing_transmits = 0;
+        pings             = 0;
+    }
+
+    void TearDown() override {
+        // Don't leave a page buffered for the next test
+        busy_until        = 0;
+        failing_transmits = 0;
+        eeprom_driver_flush();
+    }
+
+    void write(uintptr_t addr, uint8_t value) {
+        eeprom_write_block(&value, (void *)addr, 1);
+    }
+};
+
+TEST_F(EepromI2c, WritesAreBufferedUntilFlushed) {
+    write(0, 0xAA);
+    write(1, 0xBB);
+    write(2, 0xCC);
+    EXPECT_EQ(transmits, 0);
+    EXPECT_EQ(eeprom_read_byte((const uint8_t *)1), 0xBB);
+
+    eeprom_driver_flush();
+    EXPECT_EQ(transmits, 1);
+    EXPECT_EQ(memory[0], 0xAA);
+    EXPECT_EQ(memory[1], 0xBB);
+    EXPECT_EQ(memory[2], 0xCC);
+}
+
+TEST_F(EepromI2c, BufferedPageIsWrittenAfterTimeout) {
+    write(0, 0xAA);
+    eeprom_driver_task();
+    EXPECT_EQ(transmits, 0);
+
+    advance_time(EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT);
+    eeprom_driver_task();
+    EXPECT_EQ(transmits, 1);
+    EXPECT_EQ(memory[0], 0xAA);
+}
+
+TEST_F(EepromI2c, NextPageWriteWaitsForAck) {
+    write(0, 0xAA);
+    eeprom_driver_flush();
+    pings = 0;
+
+    write(EXTERNAL_EEPROM_PAGE_SIZE, 0xBB);
+    eeprom_driver_flush();
+    EXPECT_GT(pings, 0);
+    EXPECT_EQ(transmits, 2);
+    EXPECT_EQ(memory[EXTERNAL_EEPROM_PAGE_SIZE], 0xBB);
+}
+
+TEST_F(EepromI2c, FailedPageIsRetriedBeforeSwitchingPages) {
+    write(0, 0xAA);
+    // Transfers failing quickly, rather than the device being busy
+    simulate_async_tick(0);
+    failing_transmits = 3;
+
+    write(EXTERNAL_EEPROM_PAGE_SIZE, 0xBB);
+    EXPECT_EQ(memory[0], 0xAA);
+
+    simulate_async_tick(1);
+    eeprom_driver_flush();
+    EXPECT_EQ(memory[EXTERNAL_EEPROM_PAGE_SIZE], 0xBB);
+}
+
+TEST_F(EepromI2c, BusyDeviceIsPolledForAckBeforeSwitchingPages) {
+    write(0, 0xAA);
+    busy_until = timer_read32() + EXTERNAL_EEPROM_WRITE_TIME - 1;
+
+    write(EXTERNAL_EEPROM_PAGE_SIZE, 0xBB);
+    EXPECT_GT(pings, 0);
+    EXPECT_EQ(memory[0], 0xAA);
+
+    eeprom_driver_flush();
+    EXPECT_EQ(memory[EXTERNAL_EEPROM_PAGE_SIZE], 0xBB);
+}
+
+TEST_F(EepromI2c, PageIsOnlyDroppedOnceAckPollingTimesOut) {
+    write(0, 0xAA);
+    busy_until = timer_read32() + 1000;
+
+    uint32_t start = timer_read32();
+    write(EXTERNAL_EEPROM_PAGE_SIZE, 0xBB);
+    EXPECT_GT(timer_elapsed32(start), EXTERNAL_EEPROM_WRITE_TIME);
+    EXPECT_LT(timer_elapsed32(start), 1000);
+    EXPECT_EQ(memory[0], 0x00);
+
+    busy_until = 0;
+    eeprom_driver_flush();
+    EXPECT_EQ(memory[EXTERNAL_EEPROM_PAGE_SIZE], 0xBB);
+}
+
+TEST_F(EepromI2c, FailedFlushKeepsPageBuffered) {
+    write(0, 0xAA);
+    busy_until = timer_read32() + 1000;
+
+    eeprom_driver_flush();
+    EXPECT_EQ(memory[0], 0x00);
+    EXPECT_EQ(eeprom_read_byte((const uint8_t *)0), 0xAA);
+
+    busy_until = 0;
+    advance_time(EXTERNAL_EEPROM_WRITE_BUFFER_TIMEOUT);
+    eeprom_driver_task();
+    EXPECT_EQ(memory[0], 0xAA);
+}
@@ -0,0 +1,18 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "tickless_idle.h"
+
+// Time does not pass while waiting, the requested waits are recorded for inspection by tests instead
+uint32_t tickless_idle_wait_count   = 0;
+uint32_t tickless_idle_last_timeout = 0;
+uint32_t tickless_idle_wake_count   = 0;
+
+void tickless_idle_platform_wait(uint32_t timeout_ms) {
+    ++tickless_idle_wait_count;
+    tickless_idle_last_timeout = timeout_ms;
+}
+
+void tickless_idle_platform_wake(void) {
+    ++tickless_idle_wake_count;
+}
@@ -7,6 +7,10 @@
 #include "util.h"
 #include "action_layer.h"
 
+#ifdef EVENT_TRACE_ENABLE
+#    include "event_trace.h"
+#endif
+
 /** \brief Default Layer State
  */
 layer_state_t default_layer_state = 0;
@@ -117,6 +121,9 @@ void layer_state_set(layer_state_t state) {
     layer_debug();
     ac_dprintf(" to ");
     layer_state = state;
+#    ifdef EVENT_TRACE_ENABLE
+    event_trace_layer(state);
+#    endif
     layer_debug();
     ac_dprintf("\n");
 #    if defined(STRICT_LAYER_RELEASE)
@@ -1,10 +1,12 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "action.h"
 #include "action_layer.h"
 #include "action_tapping.h"
 #include "keycode.h"
+#include "matrix.h"
 #include "timer.h"
 
 #ifndef NO_ACTION_TAPPING
@@ -55,17 +57,44 @@ __attribute__((weak)) bool get_hold_on_other_key_press(uint16_t keycode, keyreco
 }
 #    endif
 
+#    ifdef SPECULATIVE_HOLD_TAP_PER_KEY
+__attribute__((weak)) bool get_speculative_hold_tap(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+#    endif
+
 #    if defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)
 #        include "process_auto_shift.h"
+#        ifdef SPECULATIVE_HOLD_TAP
+#            error "SPECULATIVE_HOLD_TAP is not compatible with RETRO_SHIFT"
+#        endif
 #    endif
 
-static keyrecord_t tapping_key                         = {};
-static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
-static uint8_t     waiting_buffer_head                 = 0;
-static uint8_t     waiting_buffer_tail                 = 0;
+#    ifdef SPECULATIVE_HOLD_TAP
+#        include "quantum_keycodes.h"
+#    endif
+
+_Static_assert(WAITING_BUFFER_SIZE > 0 && WAITING_BUFFER_SIZE < UINT8_MAX, "WAITING_BUFFER_SIZE must be between 1 and 254");
+
+// One slot is kept free to tell a full buffer from an empty one
+#    define WAITING_BUFFER_SLOTS (WAITING_BUFFER_SIZE + 1)
+
+static keyrecord_t tapping_key                          = {};
+static keyrecord_t waiting_buffer[WAITING_BUFFER_SLOTS] = {};
+static uint8_t     waiting_buffer_head                  = 0;
+static uint8_t     waiting_buffer_tail                  = 0;
+
+// Matrix positions with a press or release in the waiting buffer, to find them without scanning the buffer
+static matrix_row_t waiting_buffer_pressed[MATRIX_ROWS]  = {};
+static matrix_row_t waiting_buffer_released[MATRIX_ROWS] = {};
+// Number of waiting events outside of the matrix, such as combos and encoders, which can only be found by scanning
+static uint8_t waiting_buffer_unindexed = 0;
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_deq(void);
+static void waiting_buffer_process(void);
+static void waiting_buffer_settle(void);
 static void waiting_buffer_clear(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
@@ -73,45 +102,97 @@ static void waiting_buffer_scan_tap(void);
 static void debug_tapping_key(void);
 static void debug_waiting_buffer(void);
 
+#    ifdef SPECULATIVE_HOLD_TAP
+static bool        speculation_enabled   = true;
+static bool        speculating           = false;
+static bool        tapping_key_in_streak = false;
+static uint16_t    last_press_time       = 0;
+static uint8_t     speculation_log_count = 0;
+static keyrecord_t speculation_log[SPECULATIVE_HOLD_TAP_LOG_SIZE];
+// Two bit saturating counters, indexed by a hash of the keycode: 0 and 1 predict a hold, 2 and 3 a tap
+static uint8_t tap_history[SPECULATIVE_HOLD_TAP_HISTORY_SIZE] = {[0 ... SPECULATIVE_HOLD_TAP_HISTORY_SIZE - 1] = 2};
+
+static void tapping_key_resolved(bool tap);
+static bool speculation_predicts_tap(keyrecord_t *keyp);
+static void speculation_start(keyrecord_t *keyp);
+static bool speculation_log_event(keyrecord_t *keyp);
+static bool speculation_logged_press(keyevent_t event);
+static void speculation_retract(void);
+#    else
+#        define tapping_key_resolved(tap)
+#    endif
+
 /** \brief Action Tapping Process
  *
  * FIXME: Needs doc
  */
 void action_tapping_process(keyrecord_t record) {
+#    ifdef SPECULATIVE_HOLD_TAP
+    const bool pressed = IS_EVENT(record.event) && record.event.pressed;
+#    endif
     if (process_tapping(&record)) {
         if (IS_EVENT(record.event)) {
             ac_dprintf("processed: ");
             debug_record(record);
             ac_dprintf("\n");
         }
-    } else {
-        if (!waiting_buffer_enq(record)) {
-            // clear all in case of overflow.
+    } else if (!waiting_buffer_enq(record)) {
+        // Out of room: settle the tapping key as held if still undecided, and let the waiting events through rather
+        // than dropping them
+        ac_dprintf("OVERFLOW: SETTLE TAPPING KEY\n");
+        waiting_buffer_settle();
+        waiting_buffer_process();
+        if (!process_tapping(&record) && !waiting_buffer_enq(record)) {
+            // clear all if still stuck, which should never happen
             ac_dprintf("OVERFLOW: CLEAR ALL STATES\n");
             clear_keyboard();
             waiting_buffer_clear();
             tapping_key = (keyrecord_t){0};
+#    ifdef SPECULATIVE_HOLD_TAP
+            speculating = false;
+#    endif
         }
     }
+#    ifdef SPECULATIVE_HOLD_TAP
+    if (pressed) {
+        last_press_time = record.event.time;
+    }
+#    endif
 
     // process waiting_buffer
     if (IS_EVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         ac_dprintf("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
-            ac_dprintf("processed: waiting_buffer[%u] =", waiting_buffer_tail);
-            debug_record(waiting_buffer[waiting_buffer_tail]);
-            ac_dprintf("\n\n");
-        } else {
-            break;
-        }
-    }
+    waiting_buffer_process();
     if (IS_EVENT(record.event)) {
         ac_dprintf("\n");
     }
 }
 
+/** \brief Action Tapping Next Deadline
+ *
+ * Determines when the tapping state machine next needs a tick, i.e. once the
+ * tapping term of the current tapping key expires.
+ */
+bool action_tapping_next_deadline(uint32_t *deadline) {
+    if (IS_NOEVENT(tapping_key.event)) {
+        return false;
+    }
+
+    uint16_t term    = GET_TAPPING_TERM(get_record_keycode(&tapping_key, false), &tapping_key);
+    uint16_t elapsed = timer_elapsed(tapping_key.event.time);
+    if (elapsed >= term) {
+        // A tap which is still held has nothing left to time out
+        if (tapping_key.event.pressed && tapping_key.tap.count > 0) {
+            return false;
+        }
+        elapsed = term;
+    }
+
+    *deadline = timer_read32() + (term - elapsed);
+    return true;
+}
+
 /* Some conditionally defined helper macros to keep process_tapping more
  * readable. The conditional definition of tapping_keycode and all the
  * conditional uses of it are hidden inside macros named TAP_...
@@ -176,6 +257,9 @@ bool process_tapping(keyrecord_t *keyp) {
             // into the "pressed" tapping key state
             ac_dprintf("Tapping: Start(Press tap key).\n");
             tapping_key = *keyp;
+#    ifdef SPECULATIVE_HOLD_TAP
+            tapping_key_in_streak = TIMER_DIFF_16(event.time, last_press_time) < SPECULATIVE_HOLD_TAP_TYPING_TERM;
+#    endif
             process_record_tap_hint(&tapping_key);
             waiting_buffer_scan_tap();
             debug_tapping_key();
@@ -204,6 +288,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     // first tap!
                     ac_dprintf("Tapping: First tap(0->1).\n");
                     tapping_key.tap.count = 1;
+                    tapping_key_resolved(true);
                     debug_tapping_key();
                     process_record(&tapping_key);
 
@@ -228,6 +313,7 @@ bool process_tapping(keyrecord_t *keyp) {
                 ) {
                     // clang-format on
                     ac_dprintf("Tapping: End. No tap. Interfered by typing key\n");
+                    tapping_key_resolved(false);
                     process_record(&tapping_key);
                     tapping_key = (keyrecord_t){0};
                     debug_tapping_key();
@@ -279,12 +365,21 @@ bool process_tapping(keyrecord_t *keyp) {
 #    endif
                         ) {
                             ac_dprintf("Tapping: End. No tap. Interfered by pressed key\n");
+                            tapping_key_resolved(false);
                             process_record(&tapping_key);
                             tapping_key = (keyrecord_t){0};
                             debug_tapping_key();
                             // enqueue
                             return false;
                         }
+#    ifdef SPECULATIVE_HOLD_TAP
+                        // Only when nothing is buffered, as that would have to be processed first
+                        if (waiting_buffer_tail == waiting_buffer_head && speculation_predicts_tap(keyp)) {
+                            ac_dprintf("Tapping: Speculative tap. Interrupted by typing key\n");
+                            speculation_start(keyp);
+                            return true;
+                        }
+#    endif
                     }
                     // enqueue
                     return false;
@@ -294,6 +389,13 @@ bool process_tapping(keyrecord_t *keyp) {
             else {
                 if (IS_TAPPING_RECORD(keyp) && !event.pressed) {
                     ac_dprintf("Tapping: Tap release(%u)\n", tapping_key.tap.count);
+#    ifdef SPECULATIVE_HOLD_TAP
+                    if (speculating) {
+                        ac_dprintf("Tapping: Speculative tap confirmed.\n");
+                        speculating = false;
+                        tapping_key_resolved(true);
+                    }
+#    endif
                     keyp->tap = tapping_key.tap;
                     process_record(keyp);
                     tapping_key = *keyp;
@@ -316,6 +418,10 @@ bool process_tapping(keyrecord_t *keyp) {
                     } else {
                         ac_dprintf("Tapping: Start while last tap(1).\n");
                     }
+#    ifdef SPECULATIVE_HOLD_TAP
+                    // The tap can no longer be retracted
+                    speculating = false;
+#    endif
                     tapping_key = *keyp;
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
@@ -324,18 +430,39 @@ bool process_tapping(keyrecord_t *keyp) {
                     ac_dprintf("Tapping: key event while last tap(>0).\n");
 #    if defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)
                     retroshift_swap_times();
+#    endif
+#    ifdef SPECULATIVE_HOLD_TAP
+                    if (speculating && !speculation_log_event(keyp)) {
+                        ac_dprintf("Tapping: Speculative tap committed.\n");
+                        speculating = false;
+                    }
 #    endif
                     process_record(keyp);
+#    ifdef SPECULATIVE_HOLD_TAP
+                    // A key pressed and released while the tapping key is held is a hold with permissive hold
+                    if (speculating && !event.pressed && TAP_GET_PERMISSIVE_HOLD && speculation_logged_press(event)) {
+                        ac_dprintf("Tapping: Speculative tap retracted. Interfered by typing key\n");
+                        speculation_retract();
+                    }
+#    endif
                     return true;
                 }
             }
         }
         // after TAPPING_TERM
         else {
+#    ifdef SPECULATIVE_HOLD_TAP
+            if (speculating) {
+                ac_dprintf("Tapping: Speculative tap retracted. Timeout.\n");
+                speculation_retract();
+                return process_tapping(keyp);
+            }
+#    endif
             if (tapping_key.tap.count == 0) {
                 ac_dprintf("Tapping: End. Timeout. Not tap(0): ");
                 debug_event(event);
                 ac_dprintf("\n");
+                tapping_key_resolved(false);
                 process_record(&tapping_key);
                 tapping_key = (keyrecord_t){0};
                 debug_tapping_key();
@@ -432,43 +559,122 @@ bool process_tapping(keyrecord_t *keyp) {
     }
 }
 
+static inline uint8_t waiting_buffer_next(uint8_t index) {
+    return index + 1 == WAITING_BUFFER_SLOTS ? 0 : index + 1;
+}
+
+static inline bool waiting_buffer_indexed(keyevent_t event) {
+    return event.type == KEY_EVENT && event.key.row < MATRIX_ROWS && event.key.col < MATRIX_COLS;
+}
+
+static inline matrix_row_t *waiting_buffer_index(bool pressed) {
+    return pressed ? waiting_buffer_pressed : waiting_buffer_released;
+}
+
 /** \brief Waiting buffer enq
  *
- * FIXME: Needs docs
+ * Appends a record to the buffer, returning false if it is full.
  */
 bool waiting_buffer_enq(keyrecord_t record) {
     if (IS_NOEVENT(record.event)) {
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if (waiting_buffer_next(waiting_buffer_head) == waiting_buffer_tail) {
         ac_dprintf("waiting_buffer_enq: Over flow.\n");
         return false;
     }
 
     waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_head                 = waiting_buffer_next(waiting_buffer_head);
+    if (waiting_buffer_indexed(record.event)) {
+        waiting_buffer_index(record.event.pressed)[record.event.key.row] |= (matrix_row_t)1 << record.event.key.col;
+    } else {
+        waiting_buffer_unindexed++;
+    }
 
     ac_dprintf("waiting_buffer_enq: ");
     debug_waiting_buffer();
     return true;
 }
 
+/** \brief Waiting buffer deq
+ *
+ * Removes the oldest record from the buffer.
+ */
+void waiting_buffer_deq(void) {
+    keyevent_t event    = waiting_buffer[waiting_buffer_tail].event;
+    waiting_buffer_tail = waiting_buffer_next(waiting_buffer_tail);
+    if (!waiting_buffer_indexed(event)) {
+        waiting_buffer_unindexed--;
+        return;
+    }
+
+    // Presses and releases of a key alternate, so another one like it can only be waiting behind an opposite one
+    const matrix_row_t mask = (matrix_row_t)1 << event.key.col;
+    if (waiting_buffer_index(!event.pressed)[event.key.row] & mask) {
+        for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = waiting_buffer_next(i)) {
+            if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed == waiting_buffer[i].event.pressed && waiting_buffer_indexed(waiting_buffer[i].event)) {
+                return;
+            }
+        }
+    }
+    waiting_buffer_index(event.pressed)[event.key.row] &= ~mask;
+}
+
+/** \brief Waiting buffer process
+ *
+ * Processes waiting records in order, until one has to keep waiting.
+ */
+void waiting_buffer_process(void) {
+    while (waiting_buffer_tail != waiting_buffer_head) {
+        if (!process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+            break;
+        }
+        ac_dprintf("processed: waiting_buffer[%u] =", waiting_buffer_tail);
+        debug_record(waiting_buffer[waiting_buffer_tail]);
+        ac_dprintf("\n\n");
+        waiting_buffer_deq();
+    }
+}
+
+/** \brief Waiting buffer settle
+ *
+ * Resolves an undecided tapping key as held, so that the events waiting on it can be processed.
+ */
+void waiting_buffer_settle(void) {
+    if (!tapping_key.event.pressed || tapping_key.tap.count > 0) {
+        return;
+    }
+    ac_dprintf("Tapping: End. No tap. Waiting buffer full\n");
+    tapping_key_resolved(false);
+    process_record(&tapping_key);
+    tapping_key = (keyrecord_t){0};
+    debug_tapping_key();
+}
+
 /** \brief Waiting buffer clear
  *
- * FIXME: Needs docs
+ * Discards all waiting records.
  */
 void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    waiting_buffer_head      = 0;
+    waiting_buffer_tail      = 0;
+    waiting_buffer_unindexed = 0;
+    memset(waiting_buffer_pressed, 0, sizeof(waiting_buffer_pressed));
+    memset(waiting_buffer_released, 0, sizeof(waiting_buffer_released));
 }
 
 /** \brief Waiting buffer typed
  *
- * FIXME: Needs docs
+ * Whether the opposite event of the same key is waiting, i.e. for a release whether the key was pressed while
+ * waiting.
  */
 bool waiting_buffer_typed(keyevent_t event) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    if (waiting_buffer_indexed(event)) {
+        return waiting_buffer_index(!event.pressed)[event.key.row] & ((matrix_row_t)1 << event.key.col);
+    }
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = waiting_buffer_next(i)) {
         if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
             return true;
         }
@@ -481,7 +687,7 @@ bool waiting_buffer_typed(keyevent_t event) {
  * FIXME: Needs docs
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = waiting_buffer_next(i)) {
         if (waiting_buffer[i].event.pressed) return true;
     }
     return false;
@@ -498,11 +704,15 @@ void waiting_buffer_scan_tap(void) {
     if ((tapping_key.tap.count > 0) || !tapping_key.event.pressed) {
         return;
     }
+    // - the tapping key hasn't been released
+    if (waiting_buffer_indexed(tapping_key.event) && !(waiting_buffer_released[tapping_key.event.key.row] & ((matrix_row_t)1 << tapping_key.event.key.col))) {
+        return;
+    }
 
 #    if (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT))
     TAP_DEFINE_KEYCODE;
 #    endif
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = waiting_buffer_next(i)) {
         keyrecord_t *candidate = &waiting_buffer[i];
         // clang-format off
         if (IS_EVENT(candidate->event) && KEYEQ(candidate->event.key, tapping_key.event.key) && !candidate->event.pressed && (
@@ -511,6 +721,7 @@ void waiting_buffer_scan_tap(void) {
             // clang-format on
             tapping_key.tap.count = 1;
             candidate->tap.count  = 1;
+            tapping_key_resolved(true);
             process_record(&tapping_key);
 
             ac_dprintf("waiting_buffer_scan_tap: found at [%u]\n", i);
@@ -520,6 +731,165 @@ void waiting_buffer_scan_tap(void) {
     }
 }
 
+#    ifdef SPECULATIVE_HOLD_TAP
+/** \brief Enable or disable speculative hold-tap resolution at runtime
+ */
+void speculative_hold_tap_enable(bool enable) {
+    speculation_enabled = enable;
+}
+
+bool speculative_hold_tap_is_enabled(void) {
+    return speculation_enabled;
+}
+
+/** \brief Forget which keys were tapped and held in the past
+ */
+void speculative_hold_tap_clear_history(void) {
+    memset(tap_history, 2, sizeof(tap_history));
+}
+
+static uint8_t *tap_history_entry(uint16_t keycode) {
+    return &tap_history[(keycode ^ (keycode >> 5) ^ (keycode >> 10)) % SPECULATIVE_HOLD_TAP_HISTORY_SIZE];
+}
+
+/** \brief Record how the current tapping key was resolved, training the prediction for that key
+ */
+static void tapping_key_resolved(bool tap) {
+    uint8_t *entry = tap_history_entry(get_record_keycode(&tapping_key, false));
+    if (tap) {
+        if (*entry < 3) (*entry)++;
+    } else {
+        if (*entry > 0) (*entry)--;
+    }
+}
+
+/** \brief Whether a keycode only types a character, and so can be undone with a backspace
+ */
+static bool is_retractable_keycode(uint16_t keycode) {
+    return (keycode >= KC_A && keycode <= KC_0) || (keycode >= KC_SPACE && keycode <= KC_SLASH);
+}
+
+/** \brief Whether the tapping key is likely to be a tap, given another key pressed while it is undecided
+ *
+ * Both the tap keycode and the other key need to be retractable. Keys tapped consistently in the past are
+ * predicted to be taps; otherwise a tap needs to be corroborated by timing -- either the other key following
+ * quickly, or the tapping key itself pressed in the middle of a typing streak.
+ */
+static bool speculation_predicts_tap(keyrecord_t *keyp) {
+    const uint16_t tapping_keycode = get_record_keycode(&tapping_key, false);
+    if (!speculation_enabled || !(IS_QK_MOD_TAP(tapping_keycode) || IS_QK_LAYER_TAP(tapping_keycode))) {
+        return false;
+    }
+    // Mod-tap and layer-tap share the position of the tap keycode
+    if (!is_retractable_keycode(QK_MOD_TAP_GET_TAP_KEYCODE(tapping_keycode)) || !is_retractable_keycode(get_record_keycode(keyp, false))) {
+        return false;
+    }
+#        ifdef SPECULATIVE_HOLD_TAP_PER_KEY
+    if (!get_speculative_hold_tap(tapping_keycode, &tapping_key)) {
+        return false;
+    }
+#        endif
+    const uint8_t history = *tap_history_entry(tapping_keycode);
+    if (history < 2) {
+        return false;
+    }
+    return history == 3 || tapping_key_in_streak || TIMER_DIFF_16(keyp->event.time, tapping_key.event.time) < SPECULATIVE_HOLD_TAP_TYPING_TERM;
+}
+
+/** \brief Resolve the tapping key as a tap ahead of time, and process the key which interrupted it
+ */
+static void speculation_start(keyrecord_t *keyp) {
+    tapping_key.tap.count = 1;
+    debug_tapping_key();
+    process_record(&tapping_key);
+
+    speculating           = true;
+    speculation_log_count = 0;
+    speculation_log_event(keyp);
+    process_record(keyp);
+}
+
+/** \brief Remember an event processed during speculation, so that it can be replayed if the tap is retracted
+ *
+ * Releases of keys pressed before the speculation aren't logged, as replaying them would release them twice.
+ * Returns false if the event can't be retracted.
+ */
+static bool speculation_log_event(keyrecord_t *keyp) {
+    if (IS_NOEVENT(keyp->event) || (!keyp->event.pressed && !speculation_logged_press(keyp->event))) {
+        return true;
+    }
+    if (speculation_log_count >= SPECULATIVE_HOLD_TAP_LOG_SIZE || (keyp->event.pressed && !is_retractable_keycode(get_record_keycode(keyp, false)))) {
+        return false;
+    }
+    speculation_log[speculation_log_count++] = *keyp;
+    return true;
+}
+
+static bool speculation_logged_press(keyevent_t event) {
+    for (uint8_t i = 0; i < speculation_log_count; i++) {
+        if (KEYEQ(speculation_log[i].event.key, event.key) && speculation_log[i].event.pressed) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** \brief Undo a speculative tap which turned out to be a hold
+ *
+ * Releases the tap and every key still held from the speculation, erases the characters typed with backspaces,
+ * then registers the hold and replays the logged events on top of it.
+ */
+static void speculation_retract(void) {
+    const uint16_t time    = timer_read();
+    uint8_t        presses = 1;
+
+    tapping_key_resolved(false);
+    process_record(&(keyrecord_t){
+        .tap           = tapping_key.tap,
+        .event.key     = tapping_key.event.key,
+        .event.time    = time,
+        .event.pressed = false,
+        .event.type    = tapping_key.event.type,
+#        ifdef COMBO_ENABLE
+        .keycode = tapping_key.keycode,
+#        endif
+    });
+    for (uint8_t i = 0; i < speculation_log_count; i++) {
+        if (!speculation_log[i].event.pressed) {
+            continue;
+        }
+        presses++;
+        bool held = true;
+        for (uint8_t j = i + 1; j < speculation_log_count; j++) {
+            if (KEYEQ(speculation_log[j].event.key, speculation_log[i].event.key)) {
+                held = speculation_log[j].event.pressed;
+                break;
+            }
+        }
+        if (held) {
+            keyrecord_t release   = speculation_log[i];
+            release.event.time    = time;
+            release.event.pressed = false;
+            process_record(&release);
+        }
+    }
+    for (uint8_t i = 0; i < presses; i++) {
+        tap_code(KC_BACKSPACE);
+    }
+
+    keyrecord_t hold = tapping_key;
+    hold.tap.count   = 0;
+    process_record(&hold);
+    tapping_key = (keyrecord_t){0};
+    speculating = false;
+    debug_tapping_key();
+
+    for (uint8_t i = 0; i < speculation_log_count; i++) {
+        process_record(&speculation_log[i]);
+    }
+}
+#    endif
+
 /** \brief Tapping key debug print
  *
  * FIXME: Needs docs
@@ -536,7 +906,7 @@ static void debug_tapping_key(void) {
  */
 static void debug_waiting_buffer(void) {
     ac_dprintf("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = waiting_buffer_next(i)) {
         ac_dprintf("[%u]=", i);
         debug_record(waiting_buffer[i]);
         ac_dprintf(" ");
@@ -32,12 +32,31 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define TAPPING_TOGGLE 5
 #endif
 
-#define WAITING_BUFFER_SIZE 8
+/* number of key events which can wait for a tapping key to be resolved */
+#ifndef WAITING_BUFFER_SIZE
+#    define WAITING_BUFFER_SIZE 8
+#endif
+
+#ifdef SPECULATIVE_HOLD_TAP
+/* period within which consecutive key presses are considered typing(ms) */
+#    ifndef SPECULATIVE_HOLD_TAP_TYPING_TERM
+#        define SPECULATIVE_HOLD_TAP_TYPING_TERM (TAPPING_TERM / 2)
+#    endif
+/* number of tap/hold history entries, shared between keycodes by hash */
+#    ifndef SPECULATIVE_HOLD_TAP_HISTORY_SIZE
+#        define SPECULATIVE_HOLD_TAP_HISTORY_SIZE 16
+#    endif
+/* number of events which can be retracted along with a speculative tap */
+#    ifndef SPECULATIVE_HOLD_TAP_LOG_SIZE
+#        define SPECULATIVE_HOLD_TAP_LOG_SIZE 8
+#    endif
+#endif
 
 #ifndef NO_ACTION_TAPPING
 uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache);
 uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache);
 void     action_tapping_process(keyrecord_t record);
+bool     action_tapping_next_deadline(uint32_t *deadline);
 #endif
 
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
@@ -45,12 +64,22 @@ uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record);
 bool     get_permissive_hold(uint16_t keycode, keyrecord_t *record);
 bool     get_retro_tapping(uint16_t keycode, keyrecord_t *record);
 bool     get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record);
+bool     get_speculative_hold_tap(uint16_t keycode, keyrecord_t *record);
+uint16_t get_adaptive_tapping_term(uint16_t keycode, keyrecord_t *record);
+
+#if defined(SPECULATIVE_HOLD_TAP) && !defined(NO_ACTION_TAPPING)
+void speculative_hold_tap_enable(bool enable);
+bool speculative_hold_tap_is_enabled(void);
+void speculative_hold_tap_clear_history(void);
+#endif
 
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
 extern uint16_t g_tapping_term;
 #endif
 
-#if defined(TAPPING_TERM_PER_KEY) && !defined(NO_ACTION_TAPPING)
+#if defined(ADAPTIVE_TAPPING_TERM_ENABLE) && !defined(NO_ACTION_TAPPING)
+#    define GET_TAPPING_TERM(keycode, record) get_adaptive_tapping_term(keycode, record)
+#elif defined(TAPPING_TERM_PER_KEY) && !defined(NO_ACTION_TAPPING)
 #    define GET_TAPPING_TERM(keycode, record) get_tapping_term(keycode, record)
 #elif defined(DYNAMIC_TAPPING_TERM_ENABLE) && !defined(NO_ACTION_TAPPING)
 #    define GET_TAPPING_TERM(keycode, record) g_tapping_term
@@ -301,7 +301,12 @@ void send_6kro_report(void) {
 
 #ifdef NKRO_ENABLE
 void send_nkro_report(void) {
+#    ifdef NKRO_AUTO
+    // Modifiers are carried by the 6KRO report
+    nkro_report->mods = 0;
+#    else
     nkro_report->mods = get_mods_for_report();
+#    endif
 
     static report_nkro_t last_report;
 
@@ -320,6 +325,10 @@ void send_nkro_report(void) {
 void send_keyboard_report(void) {
 #ifdef NKRO_ENABLE
     if (usb_device_state_get_protocol() == USB_PROTOCOL_REPORT && keymap_config.nkro) {
+#    ifdef NKRO_AUTO
+        // The NKRO report only holds the keys which didn't fit in the 6KRO one, and is left alone while it stays empty
+        send_6kro_report();
+#    endif
         send_nkro_report();
     } else {
         send_6kro_report();
@@ -19,6 +19,9 @@
 #include "wait.h"
 #include "eeconfig.h"
 #include "bootloader.h"
+#ifdef EEPROM_DRIVER
+#    include "eeprom_driver.h"
+#endif
 
 #ifndef BOOTMAGIC_DEBOUNCE
 #    if defined(DEBOUNCE) && DEBOUNCE > 0
@@ -68,6 +71,9 @@ __attribute__((weak)) void bootmagic_scan(void) {
 
     if (bootmagic_should_reset()) {
         bootmagic_reset_eeprom();
+#ifdef EEPROM_DRIVER
+        eeprom_driver_flush();
+#endif
 
         // Jump to bootloader.
         bootloader_jump();
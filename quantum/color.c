@@ -19,82 +19,50 @@
 #include "progmem.h"
 #include "util.h"
 
-rgb_t hsv_to_rgb_impl(hsv_t hsv, bool use_cie) {
-    rgb_t    rgb;
-    uint8_t  region, remainder, p, q, t;
-    uint16_t h, s, v;
+enum { CHANNEL_V, CHANNEL_P, CHANNEL_Q, CHANNEL_T };
 
-    if (hsv.s == 0) {
-#ifdef USE_CIE1931_CURVE
-        if (use_cie) {
-            rgb.r = rgb.g = rgb.b = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-        } else {
-            rgb.r = hsv.v;
-            rgb.g = hsv.v;
-            rgb.b = hsv.v;
-        }
-#else
-        rgb.r = hsv.v;
-        rgb.g = hsv.v;
-        rgb.b = hsv.v;
-#endif
-        return rgb;
-    }
+// Which of v, p, q and t make up red, green and blue in each sixth of the hue circle
+static const uint8_t hue_sector_channels[7][3] = {
+    {CHANNEL_V, CHANNEL_T, CHANNEL_P},
+    {CHANNEL_Q, CHANNEL_V, CHANNEL_P},
+    {CHANNEL_P, CHANNEL_V, CHANNEL_T},
+    {CHANNEL_P, CHANNEL_Q, CHANNEL_V},
+    {CHANNEL_T, CHANNEL_P, CHANNEL_V},
+    {CHANNEL_V, CHANNEL_P, CHANNEL_Q},
+    {CHANNEL_V, CHANNEL_T, CHANNEL_P}, // hue 255 only
+};
 
-    h = hsv.h;
-    s = hsv.s;
+static inline uint8_t hsv_to_rgb_value(uint8_t v, bool use_cie) {
 #ifdef USE_CIE1931_CURVE
     if (use_cie) {
-        v = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-    } else {
-        v = hsv.v;
+        return pgm_read_byte(&CIE1931_CURVE[v]);
     }
-#else
-    v = hsv.v;
 #endif
+    return v;
+}
 
-    region    = h * 6 / 255;
-    remainder = (h * 2 - region * 85) * 3;
+static inline rgb_t hsv_to_rgb_sector(uint8_t h, uint8_t s, uint8_t v) {
+    if (s == 0) {
+        return (rgb_t){v, v, v};
+    }
 
-    p = (v * (255 - s)) >> 8;
-    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
-    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+    // h * 6 / 255 without the division, exact for every hue
+    uint16_t h6        = h * 6;
+    uint8_t  region    = (h6 + (h6 >> 8) + 1) >> 8;
+    uint8_t  remainder = (h * 2 - region * 85) * 3;
+    uint8_t  channel[4];
 
-    switch (region) {
-        case 6:
-        case 0:
-            rgb.r = v;
-            rgb.g = t;
-            rgb.b = p;
-            break;
-        case 1:
-            rgb.r = q;
-            rgb.g = v;
-            rgb.b = p;
-            break;
-        case 2:
-            rgb.r = p;
-            rgb.g = v;
-            rgb.b = t;
-            break;
-        case 3:
-            rgb.r = p;
-            rgb.g = q;
-            rgb.b = v;
-            break;
-        case 4:
-            rgb.r = t;
-            rgb.g = p;
-            rgb.b = v;
-            break;
-        default:
-            rgb.r = v;
-            rgb.g = p;
-            rgb.b = q;
-            break;
-    }
+    channel[CHANNEL_V] = v;
+    channel[CHANNEL_P] = (v * (255 - s)) >> 8;
+    channel[CHANNEL_Q] = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    channel[CHANNEL_T] = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    const uint8_t *order = hue_sector_channels[region];
+    return (rgb_t){channel[order[0]], channel[order[1]], channel[order[2]]};
+}
 
-    return rgb;
+rgb_t hsv_to_rgb_impl(hsv_t hsv, bool use_cie) {
+    return hsv_to_rgb_sector(hsv.h, hsv.s, hsv_to_rgb_value(hsv.v, use_cie));
 }
 
 rgb_t hsv_to_rgb(hsv_t hsv) {
@@ -108,3 +76,9 @@ rgb_t hsv_to_rgb(hsv_t hsv) {
 rgb_t hsv_to_rgb_nocie(hsv_t hsv) {
     return hsv_to_rgb_impl(hsv, false);
 }
+
+void hsv_to_rgb_batch(const hsv_t *hsv, rgb_t *rgb, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        rgb[i] = hsv_to_rgb_sector(hsv[i].h, hsv[i].s, hsv_to_rgb_value(hsv[i].v, true));
+    }
+}
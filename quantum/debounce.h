@@ -19,3 +19,11 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 void debounce_init(uint8_t num_rows);
 
 void debounce_free(void);
+
+/**
+ * @brief Whether any key is still being debounced, so that debounce() needs calling again without a further change.
+ *
+ * @return true A change is pending, or a key is still locked out
+ * @return false Debouncing is idle
+ */
+bool debounce_active(void);
@@ -139,6 +139,10 @@ static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], u
     }
 }
 
+bool debounce_active(void) {
+    return counters_need_update;
+}
+
 #else
 #    include "none.c"
 #endif
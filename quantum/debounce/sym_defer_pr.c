@@ -30,6 +30,8 @@ static uint16_t last_time;
 static uint8_t* countdowns;
 // [row]
 static matrix_row_t* last_raw;
+// Whether any row is still counting down
+static bool debouncing;
 
 void debounce_init(uint8_t num_rows) {
     countdowns = (uint8_t*)calloc(num_rows, sizeof(uint8_t));
@@ -53,6 +55,7 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     bool    cooked_changed = false;
 
     uint8_t* countdown = countdowns;
+    debouncing         = false;
 
     for (uint8_t row = 0; row < num_rows; ++row, ++countdown) {
         matrix_row_t raw_row = raw[row];
@@ -67,11 +70,12 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
             cooked[row] = raw_row;
             *countdown  = 0;
         }
+        debouncing |= *countdown != 0;
     }
 
     return cooked_changed;
 }
 
 bool debounce_active(void) {
-    return true;
+    return debouncing;
 }
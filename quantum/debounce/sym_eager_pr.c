@@ -137,6 +137,10 @@ static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], ui
     }
 }
 
+bool debounce_active(void) {
+    return counters_need_update || matrix_need_update;
+}
+
 #else
 #    include "none.c"
 #endif
@@ -131,6 +131,7 @@ void DebounceTest::runDebounce(bool changed) {
 
     reset_access_counter();
 
+    bool active         = debounce_active();
     bool cooked_changed = debounce(raw_matrix_, cooked_matrix_, MATRIX_ROWS, changed);
 
     if (!std::equal(std::begin(input_matrix_), std::end(input_matrix_), std::begin(raw_matrix_))) {
@@ -141,6 +142,10 @@ void DebounceTest::runDebounce(bool changed) {
         FAIL() << "Fatal error: debounce() reported a wrong cooked matrix change result at " << strTime() << "\noutput_matrix: cooked_changed=" << cooked_changed << "\n" << strMatrix(output_matrix_) << "\ncooked_matrix:\n" << strMatrix(cooked_matrix_);
     }
 
+    if (cooked_changed && !changed && !active) {
+        FAIL() << "Fatal error: debounce() changed the cooked matrix without a raw change while reporting itself idle at " << strTime() << "\ncooked_matrix:\n" << strMatrix(cooked_matrix_);
+    }
+
     if (current_access_counter() > 1) {
         FAIL() << "Fatal error: debounce() read the timer multiple times, which is not allowed, at " << strTime() << "\ntimer: access_count=" << current_access_counter() << "\noutput_matrix: cooked_changed=" << cooked_changed << "\n" << strMatrix(output_matrix_) << "\ncooked_matrix:\n" << strMatrix(cooked_matrix_);
     }
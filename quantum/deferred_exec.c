@@ -9,110 +9,258 @@
 #    define MAX_DEFERRED_EXECUTORS 8
 #endif
 
+_Static_assert(MAX_DEFERRED_EXECUTORS <= DEFERRED_EXEC_MAX_TABLE_COUNT, "MAX_DEFERRED_EXECUTORS is too large");
+
+/*
+    Each table doubles as a binary min-heap ordered by trigger time, without
+    requiring any storage outside of the table itself:
+
+        - table[slot] holds the executor state for that slot, which never moves
+        - table[pos].heap_slot is the slot held at position `pos` in the heap
+        - table[slot].heap_index is the position of `slot` within the heap
+
+    Active executors occupy heap positions [0, n), and free slots occupy the
+    remaining positions, so the next free slot is always found at position n.
+    The soonest executor is always at position 0, so the background task only
+    needs to look at a single entry when nothing is due.
+
+    Tokens are allocated such that ((token - 1) % table_count) is the slot
+    holding the executor, so finding the executor for a token is O(1). They
+    are 16 bits wide, so a slot only hands out the same token again after
+    (65535 / table_count) reuses, and a stale token held by a caller doesn't
+    refer to an unrelated executor in the meantime.
+
+    Tables are zero-initialised by their owners, which leaves every position
+    claiming slot 0 -- a state that cannot otherwise occur -- and the heap is
+    lazily set up on first use.
+*/
+
 //------------------------------------
 // Helpers
 //
 
 static deferred_token current_token = 0;
 
-static inline bool token_can_be_used(deferred_executor_t *table, size_t table_count, deferred_token token) {
-    if (token == INVALID_DEFERRED_TOKEN) {
-        return false;
+static inline bool trigger_before(uint32_t a, uint32_t b) {
+    return ((int32_t)TIMER_DIFF_32(a, b)) < 0;
+}
+
+static inline void heap_ensure_initialised(deferred_executor_t *table, size_t table_count) {
+    if (table_count > 1 && table[0].heap_slot == 0 && table[1].heap_slot == 0) {
+        for (size_t i = 0; i < table_count; ++i) {
+            table[i].heap_slot  = i;
+            table[i].heap_index = i;
+        }
     }
-    for (int i = 0; i < table_count; ++i) {
-        if (table[i].token == token) {
-            return false;
+}
+
+static inline bool heap_position_active(deferred_executor_t *table, size_t pos) {
+    return table[table[pos].heap_slot].token != INVALID_DEFERRED_TOKEN;
+}
+
+static inline uint32_t heap_position_trigger(deferred_executor_t *table, size_t pos) {
+    return table[table[pos].heap_slot].trigger_time;
+}
+
+// Active executors are a prefix of the heap, so a binary search gives the count
+static size_t heap_count(deferred_executor_t *table, size_t table_count) {
+    size_t lo = 0, hi = table_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (heap_position_active(table, mid)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
-    return true;
+    return lo;
+}
+
+static inline void heap_swap(deferred_executor_t *table, size_t a, size_t b) {
+    uint8_t slot_a           = table[a].heap_slot;
+    uint8_t slot_b           = table[b].heap_slot;
+    table[a].heap_slot       = slot_b;
+    table[b].heap_slot       = slot_a;
+    table[slot_b].heap_index = a;
+    table[slot_a].heap_index = b;
+}
+
+static void heap_sift_up(deferred_executor_t *table, size_t pos) {
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!trigger_before(heap_position_trigger(table, pos), heap_position_trigger(table, parent))) {
+            break;
+        }
+        heap_swap(table, pos, parent);
+        pos = parent;
+    }
 }
 
-static inline deferred_token allocate_token(deferred_executor_t *table, size_t table_count) {
-    deferred_token first = ++current_token;
-    while (!token_can_be_used(table, table_count, current_token)) {
-        ++current_token;
-        if (current_token == first) {
-            // If we've looped back around to the first, everything is already allocated (yikes!). Need to exit with a failure.
-            return INVALID_DEFERRED_TOKEN;
+static void heap_sift_down(deferred_executor_t *table, size_t count, size_t pos) {
+    while (true) {
+        size_t smallest = pos;
+        size_t left     = 2 * pos + 1;
+        size_t right    = left + 1;
+        if (left < count && trigger_before(heap_position_trigger(table, left), heap_position_trigger(table, smallest))) {
+            smallest = left;
         }
+        if (right < count && trigger_before(heap_position_trigger(table, right), heap_position_trigger(table, smallest))) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        heap_swap(table, pos, smallest);
+        pos = smallest;
+    }
+}
+
+static void heap_remove(deferred_executor_t *table, size_t table_count, uint8_t slot) {
+    size_t count = heap_count(table, table_count);
+    size_t pos   = table[slot].heap_index;
+
+    // Move the slot to the end of the active region, then shrink the active region to exclude it
+    heap_swap(table, pos, count - 1);
+    deferred_executor_t *entry = &table[slot];
+    entry->token               = INVALID_DEFERRED_TOKEN;
+    entry->trigger_time        = 0;
+    entry->callback            = NULL;
+    entry->cb_arg              = NULL;
+
+    if (pos < count - 1) {
+        heap_sift_up(table, pos);
+        heap_sift_down(table, count - 1, pos);
     }
+}
+
+static inline deferred_token allocate_token(size_t table_count, uint8_t slot) {
+    // Next token after the last one handed out, which also maps onto the slot
+    uint32_t token = (uint32_t)current_token + 1;
+    token += (slot + table_count - ((token - 1) % table_count)) % table_count;
+    if (token > UINT16_MAX) {
+        token = slot + 1;
+    }
+    current_token = token;
     return current_token;
 }
 
+static inline deferred_executor_t *find_executor(deferred_executor_t *table, size_t table_count, deferred_token token) {
+    deferred_executor_t *entry = &table[(token - 1) % table_count];
+    return entry->token == token ? entry : NULL;
+}
+
+static inline bool table_valid(deferred_executor_t *table, size_t table_count) {
+    return table && table_count > 0 && table_count <= DEFERRED_EXEC_MAX_TABLE_COUNT;
+}
+
 //------------------------------------
 // Advanced API: used when a custom-allocated table is used, primarily for core code.
 //
 
 deferred_token defer_exec_advanced(deferred_executor_t *table, size_t table_count, uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
     // Ignore queueing if the table isn't valid, it's a zero-time delay, or the token is not valid
-    if (!table || table_count == 0 || delay_ms == 0 || !callback) {
+    if (!table_valid(table, table_count) || delay_ms == 0 || !callback) {
         return INVALID_DEFERRED_TOKEN;
     }
 
-    // Find an unused slot and claim it
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == INVALID_DEFERRED_TOKEN) {
-            // Work out the new token value, dropping out if none were available
-            deferred_token token = allocate_token(table, table_count);
-            if (token == INVALID_DEFERRED_TOKEN) {
-                return false;
-            }
+    heap_ensure_initialised(table, table_count);
 
-            // Set up the executor table entry
-            entry->token        = current_token;
-            entry->trigger_time = timer_read32() + delay_ms;
-            entry->callback     = callback;
-            entry->cb_arg       = cb_arg;
-            return current_token;
-        }
+    // The first free slot is immediately after the active executors
+    size_t count = heap_count(table, table_count);
+    if (count >= table_count) {
+        // None available
+        return INVALID_DEFERRED_TOKEN;
     }
 
-    // None available
-    return INVALID_DEFERRED_TOKEN;
+    // Set up the executor table entry
+    uint8_t              slot  = table[count].heap_slot;
+    deferred_executor_t *entry = &table[slot];
+    entry->token               = allocate_token(table_count, slot);
+    entry->trigger_time        = timer_read32() + delay_ms;
+    entry->callback            = callback;
+    entry->cb_arg              = cb_arg;
+    heap_sift_up(table, count);
+    return entry->token;
 }
 
 bool extend_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token, uint32_t delay_ms) {
     // Ignore queueing if the table isn't valid, it's a zero-time delay, or the token is not valid
-    if (!table || table_count == 0 || delay_ms == 0 || token == INVALID_DEFERRED_TOKEN) {
+    if (!table_valid(table, table_count) || delay_ms == 0 || token == INVALID_DEFERRED_TOKEN) {
         return false;
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, extend the delay
-            entry->trigger_time = timer_read32() + delay_ms;
-            return true;
-        }
+    deferred_executor_t *entry = find_executor(table, table_count, token);
+    if (!entry) {
+        // Not found
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, extend the delay
+    entry->trigger_time = timer_read32() + delay_ms;
+    heap_sift_up(table, entry->heap_index);
+    heap_sift_down(table, heap_count(table, table_count), entry->heap_index);
+    return true;
 }
 
 bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token) {
     // Ignore request if the table/token are not valid
-    if (!table || table_count == 0 || token == INVALID_DEFERRED_TOKEN) {
+    if (!table_valid(table, table_count) || token == INVALID_DEFERRED_TOKEN) {
         return false;
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, cancel and clear the table entry
-            entry->token        = INVALID_DEFERRED_TOKEN;
-            entry->trigger_time = 0;
-            entry->callback     = NULL;
-            entry->cb_arg       = NULL;
-            return true;
-        }
+    deferred_executor_t *entry = find_executor(table, table_count, token);
+    if (!entry) {
+        // Not found
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, cancel and clear the table entry
+    heap_remove(table, table_count, entry - table);
+    return true;
+}
+
+bool deferred_exec_advanced_next_deadline(deferred_executor_t *table, size_t table_count, uint32_t *deadline) {
+    if (!table_valid(table, table_count)) {
+        return false;
+    }
+
+    heap_ensure_initialised(table, table_count);
+    if (!heap_position_active(table, 0)) {
+        return false;
+    }
+
+    *deadline = heap_position_trigger(table, 0);
+    return true;
+}
+
+#define RAN_THIS_PASS(ran, slot) ((ran)[(slot) / 8] & (1 << ((slot) % 8)))
+
+// Soonest executor which is due and has not yet been invoked during this pass
+static deferred_executor_t *next_due_executor(deferred_executor_t *table, size_t table_count, uint32_t now, const uint8_t *ran) {
+    if (!heap_position_active(table, 0) || trigger_before(now, heap_position_trigger(table, 0))) {
+        return NULL;
+    }
+    uint8_t slot = table[0].heap_slot;
+    if (!RAN_THIS_PASS(ran, slot)) {
+        return &table[slot];
+    }
+
+    // The soonest has already run and is still behind, which only happens when overloaded -- fall back to a scan
+    deferred_executor_t *soonest = NULL;
+    size_t               count   = heap_count(table, table_count);
+    for (size_t pos = 1; pos < count; ++pos) {
+        slot                       = table[pos].heap_slot;
+        deferred_executor_t *entry = &table[slot];
+        if (RAN_THIS_PASS(ran, slot) || trigger_before(now, entry->trigger_time)) {
+            continue;
+        }
+        if (!soonest || trigger_before(entry->trigger_time, soonest->trigger_time)) {
+            soonest = entry;
+        }
+    }
+    return soonest;
 }
 
 void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count, uint32_t *last_execution_time) {
@@ -122,35 +270,38 @@ void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count,
     if (((int32_t)TIMER_DIFF_32(now, (*last_execution_time))) > 0) {
         *last_execution_time = now;
 
-        // Run through each of the executors
-        for (int i = 0; i < table_count; ++i) {
-            deferred_executor_t *entry      = &table[i];
-            deferred_token       curr_token = entry->token;
-
-            // Check if we're supposed to execute this entry
-            if (curr_token != INVALID_DEFERRED_TOKEN && ((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) <= 0) {
-                // Invoke the callback and work work out if we should be requeued
-                uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
-
-                // If the token has changed, then the callback has canceled and re-queued. Skip further processing.
-                if (entry->token != curr_token) {
-                    continue;
-                }
-
-                // Update the trigger time if we have to repeat, otherwise clear it out
-                if (delay_ms > 0) {
-                    // Intentionally add just the delay to the existing trigger time -- this ensures the next
-                    // invocation is with respect to the previous trigger, rather than when it got to execution. Under
-                    // normal circumstances this won't cause issue, but if another executor is invoked that takes a
-                    // considerable length of time, then this ensures best-effort timing between invocations.
-                    entry->trigger_time += delay_ms;
-                } else {
-                    // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
-                    entry->token        = INVALID_DEFERRED_TOKEN;
-                    entry->trigger_time = 0;
-                    entry->callback     = NULL;
-                    entry->cb_arg       = NULL;
-                }
+        if (!table_valid(table, table_count)) {
+            return;
+        }
+        heap_ensure_initialised(table, table_count);
+
+        // Run through each of the executors which are due, soonest first, invoking each at most once per pass
+        uint8_t              ran[(DEFERRED_EXEC_MAX_TABLE_COUNT + 7) / 8] = {0};
+        deferred_executor_t *entry;
+        while ((entry = next_due_executor(table, table_count, now, ran)) != NULL) {
+            uint8_t        slot       = entry - table;
+            deferred_token curr_token = entry->token;
+            ran[slot / 8] |= 1 << (slot % 8);
+
+            // Invoke the callback and work work out if we should be requeued
+            uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
+
+            // If the token has changed, then the callback has canceled and re-queued. Skip further processing.
+            if (entry->token != curr_token) {
+                continue;
+            }
+
+            // Update the trigger time if we have to repeat, otherwise clear it out
+            if (delay_ms > 0) {
+                // Intentionally add just the delay to the existing trigger time -- this ensures the next
+                // invocation is with respect to the previous trigger, rather than when it got to execution. Under
+                // normal circumstances this won't cause issue, but if another executor is invoked that takes a
+                // considerable length of time, then this ensures best-effort timing between invocations.
+                entry->trigger_time += delay_ms;
+                heap_sift_down(table, heap_count(table, table_count), entry->heap_index);
+            } else {
+                // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
+                heap_remove(table, table_count, slot);
             }
         }
     }
@@ -172,6 +323,9 @@ bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
 bool cancel_deferred_exec(deferred_token token) {
     return cancel_deferred_exec_advanced(basic_executors, MAX_DEFERRED_EXECUTORS, token);
 }
+bool deferred_exec_next_deadline(uint32_t *deadline) {
+    return deferred_exec_advanced_next_deadline(basic_executors, MAX_DEFERRED_EXECUTORS, deadline);
+}
 void deferred_exec_task(void) {
     deferred_exec_advanced_task(basic_executors, MAX_DEFERRED_EXECUTORS, &last_deferred_exec_check);
 }
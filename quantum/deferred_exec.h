@@ -14,13 +14,18 @@
 /**
  * @typedef A token that can be used to cancel or extend an existing deferred execution.
  */
-typedef uint8_t deferred_token;
+typedef uint16_t deferred_token;
 
 /**
  * @def The constant used to denote an invalid deferred execution token.
  */
 #define INVALID_DEFERRED_TOKEN 0
 
+/**
+ * @def The maximum number of executors in a single deferred execution table.
+ */
+#define DEFERRED_EXEC_MAX_TABLE_COUNT 255
+
 /**
  * @typedef Callback to execute.
  * @param trigger_time[in] the intended trigger time to execute the callback -- equivalent time-space as timer_read32()
@@ -60,6 +65,14 @@ bool extend_deferred_exec(deferred_token token, uint32_t delay_ms);
  */
 bool cancel_deferred_exec(deferred_token token);
 
+/**
+ * Retrieves the trigger time of the soonest pending deferred execution.
+ *
+ * @param deadline[out] the trigger time of the soonest deferred execution -- equivalent time-space as timer_read32()
+ * @return true if there is a pending deferred execution, otherwise false
+ */
+bool deferred_exec_next_deadline(uint32_t *deadline);
+
 /**
  * Forward declaration for the main loop in order to execute any deferred executors. Should not be invoked by keyboard/user code.
  */
@@ -72,10 +85,13 @@ void deferred_exec_task(void);
 /**
  * @struct Structure for containing self-hosted deferred executor tables.
  * @brief Core-side code can use this to create their own tables without impacting on the use of users' ability to add deferred execution.
- *        Code outside deferred_exec.c should not worry about internals of this struct, and should just allocate the required number in an array.
+ *        Code outside deferred_exec.c should not worry about internals of this struct, and should just allocate the required number in an array,
+ *        zero-initialised, of at most DEFERRED_EXEC_MAX_TABLE_COUNT entries.
  */
 typedef struct deferred_executor_t {
     deferred_token         token;
+    uint8_t                heap_slot;
+    uint8_t                heap_index;
     uint32_t               trigger_time;
     deferred_exec_callback callback;
     void *                 cb_arg;
@@ -110,6 +126,16 @@ bool extend_deferred_exec_advanced(deferred_executor_t *table, size_t table_coun
  */
 bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token);
 
+/**
+ * Retrieves the trigger time of the soonest pending deferred execution in a custom table.
+ *
+ * @param table[in] the custom table used for storage
+ * @param table_count[in] the number of available items in the table
+ * @param deadline[out] the trigger time of the soonest deferred execution -- equivalent time-space as timer_read32()
+ * @return true if there is a pending deferred execution, otherwise false
+ */
+bool deferred_exec_advanced_next_deadline(deferred_executor_t *table, size_t table_count, uint32_t *deadline);
+
 /**
  * Forward declaration for the main loop in order to execute any custom table deferred executors. Should not be invoked by keyboard/user code.
  * Needed for any custom-allocated deferred execution tables. Any core tasks should add appropriate invocation to quantum/main.c.
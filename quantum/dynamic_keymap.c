@@ -49,7 +49,13 @@
 #endif
 
 #ifndef DYNAMIC_KEYMAP_EEPROM_MAX_ADDR
-#    define DYNAMIC_KEYMAP_EEPROM_MAX_ADDR (TOTAL_EEPROM_BYTE_COUNT - 1)
+#    ifdef KV_STORE_ENABLE
+// Leave room for the key-value store region
+#        include "kv_store.h"
+#        define DYNAMIC_KEYMAP_EEPROM_MAX_ADDR (KV_STORE_EEPROM_ADDR - 1)
+#    else
+#        define DYNAMIC_KEYMAP_EEPROM_MAX_ADDR (TOTAL_EEPROM_BYTE_COUNT - 1)
+#    endif
 #endif
 
 #if DYNAMIC_KEYMAP_EEPROM_MAX_ADDR > (TOTAL_EEPROM_BYTE_COUNT - 1)
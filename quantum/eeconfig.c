@@ -12,6 +12,10 @@
 #    include "haptic.h"
 #endif
 
+#if defined(KV_STORE_ENABLE)
+#    include "kv_store.h"
+#endif
+
 #if defined(VIA_ENABLE)
 bool via_eeprom_is_valid(void);
 void via_eeprom_set_valid(bool valid);
@@ -74,6 +78,10 @@ void eeconfig_init_quantum(void) {
     eeconfig_init_user_datablock();
 #endif
 
+#if defined(KV_STORE_ENABLE)
+    kv_store_format();
+#endif
+
 #if defined(VIA_ENABLE)
     // Invalidate VIA eeprom config, and then reset.
     // Just in case if power is lost mid init, this makes sure that it pets
@@ -0,0 +1,147 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "event_trace.h"
+#include "timer.h"
+
+_Static_assert(EVENT_TRACE_BUFFER_SIZE <= UINT16_MAX, "EVENT_TRACE_BUFFER_SIZE must fit in 16 bits");
+_Static_assert(EVENT_TRACE_BUFFER_SIZE >= EVENT_TRACE_HEADER_SIZE + EVENT_TRACE_MAX_PAYLOAD, "EVENT_TRACE_BUFFER_SIZE must hold at least one record");
+
+static uint8_t  buffer[EVENT_TRACE_BUFFER_SIZE];
+static uint16_t tail        = 0;
+static uint16_t used        = 0;
+static uint16_t dropped     = 0;
+static uint16_t dump_offset = 0;
+static uint32_t last_time   = 0;
+static bool     has_last    = false;
+static bool     enabled     = true;
+
+static inline uint8_t peek(uint16_t offset) {
+    return buffer[(tail + offset) % EVENT_TRACE_BUFFER_SIZE];
+}
+
+static inline uint16_t record_size(uint16_t offset) {
+    return EVENT_TRACE_HEADER_SIZE + EVENT_TRACE_RECORD_PAYLOAD(peek(offset));
+}
+
+static void drop_oldest(void) {
+    uint16_t size = record_size(0);
+    tail          = (tail + size) % EVENT_TRACE_BUFFER_SIZE;
+    used -= size;
+    dump_offset = dump_offset > size ? dump_offset - size : 0;
+    if (dropped < UINT16_MAX) {
+        ++dropped;
+    }
+}
+
+static void push(uint8_t value) {
+    buffer[(tail + used) % EVENT_TRACE_BUFFER_SIZE] = value;
+    ++used;
+}
+
+static void record(uint8_t type, const uint8_t *payload, uint8_t length) {
+    if (!enabled) {
+        return;
+    }
+    if (length > EVENT_TRACE_MAX_PAYLOAD) {
+        length = EVENT_TRACE_MAX_PAYLOAD;
+    }
+
+    uint32_t now   = timer_read32();
+    uint32_t delta = has_last ? TIMER_DIFF_32(now, last_time) : 0;
+    if (delta > UINT16_MAX) {
+        delta = UINT16_MAX;
+    }
+    last_time = now;
+    has_last  = true;
+
+    while (EVENT_TRACE_BUFFER_SIZE - used < EVENT_TRACE_HEADER_SIZE + length) {
+        drop_oldest();
+    }
+    push(type << 4 | length);
+    push(delta & 0xFF);
+    push(delta >> 8);
+    for (uint8_t i = 0; i < length; ++i) {
+        push(payload[i]);
+    }
+}
+
+void event_trace_key(uint8_t row, uint8_t col, bool pressed) {
+    uint8_t payload[] = {row, col | (pressed ? EVENT_TRACE_KEY_PRESSED : 0)};
+    record(EVENT_TRACE_KEY, payload, sizeof(payload));
+}
+
+void event_trace_layer(uint32_t state) {
+    uint8_t payload[] = {state & 0xFF, (state >> 8) & 0xFF, (state >> 16) & 0xFF, state >> 24};
+    record(EVENT_TRACE_LAYER, payload, sizeof(payload));
+}
+
+void event_trace_keyboard_report(report_keyboard_t *report) {
+    uint8_t payload[EVENT_TRACE_MAX_PAYLOAD];
+    uint8_t length = 0;
+
+    payload[length++] = report->mods;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS && length < sizeof(payload); ++i) {
+        if (report->keys[i]) {
+            payload[length++] = report->keys[i];
+        }
+    }
+    record(EVENT_TRACE_REPORT, payload, length);
+}
+
+void event_trace_nkro_report(report_nkro_t *report) {
+#ifdef NKRO_ENABLE
+    uint8_t payload[EVENT_TRACE_MAX_PAYLOAD];
+    uint8_t length = 0;
+
+    payload[length++] = report->mods;
+    for (uint16_t code = 0; code < NKRO_REPORT_BITS * 8 && length < sizeof(payload); ++code) {
+        if (report->bits[code >> 3] & 1 << (code & 7)) {
+            payload[length++] = code;
+        }
+    }
+    record(EVENT_TRACE_REPORT, payload, length);
+#endif
+}
+
+void event_trace_enable(bool enable) {
+    enabled = enable;
+}
+
+bool event_trace_is_enabled(void) {
+    return enabled;
+}
+
+void event_trace_clear(void) {
+    tail        = 0;
+    used        = 0;
+    dropped     = 0;
+    dump_offset = 0;
+    has_last    = false;
+}
+
+uint16_t event_trace_size(void) {
+    return used;
+}
+
+uint16_t event_trace_dropped(void) {
+    return dropped;
+}
+
+void event_trace_dump_begin(void) {
+    dump_offset = 0;
+}
+
+uint8_t event_trace_dump(uint8_t *data, uint8_t length) {
+    uint8_t copied = 0;
+    while (dump_offset < used) {
+        uint16_t size = record_size(dump_offset);
+        if (copied + size > length) {
+            break;
+        }
+        for (uint16_t i = 0; i < size; ++i) {
+            data[copied++] = peek(dump_offset++);
+        }
+    }
+    return copied;
+}
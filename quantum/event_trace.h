@@ -0,0 +1,96 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "report.h"
+
+/**
+ * \file
+ *
+ * \defgroup event_trace Event trace
+ *
+ * \brief Records raw key events, layer changes and keyboard reports into a ring buffer, for offline replay.
+ *
+ * Every record starts with a header byte holding the record type in the upper nibble and the payload length in the
+ * lower nibble, followed by the milliseconds elapsed since the previous record as a little endian uint16_t (saturating),
+ * followed by the payload:
+ *
+ *   - EVENT_TRACE_KEY:    row, then column with bit 7 set if the key was pressed
+ *   - EVENT_TRACE_LAYER:  the new layer state as a little endian uint32_t
+ *   - EVENT_TRACE_REPORT: modifiers, then the keycodes held, in report order (truncated to fit)
+ *
+ * Once the buffer is full, the oldest records are discarded. The elapsed time of the oldest record is therefore
+ * meaningless, and should be ignored.
+ *
+ * \{
+ */
+
+/** \brief Size of the ring buffer in bytes
+ */
+#ifndef EVENT_TRACE_BUFFER_SIZE
+#    define EVENT_TRACE_BUFFER_SIZE 512
+#endif
+
+#define EVENT_TRACE_KEY 0x1
+#define EVENT_TRACE_LAYER 0x2
+#define EVENT_TRACE_REPORT 0x3
+
+#define EVENT_TRACE_HEADER_SIZE 3
+#define EVENT_TRACE_MAX_PAYLOAD 0xF
+#define EVENT_TRACE_KEY_PRESSED 0x80
+
+#define EVENT_TRACE_RECORD_TYPE(header) ((header) >> 4)
+#define EVENT_TRACE_RECORD_PAYLOAD(header) ((header) & 0xF)
+
+/** \brief Record a raw key event, as seen by the matrix scan
+ */
+void event_trace_key(uint8_t row, uint8_t col, bool pressed);
+
+/** \brief Record a change of the layer state
+ */
+void event_trace_layer(uint32_t state);
+
+/** \brief Record a keyboard report sent to the host
+ */
+void event_trace_keyboard_report(report_keyboard_t *report);
+
+/** \brief Record an NKRO report sent to the host, encoded like a keyboard report
+ */
+void event_trace_nkro_report(report_nkro_t *report);
+
+/** \brief Pause or resume recording, for example while the trace is dumped
+ */
+void event_trace_enable(bool enable);
+
+/** \brief Whether records are currently being recorded
+ */
+bool event_trace_is_enabled(void);
+
+/** \brief Discard all records
+ */
+void event_trace_clear(void);
+
+/** \brief Number of bytes currently held in the ring buffer
+ */
+uint16_t event_trace_size(void);
+
+/** \brief Number of records discarded to make room since the last clear
+ */
+uint16_t event_trace_dropped(void);
+
+/** \brief Restart dumping from the oldest record
+ */
+void event_trace_dump_begin(void);
+
+/** \brief Copy as many whole records as fit into a buffer, for example a raw HID report
+ *
+ * \param data[out] the buffer to fill
+ * \param length the size of the buffer
+ * \return the number of bytes copied, 0 once all records have been dumped
+ */
+uint8_t event_trace_dump(uint8_t *data, uint8_t length);
+
+/** \} */
@@ -16,15 +16,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
 #include "keycode_config.h"
 #include "matrix.h"
+#include "debounce.h"
 #include "keymap_introspection.h"
 #include "host.h"
 #include "led.h"
 #include "keycode.h"
 #include "timer.h"
 #include "sync_timer.h"
+#include "task_scheduler.h"
+#include "profiling.h"
 #include "print.h"
 #include "debug.h"
 #include "command.h"
@@ -32,6 +36,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "action_tapping.h"
 #ifdef BOOTMAGIC_ENABLE
 #    include "bootmagic.h"
 #endif
@@ -131,6 +136,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef LEADER_ENABLE
 #    include "leader.h"
 #endif
+#if defined(SEND_STRING_ENABLE) && defined(SENDSTRING_ASYNC)
+#    include "send_string.h"
+#endif
+#ifdef OUTPUT_QUEUE_ENABLE
+#    include "output_queue.h"
+#endif
+#ifdef RAW_HID_STREAM_ENABLE
+#    include "raw_hid_stream.h"
+#endif
 #ifdef UNICODE_COMMON_ENABLE
 #    include "unicode.h"
 #endif
@@ -143,6 +157,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef LAYER_LOCK_ENABLE
 #    include "layer_lock.h"
 #endif
+#ifdef KV_STORE_ENABLE
+#    include "kv_store.h"
+#endif
+#ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+#    include "process_adaptive_tapping_term.h"
+#endif
+#ifdef EVENT_TRACE_ENABLE
+#    include "event_trace.h"
+#endif
+#ifdef DEFERRED_EXEC_ENABLE
+#    include "deferred_exec.h"
+#endif
+#ifdef SPLIT_KEYBOARD
+#    include "transactions.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
@@ -185,6 +214,82 @@ void last_pointing_device_activity_trigger(void) {
     last_pointing_device_modification_time = last_input_modification_time = sync_timer_read32();
 }
 
+// Custom debounce implementations which do not report their state are assumed to be idle
+__attribute__((weak)) bool debounce_active(void) {
+    return false;
+}
+
+static bool debounce_next_deadline(uint32_t *deadline) {
+    // Keep scanning until the pending change has settled
+    if (!debounce_active()) {
+        return false;
+    }
+    *deadline = timer_read32();
+    return true;
+}
+
+static inline void fold_deadline(bool *found, uint32_t *soonest, bool (*source)(uint32_t *)) {
+    uint32_t deadline;
+    if (!source(&deadline)) {
+        return;
+    }
+    if (!*found || !timer_expired32(deadline, *soonest)) {
+        *soonest = deadline;
+    }
+    *found = true;
+}
+
+bool keyboard_next_deadline(uint32_t *deadline) {
+    bool     found   = false;
+    uint32_t soonest = 0;
+
+    fold_deadline(&found, &soonest, debounce_next_deadline);
+#ifndef NO_ACTION_TAPPING
+    fold_deadline(&found, &soonest, action_tapping_next_deadline);
+#endif
+#ifdef COMBO_ENABLE
+    fold_deadline(&found, &soonest, combo_next_deadline);
+#endif
+#ifdef LEADER_ENABLE
+    fold_deadline(&found, &soonest, leader_next_deadline);
+#endif
+#ifdef TAP_DANCE_ENABLE
+    fold_deadline(&found, &soonest, tap_dance_next_deadline);
+#endif
+#ifdef DEFERRED_EXEC_ENABLE
+    fold_deadline(&found, &soonest, deferred_exec_next_deadline);
+#endif
+#if defined(SEND_STRING_ENABLE) && defined(SENDSTRING_ASYNC)
+    fold_deadline(&found, &soonest, send_string_async_next_deadline);
+#endif
+#ifdef OUTPUT_QUEUE_ENABLE
+    fold_deadline(&found, &soonest, output_queue_next_deadline);
+#endif
+#ifdef RAW_HID_STREAM_ENABLE
+    fold_deadline(&found, &soonest, raw_hid_stream_next_deadline);
+#endif
+#ifdef MOUSEKEY_ENABLE
+    fold_deadline(&found, &soonest, mousekey_next_deadline);
+#endif
+#ifdef RGBLIGHT_ENABLE
+    fold_deadline(&found, &soonest, rgblight_next_deadline);
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    fold_deadline(&found, &soonest, rgb_matrix_next_deadline);
+#endif
+#ifdef LED_MATRIX_ENABLE
+    fold_deadline(&found, &soonest, led_matrix_next_deadline);
+#endif
+#ifdef SPLIT_KEYBOARD
+    fold_deadline(&found, &soonest, transactions_next_deadline);
+#endif
+
+    if (found) {
+        *deadline = soonest;
+    }
+    return found;
+}
+
 void set_activity_timestamps(uint32_t matrix_timestamp, uint32_t encoder_timestamp, uint32_t pointing_device_timestamp) {
     last_matrix_modification_time          = matrix_timestamp;
     last_encoder_modification_time         = encoder_timestamp;
@@ -388,6 +493,14 @@ void quantum_init(void) {
         eeconfig_init();
     }
 
+#ifdef KV_STORE_ENABLE
+    kv_store_init();
+#endif
+
+#ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+    adaptive_tapping_term_init();
+#endif
+
     /* init globals */
     debug_config.raw  = eeconfig_read_debug();
     keymap_config.raw = eeconfig_read_keymap();
@@ -538,7 +651,7 @@ static bool matrix_task(void) {
 
     static matrix_row_t matrix_previous[MATRIX_ROWS];
 
-    matrix_scan();
+    PROFILE_ZONE("matrix_scan", matrix_scan());
     bool matrix_changed = false;
     for (uint8_t row = 0; row < MATRIX_ROWS && !matrix_changed; row++) {
         matrix_changed |= matrix_previous[row] ^ matrix_get_row(row);
@@ -571,8 +684,12 @@ static bool matrix_task(void) {
             if (row_changes & col_mask) {
                 const bool key_pressed = current_row & col_mask;
 
+#ifdef EVENT_TRACE_ENABLE
+                event_trace_key(row, col, key_pressed);
+#endif
+
                 if (process_keypress) {
-                    action_exec(MAKE_KEYEVENT(row, col, key_pressed));
+                    PROFILE_ZONE("action_exec", action_exec(MAKE_KEYEVENT(row, col, key_pressed)));
                 }
 
                 switch_events(row, col, key_pressed);
@@ -627,6 +744,14 @@ void quantum_task(void) {
     sequencer_task();
 #endif
 
+#if defined(SEND_STRING_ENABLE) && defined(SENDSTRING_ASYNC)
+    send_string_task();
+#endif
+
+#ifdef OUTPUT_QUEUE_ENABLE
+    output_queue_task();
+#endif
+
 #ifdef TAP_DANCE_ENABLE
     tap_dance_task();
 #endif
@@ -662,97 +787,201 @@ void quantum_task(void) {
 #ifdef LAYER_LOCK_ENABLE
     layer_lock_task();
 #endif
+
+#ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+    adaptive_tapping_term_task();
+#endif
 }
 
-/** \brief Main task that is repeatedly called as fast as possible. */
-void keyboard_task(void) {
-    __attribute__((unused)) bool activity_has_occurred = false;
+static bool activity_has_occurred = false;
+
+static void keyboard_matrix_task(void) {
     if (matrix_task()) {
         last_matrix_activity_trigger();
         activity_has_occurred = true;
     }
-
-    quantum_task();
-
-#if defined(SPLIT_WATCHDOG_ENABLE)
-    split_watchdog_task();
-#endif
-
-#if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
-#endif
-
-#ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
-#endif
-#ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
-#endif
-
-#if defined(BACKLIGHT_ENABLE)
-#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
-    backlight_task();
-#    endif
-#endif
+}
 
 #ifdef ENCODER_ENABLE
+static void keyboard_encoder_task(void) {
     if (encoder_task()) {
         last_encoder_activity_trigger();
         activity_has_occurred = true;
     }
+}
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
+static void keyboard_pointing_device_task(void) {
     if (pointing_device_task()) {
         last_pointing_device_activity_trigger();
         activity_has_occurred = true;
     }
+}
 #endif
 
 #ifdef OLED_ENABLE
+static void keyboard_oled_task(void) {
     oled_task();
 #    if OLED_TIMEOUT > 0
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) oled_on();
 #    endif
+}
 #endif
 
 #ifdef ST7565_ENABLE
+static void keyboard_st7565_task(void) {
     st7565_task();
 #    if ST7565_TIMEOUT > 0
     // Wake up display if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) st7565_on();
 #    endif
+}
+#endif
+
+/*
+    Registry of tasks run by keyboard_task(), in order. Input handling and
+    reporting are critical and always run first; lighting and displays are
+    cosmetic, and may be rate limited through the TASK_PERIOD_xxx and
+    TASK_BUDGET_xxx defines, or deferred when TASK_SCHEDULER_LOOP_BUDGET_US is
+    set and a loop runs long.
+*/
+#ifndef TASK_PERIOD_RGBLIGHT
+#    define TASK_PERIOD_RGBLIGHT 0
+#endif
+#ifndef TASK_BUDGET_RGBLIGHT
+#    define TASK_BUDGET_RGBLIGHT 0
+#endif
+#ifndef TASK_PERIOD_LED_MATRIX
+#    define TASK_PERIOD_LED_MATRIX 0
+#endif
+#ifndef TASK_BUDGET_LED_MATRIX
+#    define TASK_BUDGET_LED_MATRIX 0
+#endif
+#ifndef TASK_PERIOD_RGB_MATRIX
+#    define TASK_PERIOD_RGB_MATRIX 0
+#endif
+#ifndef TASK_BUDGET_RGB_MATRIX
+#    define TASK_BUDGET_RGB_MATRIX 0
+#endif
+#ifndef TASK_PERIOD_BACKLIGHT
+#    define TASK_PERIOD_BACKLIGHT 0
+#endif
+#ifndef TASK_BUDGET_BACKLIGHT
+#    define TASK_BUDGET_BACKLIGHT 0
+#endif
+#ifndef TASK_PERIOD_OLED
+#    define TASK_PERIOD_OLED 0
+#endif
+#ifndef TASK_BUDGET_OLED
+#    define TASK_BUDGET_OLED 0
+#endif
+#ifndef TASK_PERIOD_ST7565
+#    define TASK_PERIOD_ST7565 0
+#endif
+#ifndef TASK_BUDGET_ST7565
+#    define TASK_BUDGET_ST7565 0
+#endif
+#ifndef TASK_PERIOD_HAPTIC
+#    define TASK_PERIOD_HAPTIC 0
+#endif
+#ifndef TASK_BUDGET_HAPTIC
+#    define TASK_BUDGET_HAPTIC 0
 #endif
 
+static const task_descriptor_t keyboard_tasks[] = {
+    TASK_DESCRIPTOR(keyboard_matrix_task, TASK_PRIORITY_CRITICAL, 0, 0),
+    TASK_DESCRIPTOR(quantum_task, TASK_PRIORITY_CRITICAL, 0, 0),
+    // Input and reporting tasks run before the rest, so that a long-running task never delays them
+#ifdef ENCODER_ENABLE
+    TASK_DESCRIPTOR(keyboard_encoder_task, TASK_PRIORITY_CRITICAL, 0, 0),
+#endif
+#ifdef POINTING_DEVICE_ENABLE
+    TASK_DESCRIPTOR(keyboard_pointing_device_task, TASK_PRIORITY_CRITICAL, 0, 0),
+#endif
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
-    mousekey_task();
+    TASK_DESCRIPTOR(mousekey_task, TASK_PRIORITY_CRITICAL, 0, 0),
 #endif
-
 #ifdef PS2_MOUSE_ENABLE
-    ps2_mouse_task();
+    TASK_DESCRIPTOR(ps2_mouse_task, TASK_PRIORITY_CRITICAL, 0, 0),
 #endif
-
 #ifdef MIDI_ENABLE
-    midi_task();
+    TASK_DESCRIPTOR(midi_task, TASK_PRIORITY_CRITICAL, 0, 0),
 #endif
-
 #ifdef JOYSTICK_ENABLE
-    joystick_task();
+    TASK_DESCRIPTOR(joystick_task, TASK_PRIORITY_CRITICAL, 0, 0),
 #endif
-
 #ifdef BLUETOOTH_ENABLE
-    bluetooth_task();
+    TASK_DESCRIPTOR(bluetooth_task, TASK_PRIORITY_CRITICAL, 0, 0),
+#endif
+#if defined(SPLIT_WATCHDOG_ENABLE)
+    TASK_DESCRIPTOR(split_watchdog_task, TASK_PRIORITY_NORMAL, 0, 0),
+#endif
+#if defined(RGBLIGHT_ENABLE)
+    TASK_DESCRIPTOR(rgblight_task, TASK_PRIORITY_COSMETIC, TASK_PERIOD_RGBLIGHT, TASK_BUDGET_RGBLIGHT),
+#endif
+#ifdef LED_MATRIX_ENABLE
+    TASK_DESCRIPTOR(led_matrix_task, TASK_PRIORITY_COSMETIC, TASK_PERIOD_LED_MATRIX, TASK_BUDGET_LED_MATRIX),
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    TASK_DESCRIPTOR(rgb_matrix_task, TASK_PRIORITY_COSMETIC, TASK_PERIOD_RGB_MATRIX, TASK_BUDGET_RGB_MATRIX),
+#endif
+#if defined(BACKLIGHT_ENABLE)
+#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
+    TASK_DESCRIPTOR(backlight_task, TASK_PRIORITY_COSMETIC, TASK_PERIOD_BACKLIGHT, TASK_BUDGET_BACKLIGHT),
+#    endif
+#endif
+#ifdef OLED_ENABLE
+    TASK_DESCRIPTOR(keyboard_oled_task, TASK_PRIORITY_COSMETIC, TASK_PERIOD_OLED, TASK_BUDGET_OLED),
+#endif
+#ifdef ST7565_ENABLE
+    TASK_DESCRIPTOR(keyboard_st7565_task, TASK_PRIORITY_COSMETIC, TASK_PERIOD_ST7565, TASK_BUDGET_ST7565),
 #endif
-
 #ifdef HAPTIC_ENABLE
-    haptic_task();
+    TASK_DESCRIPTOR(haptic_task, TASK_PRIORITY_NORMAL, TASK_PERIOD_HAPTIC, TASK_BUDGET_HAPTIC),
+#endif
+    TASK_DESCRIPTOR(led_task, TASK_PRIORITY_NORMAL, 0, 0),
+#ifdef EEPROM_DRIVER
+    TASK_DESCRIPTOR(eeprom_driver_task, TASK_PRIORITY_NORMAL, 0, 0),
+#endif
+#ifdef OS_DETECTION_ENABLE
+    TASK_DESCRIPTOR(os_detection_task, TASK_PRIORITY_NORMAL, 0, 0),
 #endif
+#ifdef RAW_HID_STREAM_ENABLE
+    TASK_DESCRIPTOR(raw_hid_stream_task, TASK_PRIORITY_NORMAL, 0, 0),
+#endif
+};
 
-    led_task();
+static task_state_t keyboard_task_states[ARRAY_SIZE(keyboard_tasks)];
 
-#ifdef OS_DETECTION_ENABLE
-    os_detection_task();
+#ifdef TASK_SCHEDULER_STATISTICS
+uint8_t keyboard_task_count(void) {
+    return ARRAY_SIZE(keyboard_tasks);
+}
+
+const char *keyboard_task_name(uint8_t index) {
+    return index < ARRAY_SIZE(keyboard_tasks) ? keyboard_tasks[index].name : NULL;
+}
+
+const task_statistics_t *keyboard_task_statistics(uint8_t index) {
+    return index < ARRAY_SIZE(keyboard_tasks) ? &keyboard_task_states[index].stats : NULL;
+}
+
+void keyboard_task_statistics_reset(void) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(keyboard_tasks); ++i) {
+        memset(&keyboard_task_states[i].stats, 0, sizeof(task_statistics_t));
+    }
+}
+
+void keyboard_task_print_statistics(void) {
+    task_scheduler_print_statistics(keyboard_tasks, keyboard_task_states, ARRAY_SIZE(keyboard_tasks));
+}
 #endif
+
+/** \brief Main task that is repeatedly called as fast as possible. */
+void keyboard_task(void) {
+    activity_has_occurred = false;
+    task_scheduler_run(keyboard_tasks, keyboard_task_states, ARRAY_SIZE(keyboard_tasks));
 }
@@ -139,6 +139,18 @@ void set_activity_timestamps(uint32_t matrix_timestamp, uint32_t encoder_timesta
 
 uint32_t get_matrix_scan_rate(void);
 
+bool keyboard_next_deadline(uint32_t *deadline); // Soonest deadline of debounce, the tapping state machine, combos, leader, tap dance, deferred executions, mouse keys, RGB Light, RGB/LED Matrix and split sync
+
+#ifdef TASK_SCHEDULER_STATISTICS
+#    include "task_scheduler.h"
+
+uint8_t                  keyboard_task_count(void);                // Number of tasks run by keyboard_task()
+const char              *keyboard_task_name(uint8_t index);        // Name of a task run by keyboard_task()
+const task_statistics_t *keyboard_task_statistics(uint8_t index);  // Runtime statistics of a task run by keyboard_task()
+void                     keyboard_task_statistics_reset(void);     // Clear the runtime statistics of all tasks
+void                     keyboard_task_print_statistics(void);     // Print the runtime statistics of all tasks to the console
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,226 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "eeprom.h"
+#include "kv_store.h"
+#include "util.h"
+
+/*
+    The region starts with a header identifying it, so that leftover bytes from
+    older firmware or a reassigned area of EEPROM are not parsed as records:
+
+        ╔═════════╦═════════╦════════════════╗
+        ║ Magic 0 ║ Magic 1 ║ Layout version ║
+        ╚═════════╩═════════╩════════════════╝
+
+    If the header does not match, the region is formatted during init.
+
+    Record layout within the region, following the header:
+
+        ╔════════╦═════════╦════════╦══════════════════╗
+        ║   ID   ║ Version ║ Length ║ Data (Length)... ║
+        ╚════════╩═════════╩════════╩══════════════════╝
+
+    An ID of 0x00 or 0xFF marks the end of the records, catering for both zero-
+    and 0xFF-erased storage. An ID of KV_STORE_ID_DELETED marks a record that
+    has been removed or superseded. If the same ID is present more than once
+    (e.g. power loss during relocation), the last occurrence wins.
+
+    Compaction only occurs when a relocated or new record does not fit, and is
+    not protected against power loss. Neither are updates in place, as the data
+    and version are written byte by byte over the old copy.
+*/
+
+#define KV_STORE_ID_END 0x00
+#define KV_STORE_ID_ERASED 0xFF
+#define KV_STORE_ID_DELETED 0xFE
+#define KV_STORE_OFFSET_INVALID 0xFFFF
+
+#define KV_STORE_MAGIC_0 'K'
+#define KV_STORE_MAGIC_1 'V'
+#define KV_STORE_LAYOUT_VERSION 1
+
+_Static_assert(KV_STORE_MAX_ID < KV_STORE_ID_DELETED, "KV_STORE_MAX_ID overlaps reserved IDs");
+_Static_assert((KV_STORE_EEPROM_SIZE) > KV_STORE_REGION_HEADER_SIZE + KV_STORE_RECORD_HEADER_SIZE, "KV_STORE_EEPROM_SIZE is too small");
+_Static_assert((KV_STORE_EEPROM_SIZE) <= 0xFFFF, "KV_STORE_EEPROM_SIZE must be less than 65536");
+_Static_assert((KV_STORE_EEPROM_ADDR) + (KV_STORE_EEPROM_SIZE) <= (TOTAL_EEPROM_BYTE_COUNT), "KV store region does not fit in EEPROM");
+
+// Offset of each record's header within the region, indexed by ID-1
+static uint16_t kv_offsets[KV_STORE_MAX_ID];
+// Offset of the end of the last record within the region
+static uint16_t kv_end;
+
+#define KV_STORE_ADDR(offset) ((uint8_t *)(uintptr_t)((KV_STORE_EEPROM_ADDR) + (offset)))
+
+static inline bool kv_store_id_valid(uint8_t id) {
+    return id > 0 && id <= (KV_STORE_MAX_ID);
+}
+
+static inline uint8_t kv_store_length_at(uint16_t offset) {
+    return eeprom_read_byte(KV_STORE_ADDR(offset + 2));
+}
+
+static void kv_store_mark_end(void) {
+    if (kv_end < (KV_STORE_EEPROM_SIZE)) {
+        eeprom_update_byte(KV_STORE_ADDR(kv_end), KV_STORE_ID_END);
+    }
+}
+
+/**
+ * Moves all live records to the start of the region, dropping deleted and superseded records.
+ */
+static void kv_store_compact(void) {
+    uint16_t read  = KV_STORE_REGION_HEADER_SIZE;
+    uint16_t write = KV_STORE_REGION_HEADER_SIZE;
+    while (read < kv_end) {
+        uint8_t  id     = eeprom_read_byte(KV_STORE_ADDR(read));
+        uint16_t length = KV_STORE_RECORD_HEADER_SIZE + kv_store_length_at(read);
+        if (kv_store_id_valid(id) && kv_offsets[id - 1] == read) {
+            if (write != read) {
+                // Destination is always before the source, so copying forwards in chunks is safe
+                uint8_t buf[32];
+                for (uint16_t i = 0; i < length; i += sizeof(buf)) {
+                    uint16_t n = MIN(sizeof(buf), length - i);
+                    eeprom_read_block(buf, KV_STORE_ADDR(read + i), n);
+                    eeprom_update_block(buf, KV_STORE_ADDR(write + i), n);
+                }
+                kv_offsets[id - 1] = write;
+            }
+            write += length;
+        }
+        read += length;
+    }
+    kv_end = write;
+    kv_store_mark_end();
+}
+
+static const uint8_t kv_store_region_header[KV_STORE_REGION_HEADER_SIZE] = {KV_STORE_MAGIC_0, KV_STORE_MAGIC_1, KV_STORE_LAYOUT_VERSION};
+
+void kv_store_init(void) {
+    uint8_t header[KV_STORE_REGION_HEADER_SIZE];
+    eeprom_read_block(header, KV_STORE_ADDR(0), sizeof(header));
+    if (memcmp(header, kv_store_region_header, sizeof(header)) != 0) {
+        // Never formatted, or holding data from something else
+        kv_store_format();
+        return;
+    }
+
+    memset(kv_offsets, 0xFF, sizeof(kv_offsets));
+    uint16_t offset = KV_STORE_REGION_HEADER_SIZE;
+    while (offset + KV_STORE_RECORD_HEADER_SIZE <= (KV_STORE_EEPROM_SIZE)) {
+        uint8_t id = eeprom_read_byte(KV_STORE_ADDR(offset));
+        if (id == KV_STORE_ID_END || id == KV_STORE_ID_ERASED) {
+            break;
+        }
+        uint16_t length = KV_STORE_RECORD_HEADER_SIZE + kv_store_length_at(offset);
+        if (offset + length > (KV_STORE_EEPROM_SIZE)) {
+            // Truncated record, treat as the end of the region
+            break;
+        }
+        if (kv_store_id_valid(id)) {
+            if (kv_offsets[id - 1] != KV_STORE_OFFSET_INVALID) {
+                // Superseded record left behind by an interrupted relocation
+                eeprom_update_byte(KV_STORE_ADDR(kv_offsets[id - 1]), KV_STORE_ID_DELETED);
+            }
+            kv_offsets[id - 1] = offset;
+        }
+        offset += length;
+    }
+    kv_end = offset;
+}
+
+void kv_store_format(void) {
+    memset(kv_offsets, 0xFF, sizeof(kv_offsets));
+    kv_end = KV_STORE_REGION_HEADER_SIZE;
+    kv_store_mark_end();
+    // Written last, so that an interrupted format is redone on the next boot
+    eeprom_update_block(kv_store_region_header, KV_STORE_ADDR(0), sizeof(kv_store_region_header));
+}
+
+bool kv_store_exists(uint8_t id) {
+    return kv_store_id_valid(id) && kv_offsets[id - 1] != KV_STORE_OFFSET_INVALID;
+}
+
+bool kv_store_read(uint8_t id, uint8_t version, void *data, uint8_t length) {
+    if (!kv_store_exists(id)) {
+        return false;
+    }
+    uint16_t offset = kv_offsets[id - 1];
+    uint8_t  header[KV_STORE_RECORD_HEADER_SIZE];
+    eeprom_read_block(header, KV_STORE_ADDR(offset), sizeof(header));
+    if (header[1] != version || header[2] != length) {
+        return false;
+    }
+    eeprom_read_block(data, KV_STORE_ADDR(offset + KV_STORE_RECORD_HEADER_SIZE), length);
+    return true;
+}
+
+bool kv_store_write(uint8_t id, uint8_t version, const void *data, uint8_t length) {
+    if (!kv_store_id_valid(id)) {
+        return false;
+    }
+
+    uint16_t existing = kv_offsets[id - 1];
+    if (existing != KV_STORE_OFFSET_INVALID && kv_store_length_at(existing) == length) {
+        // Same size, update in place -- only changed bytes hit the EEPROM, but a mix of old and new survives power loss
+        eeprom_update_block(data, KV_STORE_ADDR(existing + KV_STORE_RECORD_HEADER_SIZE), length);
+        eeprom_update_byte(KV_STORE_ADDR(existing + 1), version);
+        return true;
+    }
+
+    uint16_t required = KV_STORE_RECORD_HEADER_SIZE + length;
+    if (kv_end + required > (KV_STORE_EEPROM_SIZE)) {
+        kv_store_compact();
+        uint16_t end = kv_end;
+        if (existing != KV_STORE_OFFSET_INVALID) {
+            // The old copy of this record is about to be superseded, so its space can be reclaimed too
+            existing = kv_offsets[id - 1];
+            if (existing + KV_STORE_RECORD_HEADER_SIZE + kv_store_length_at(existing) == kv_end) {
+                end = existing;
+            }
+        }
+        if (end + required > (KV_STORE_EEPROM_SIZE)) {
+            // Nothing has been dropped yet, so the old copy is still there to read
+            return false;
+        }
+        if (end != kv_end) {
+            kv_end             = end;
+            kv_offsets[id - 1] = KV_STORE_OFFSET_INVALID;
+            existing           = KV_STORE_OFFSET_INVALID;
+            kv_store_mark_end();
+        }
+    }
+
+    // Write the data before the header, so that the record only becomes visible once complete
+    uint16_t offset                              = kv_end;
+    uint8_t  header[KV_STORE_RECORD_HEADER_SIZE] = {id, version, length};
+    eeprom_update_block(data, KV_STORE_ADDR(offset + KV_STORE_RECORD_HEADER_SIZE), length);
+    kv_end = offset + required;
+    kv_store_mark_end();
+    eeprom_update_block(header, KV_STORE_ADDR(offset), sizeof(header));
+
+    if (existing != KV_STORE_OFFSET_INVALID) {
+        eeprom_update_byte(KV_STORE_ADDR(existing), KV_STORE_ID_DELETED);
+    }
+    kv_offsets[id - 1] = offset;
+    return true;
+}
+
+void kv_store_delete(uint8_t id) {
+    if (!kv_store_exists(id)) {
+        return;
+    }
+    eeprom_update_byte(KV_STORE_ADDR(kv_offsets[id - 1]), KV_STORE_ID_DELETED);
+    kv_offsets[id - 1] = KV_STORE_OFFSET_INVALID;
+}
+
+uint16_t kv_store_used_space(void) {
+    uint16_t used = 0;
+    for (uint8_t i = 0; i < (KV_STORE_MAX_ID); ++i) {
+        if (kv_offsets[i] != KV_STORE_OFFSET_INVALID) {
+            used += KV_STORE_RECORD_HEADER_SIZE + kv_store_length_at(kv_offsets[i]);
+        }
+    }
+    return used;
+}
@@ -0,0 +1,86 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \defgroup kv_store Key-Value Store API
+ *
+ * \brief Versioned configuration records stored by ID rather than by fixed EEPROM address.
+ *
+ * Records are packed into a dedicated region of EEPROM, and located by scanning the region at startup. Updating a
+ * record with the same length rewrites only that record in place, so on wear-leveling backed EEPROM only the changed
+ * record is appended to the write log. Changing the length of a record relocates it to the end of the region, and
+ * the region is compacted when it runs out of space.
+ *
+ * \{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef KV_STORE_EEPROM_SIZE
+#    define KV_STORE_EEPROM_SIZE 256
+#endif
+
+#ifndef KV_STORE_EEPROM_ADDR
+#    define KV_STORE_EEPROM_ADDR ((TOTAL_EEPROM_BYTE_COUNT) - (KV_STORE_EEPROM_SIZE))
+#endif
+
+/** \brief Highest record ID available, IDs start at 1
+ */
+#ifndef KV_STORE_MAX_ID
+#    define KV_STORE_MAX_ID 32
+#endif
+
+/** \brief Size of the header stored in front of each record: ID, version and length
+ */
+#define KV_STORE_RECORD_HEADER_SIZE 3
+
+/** \brief Size of the header identifying the region, stored in front of the first record
+ */
+#define KV_STORE_REGION_HEADER_SIZE 3
+
+/** \brief Scan the EEPROM region and build the record index
+ */
+void kv_store_init(void);
+
+/** \brief Clear all records
+ */
+void kv_store_format(void);
+
+/** \brief Read a record
+ *
+ * \param id the record ID, 1..KV_STORE_MAX_ID
+ * \param version the expected version of the record
+ * \param[out] data buffer to receive the record
+ * \param length the expected length of the record
+ * \return true if the record exists with a matching version and length, false if the caller should use defaults
+ */
+bool kv_store_read(uint8_t id, uint8_t version, void *data, uint8_t length);
+
+/** \brief Write a record, only touching EEPROM if the contents have changed
+ *
+ * \param id the record ID, 1..KV_STORE_MAX_ID
+ * \param version the version of the record
+ * \param data the record contents
+ * \param length the length of the record
+ * \return true if the record was stored, false if there was insufficient space
+ */
+bool kv_store_write(uint8_t id, uint8_t version, const void *data, uint8_t length);
+
+/** \brief Remove a record
+ */
+void kv_store_delete(uint8_t id);
+
+/** \brief Query whether a record exists, regardless of version
+ */
+bool kv_store_exists(uint8_t id);
+
+/** \brief Number of bytes of the region in use by live records, including headers
+ */
+uint16_t kv_store_used_space(void);
+
+/** \} */
@@ -0,0 +1,242 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "backing_mocks.hpp"
+
+extern "C" {
+#include "eeprom.h"
+#include "eeprom_driver.h"
+#include "kv_store.h"
+}
+
+class KvStore : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        eeprom_driver_init();
+        eeprom_driver_erase();
+        kv_store_init();
+    }
+
+    // Simulates a reboot
+    void reinit(void) {
+        eeprom_driver_init();
+        kv_store_init();
+    }
+};
+
+TEST_F(KvStore, EmptyStore_ReadFails) {
+    uint32_t value = 0x12345678;
+    EXPECT_FALSE(kv_store_exists(1));
+    EXPECT_FALSE(kv_store_read(1, 0, &value, sizeof(value)));
+    EXPECT_EQ(value, 0x12345678);
+    EXPECT_EQ(kv_store_used_space(), 0);
+}
+
+TEST_F(KvStore, InvalidId_Rejected) {
+    uint8_t value = 1;
+    EXPECT_FALSE(kv_store_write(0, 0, &value, sizeof(value)));
+    EXPECT_FALSE(kv_store_write(KV_STORE_MAX_ID + 1, 0, &value, sizeof(value)));
+    EXPECT_FALSE(kv_store_read(0, 0, &value, sizeof(value)));
+}
+
+TEST_F(KvStore, WriteRead_SurvivesReboot) {
+    uint32_t a = 0xDEADBEEF;
+    uint16_t b = 0x1234;
+    EXPECT_TRUE(kv_store_write(5, 1, &a, sizeof(a)));
+    EXPECT_TRUE(kv_store_write(2, 3, &b, sizeof(b)));
+
+    reinit();
+
+    uint32_t ra = 0;
+    uint16_t rb = 0;
+    EXPECT_TRUE(kv_store_read(5, 1, &ra, sizeof(ra)));
+    EXPECT_TRUE(kv_store_read(2, 3, &rb, sizeof(rb)));
+    EXPECT_EQ(ra, a);
+    EXPECT_EQ(rb, b);
+    EXPECT_EQ(kv_store_used_space(), 2 * KV_STORE_RECORD_HEADER_SIZE + sizeof(a) + sizeof(b));
+}
+
+TEST_F(KvStore, VersionOrLengthMismatch_ReadFails) {
+    uint32_t value = 0xCAFEF00D;
+    EXPECT_TRUE(kv_store_write(1, 2, &value, sizeof(value)));
+
+    uint32_t read32 = 0;
+    uint16_t read16 = 0;
+    EXPECT_FALSE(kv_store_read(1, 1, &read32, sizeof(read32)));
+    EXPECT_FALSE(kv_store_read(1, 2, &read16, sizeof(read16)));
+    EXPECT_TRUE(kv_store_read(1, 2, &read32, sizeof(read32)));
+    EXPECT_EQ(read32, value);
+}
+
+TEST_F(KvStore, SameValue_NoBackingWrites) {
+    auto&   inst = MockBackingStore::Instance();
+    uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    EXPECT_TRUE(kv_store_write(1, 0, data, sizeof(data)));
+
+    uint64_t writes = inst.write_invoke_count();
+    EXPECT_TRUE(kv_store_write(1, 0, data, sizeof(data)));
+    EXPECT_EQ(inst.write_invoke_count(), writes) << "Unchanged record should not be written";
+}
+
+TEST_F(KvStore, ChangedRecord_OnlyThatRecordWritten) {
+    auto&   inst     = MockBackingStore::Instance();
+    uint8_t big[64]  = {0};
+    uint8_t small[4] = {9, 9, 9, 9};
+    for (size_t i = 0; i < sizeof(big); ++i) {
+        big[i] = (uint8_t)(0x40 + i);
+    }
+    EXPECT_TRUE(kv_store_write(1, 0, big, sizeof(big)));
+    EXPECT_TRUE(kv_store_write(2, 0, small, sizeof(small)));
+
+    // Changing the small record must not rewrite the large one: a 4-byte multibyte log entry is 4 backing writes
+    uint64_t writes = inst.write_invoke_count();
+    small[2]        = 7;
+    EXPECT_TRUE(kv_store_write(2, 0, small, sizeof(small)));
+    EXPECT_LE(inst.write_invoke_count() - writes, 4);
+
+    reinit();
+    uint8_t readback[4];
+    EXPECT_TRUE(kv_store_read(2, 0, readback, sizeof(readback)));
+    EXPECT_EQ(memcmp(readback, small, sizeof(small)), 0);
+}
+
+TEST_F(KvStore, ResizedRecord_Relocated) {
+    uint16_t v1 = 0x0102;
+    uint32_t v2 = 0x03040506;
+    uint8_t  other = 0x77;
+    EXPECT_TRUE(kv_store_write(3, 0, &v1, sizeof(v1)));
+    EXPECT_TRUE(kv_store_write(4, 0, &other, sizeof(other)));
+    EXPECT_TRUE(kv_store_write(3, 1, &v2, sizeof(v2)));
+    EXPECT_EQ(kv_store_used_space(), 2 * KV_STORE_RECORD_HEADER_SIZE + sizeof(v2) + sizeof(other));
+
+    reinit();
+    uint32_t r2 = 0;
+    uint8_t  ro = 0;
+    EXPECT_TRUE(kv_store_read(3, 1, &r2, sizeof(r2)));
+    EXPECT_TRUE(kv_store_read(4, 0, &ro, sizeof(ro)));
+    EXPECT_EQ(r2, v2);
+    EXPECT_EQ(ro, other);
+    EXPECT_EQ(kv_store_used_space(), 2 * KV_STORE_RECORD_HEADER_SIZE + sizeof(v2) + sizeof(other));
+}
+
+TEST_F(KvStore, Delete_RemovesRecord) {
+    uint8_t value = 0x42;
+    EXPECT_TRUE(kv_store_write(7, 0, &value, sizeof(value)));
+    kv_store_delete(7);
+    EXPECT_FALSE(kv_store_exists(7));
+
+    reinit();
+    EXPECT_FALSE(kv_store_exists(7));
+    EXPECT_FALSE(kv_store_read(7, 0, &value, sizeof(value)));
+}
+
+TEST_F(KvStore, Relocations_TriggerCompaction) {
+    uint8_t keep[16];
+    memset(keep, 0x5A, sizeof(keep));
+    EXPECT_TRUE(kv_store_write(1, 0, keep, sizeof(keep)));
+
+    // Alternate the length of a record so that it relocates each time, many times over the size of the region
+    uint8_t data[32];
+    for (int i = 0; i < 64; ++i) {
+        memset(data, i, sizeof(data));
+        EXPECT_TRUE(kv_store_write(2, (uint8_t)i, data, (i % 2) ? 31 : 32)) << "Write failed at iteration " << i;
+    }
+
+    reinit();
+    uint8_t readback[32];
+    EXPECT_TRUE(kv_store_read(1, 0, readback, sizeof(keep)));
+    EXPECT_EQ(memcmp(readback, keep, sizeof(keep)), 0);
+    EXPECT_TRUE(kv_store_read(2, 63, readback, 31));
+    EXPECT_EQ(readback[0], 63);
+    EXPECT_EQ(readback[30], 63);
+}
+
+TEST_F(KvStore, RegionFull_WriteFails) {
+    uint8_t data[100] = {0};
+    EXPECT_TRUE(kv_store_write(1, 0, data, sizeof(data)));
+    EXPECT_FALSE(kv_store_write(2, 0, data, 64));
+
+    // Existing records are unaffected
+    reinit();
+    EXPECT_TRUE(kv_store_read(1, 0, data, sizeof(data)));
+    EXPECT_FALSE(kv_store_exists(2));
+}
+
+TEST_F(KvStore, ResizedRecord_ReclaimsOldSpace) {
+    uint8_t data[110];
+    memset(data, 0x11, sizeof(data));
+    EXPECT_TRUE(kv_store_write(1, 0, data, 100));
+
+    // Only fits once the old copy, at the end of the region, is dropped
+    memset(data, 0x22, sizeof(data));
+    EXPECT_TRUE(kv_store_write(1, 1, data, 110));
+
+    reinit();
+    uint8_t readback[110];
+    EXPECT_TRUE(kv_store_read(1, 1, readback, sizeof(readback)));
+    EXPECT_EQ(memcmp(readback, data, sizeof(data)), 0);
+    EXPECT_EQ(kv_store_used_space(), KV_STORE_RECORD_HEADER_SIZE + 110);
+}
+
+TEST_F(KvStore, ResizedRecordTooLarge_KeepsOldCopy) {
+    uint8_t old_data[100];
+    memset(old_data, 0x11, sizeof(old_data));
+    EXPECT_TRUE(kv_store_write(1, 0, old_data, sizeof(old_data)));
+
+    // Doesn't fit even with the old copy's space reclaimed
+    uint8_t new_data[126];
+    memset(new_data, 0x22, sizeof(new_data));
+    EXPECT_FALSE(kv_store_write(1, 1, new_data, sizeof(new_data)));
+
+    uint8_t readback[100];
+    EXPECT_TRUE(kv_store_read(1, 0, readback, sizeof(readback)));
+    EXPECT_EQ(memcmp(readback, old_data, sizeof(old_data)), 0);
+
+    reinit();
+    EXPECT_TRUE(kv_store_read(1, 0, readback, sizeof(readback)));
+    EXPECT_EQ(memcmp(readback, old_data, sizeof(old_data)), 0);
+}
+
+TEST_F(KvStore, DuplicateRecord_LastWins) {
+    // Simulate power loss after a relocated record was written, but before the old copy was marked deleted
+    uint8_t first[]  = {1, 0, 1, 0xAA};
+    uint8_t second[] = {1, 0, 1, 0xBB};
+    eeprom_write_block(first, (void *)(uintptr_t)(KV_STORE_EEPROM_ADDR + KV_STORE_REGION_HEADER_SIZE), sizeof(first));
+    eeprom_write_block(second, (void *)(uintptr_t)(KV_STORE_EEPROM_ADDR + KV_STORE_REGION_HEADER_SIZE + sizeof(first)), sizeof(second));
+
+    reinit();
+    uint8_t value = 0;
+    EXPECT_TRUE(kv_store_read(1, 0, &value, sizeof(value)));
+    EXPECT_EQ(value, 0xBB);
+    EXPECT_EQ(kv_store_used_space(), sizeof(second));
+}
+
+TEST_F(KvStore, Format_ClearsRecords) {
+    uint8_t value = 0x11;
+    EXPECT_TRUE(kv_store_write(1, 0, &value, sizeof(value)));
+    kv_store_format();
+    EXPECT_FALSE(kv_store_exists(1));
+
+    reinit();
+    EXPECT_FALSE(kv_store_exists(1));
+}
+
+TEST_F(KvStore, MissingRegionHeader_Formatted) {
+    // Leftover bytes which happen to look like a record, e.g. from an area of EEPROM previously used for something else
+    uint8_t stale[] = {1, 0, 1, 0xCC, 0x00};
+    eeprom_write_block(stale, (void *)(uintptr_t)(KV_STORE_EEPROM_ADDR), sizeof(stale));
+
+    reinit();
+    EXPECT_FALSE(kv_store_exists(1));
+    EXPECT_EQ(kv_store_used_space(), 0);
+
+    // The region is usable, and keeps its records once formatted
+    uint8_t value = 0x22;
+    EXPECT_TRUE(kv_store_write(1, 0, &value, sizeof(value)));
+    reinit();
+    value = 0;
+    EXPECT_TRUE(kv_store_read(1, 0, &value, sizeof(value)));
+    EXPECT_EQ(value, 0x22);
+}
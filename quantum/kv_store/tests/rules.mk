@@ -0,0 +1,25 @@
+kv_store_DEFS := \
+	-DKV_STORE_ENABLE \
+	-DEEPROM_DRIVER \
+	-DEEPROM_WEAR_LEVELING \
+	-DWEAR_LEVELING_TESTS \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=2048 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=1024 \
+	-DKV_STORE_EEPROM_SIZE=128
+kv_store_SRC := \
+	$(LIB_PATH)/fnv/qmk_fnv_type_validation.c \
+	$(LIB_PATH)/fnv/hash_32a.c \
+	$(LIB_PATH)/fnv/hash_64a.c \
+	$(QUANTUM_PATH)/wear_leveling/wear_leveling.c \
+	$(QUANTUM_PATH)/wear_leveling/tests/backing_mocks.cpp \
+	$(DRIVER_PATH)/eeprom/eeprom_driver.c \
+	$(DRIVER_PATH)/eeprom/eeprom_wear_leveling.c \
+	$(QUANTUM_PATH)/kv_store/kv_store.c \
+	$(QUANTUM_PATH)/kv_store/tests/kv_store_tests.cpp
+kv_store_INC := \
+	$(LIB_PATH)/fnv \
+	$(QUANTUM_PATH)/wear_leveling \
+	$(QUANTUM_PATH)/wear_leveling/tests \
+	$(QUANTUM_PATH)/kv_store \
+	$(DRIVER_PATH)/eeprom
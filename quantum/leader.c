@@ -43,6 +43,20 @@ void leader_task(void) {
     }
 }
 
+bool leader_next_deadline(uint32_t *deadline) {
+    if (!leader_sequence_active()) {
+        return false;
+    }
+#if defined(LEADER_NO_TIMEOUT)
+    if (leader_sequence_size == 0) {
+        return false;
+    }
+#endif
+    uint16_t elapsed = timer_elapsed(leader_time);
+    *deadline        = timer_read32() + (elapsed > LEADER_TIMEOUT ? 0 : LEADER_TIMEOUT - elapsed + 1);
+    return true;
+}
+
 bool leader_sequence_active(void) {
     return leading;
 }
@@ -33,6 +33,14 @@ void leader_end(void);
 
 void leader_task(void);
 
+/**
+ * Retrieve the time at which the leader sequence will time out.
+ *
+ * \param deadline[out] the time-out deadline, equivalent time-space as timer_read32()
+ * \return true if the leader sequence is active and can time out, otherwise false
+ */
+bool leader_next_deadline(uint32_t *deadline);
+
 /**
  * Whether the leader sequence is active.
  */
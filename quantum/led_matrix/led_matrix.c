@@ -24,6 +24,7 @@
 #include "keyboard.h"
 #include "sync_timer.h"
 #include "debug.h"
+#include "profiling.h"
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
@@ -342,7 +343,7 @@ void led_matrix_task(void) {
             led_task_start();
             break;
         case RENDERING:
-            led_task_render(effect);
+            PROFILE_ZONE("led_matrix_render", led_task_render(effect));
             if (effect) {
                 if (led_task_state == FLUSHING) {
                     led_matrix_indicators(); // ensure we only draw basic indicators once rendering is finished
@@ -351,7 +352,7 @@ void led_matrix_task(void) {
             }
             break;
         case FLUSHING:
-            led_task_flush(effect);
+            PROFILE_ZONE("led_matrix_flush", led_task_flush(effect));
             break;
         case SYNCING:
             led_task_sync();
@@ -359,6 +360,18 @@ void led_matrix_task(void) {
     }
 }
 
+bool led_matrix_next_deadline(uint32_t *deadline) {
+    uint32_t now = timer_read32();
+    if (led_task_state != SYNCING) {
+        // A frame is still being rendered or flushed
+        *deadline = now;
+        return true;
+    }
+    uint32_t elapsed = sync_timer_elapsed32(g_led_timer);
+    *deadline        = now + (elapsed >= LED_MATRIX_LED_FLUSH_LIMIT ? 0 : LED_MATRIX_LED_FLUSH_LIMIT - elapsed);
+    return true;
+}
+
 void led_matrix_indicators(void) {
     led_matrix_indicators_kb();
 }
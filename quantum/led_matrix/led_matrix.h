@@ -129,6 +129,7 @@ void led_matrix_set_value_all(uint8_t value);
 void led_matrix_handle_key_event(uint8_t row, uint8_t col, bool pressed);
 
 void led_matrix_task(void);
+bool led_matrix_next_deadline(uint32_t *deadline);
 
 // This runs after another backlight effect and replaces
 // values already set
@@ -20,3 +20,97 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 __attribute__((weak)) int8_t sendchar(uint8_t c) {
     return 0;
 }
+
+_Static_assert(CONSOLE_BUFFER_SIZE > 0 && CONSOLE_BUFFER_SIZE <= 32768 && (CONSOLE_BUFFER_SIZE & (CONSOLE_BUFFER_SIZE - 1)) == 0, "CONSOLE_BUFFER_SIZE must be a power of two, no larger than 32768");
+
+/* Free running indices, only the writer moves the tail and only the reader
+ * the head, so printing from an interrupt doesn't corrupt the buffer. The same
+ * goes for the dropped and reported counts: the reader reports characters
+ * dropped since the last marker once it reaches the position they were lost. */
+static uint8_t           console_buffer[CONSOLE_BUFFER_SIZE];
+static volatile uint16_t console_head     = 0;
+static volatile uint16_t console_tail     = 0;
+static volatile uint16_t console_drop_at  = 0;
+static volatile uint32_t console_dropped  = 0;
+static volatile uint32_t console_reported = 0;
+
+int8_t console_buffer_put(uint8_t c) {
+    uint16_t tail = console_tail;
+    /* Once characters are dropped, so is everything after them until the
+     * reader reaches the marker, so that it stands for a single gap. */
+    if (console_dropped != console_reported || (uint16_t)(tail - console_head) == CONSOLE_BUFFER_SIZE) {
+        if (console_dropped == console_reported) {
+            console_drop_at = tail;
+        }
+        console_dropped++;
+        return -1;
+    }
+    console_buffer[tail % CONSOLE_BUFFER_SIZE] = c;
+    console_tail                               = tail + 1;
+    return 0;
+}
+
+/* Write "[N bytes dropped]\n" to data, truncated to size. */
+static uint16_t console_dropped_marker(uint8_t *data, uint16_t size, uint32_t dropped) {
+    static const char suffix[] = " bytes dropped]\n";
+
+    char     digits[10];
+    uint8_t  digit_count = 0;
+    uint16_t length      = 0;
+
+    do {
+        digits[digit_count++] = '0' + dropped % 10;
+        dropped /= 10;
+    } while (dropped > 0);
+
+    if (length < size) {
+        data[length++] = '[';
+    }
+    while (digit_count > 0 && length < size) {
+        data[length++] = digits[--digit_count];
+    }
+    for (uint8_t i = 0; i < sizeof(suffix) - 1 && length < size; i++) {
+        data[length++] = suffix[i];
+    }
+    return length;
+}
+
+uint16_t console_buffer_read(uint8_t *data, uint16_t size) {
+    uint16_t head    = console_head;
+    uint16_t count   = console_tail - head;
+    uint32_t dropped = console_dropped;
+
+    if (dropped != console_reported) {
+        uint16_t before_drop = console_drop_at - head;
+        if (before_drop == 0) {
+            uint32_t lost    = dropped - console_reported;
+            console_reported = dropped;
+            return console_dropped_marker(data, size, lost);
+        }
+        if (count > before_drop) {
+            count = before_drop;
+        }
+    }
+    if (count > size) {
+        count = size;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        data[i] = console_buffer[(uint16_t)(head + i) % CONSOLE_BUFFER_SIZE];
+    }
+    console_head = head + count;
+    return count;
+}
+
+uint16_t console_buffer_available(void) {
+    return console_tail - console_head + (console_dropped != console_reported);
+}
+
+uint32_t console_buffer_dropped(void) {
+    return console_dropped;
+}
+
+void console_buffer_clear(void) {
+    console_head     = console_tail;
+    console_dropped  = 0;
+    console_reported = 0;
+}
@@ -19,6 +19,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdint.h>
 
+/* size of the console output buffer, in bytes, a power of two */
+#ifndef CONSOLE_BUFFER_SIZE
+#    define CONSOLE_BUFFER_SIZE 256
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -28,6 +33,22 @@ typedef int8_t (*sendchar_func_t)(uint8_t c);
 /* transmit a character.  return 0 on success, -1 on error. */
 int8_t sendchar(uint8_t c);
 
+/* Console output buffer, for sendchar() implementations which must not block.
+ * Characters are queued with console_buffer_put() and later drained by the
+ * console task, so printing takes the same time whether or not anything is
+ * reading the console. Characters which don't fit are dropped and counted,
+ * and the reader gets a "[N bytes dropped]" line where they were lost. */
+
+/* queue a character.  return 0 on success, -1 if the buffer is full. */
+int8_t console_buffer_put(uint8_t c);
+/* take up to size queued characters, returning how many were taken. */
+uint16_t console_buffer_read(uint8_t *data, uint16_t size);
+/* number of characters waiting, non-zero while a dropped marker is due. */
+uint16_t console_buffer_available(void);
+/* number of characters dropped since the buffer was last cleared. */
+uint32_t console_buffer_dropped(void);
+void     console_buffer_clear(void);
+
 #ifdef __cplusplus
 }
 #endif
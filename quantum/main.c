@@ -15,6 +15,9 @@
  */
 
 #include "keyboard.h"
+#ifdef TICKLESS_IDLE_ENABLE
+#    include "tickless_idle.h"
+#endif
 
 void platform_setup(void);
 
@@ -73,5 +76,10 @@ int main(void) {
 #endif // DEFERRED_EXEC_ENABLE
 
         housekeeping_task();
+
+#ifdef TICKLESS_IDLE_ENABLE
+        // Wait in a low power state until there is more work to do
+        tickless_idle_task();
+#endif // TICKLESS_IDLE_ENABLE
     }
 }
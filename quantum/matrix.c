@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "matrix.h"
 #include "debounce.h"
+#include "profiling.h"
 #include "atomic_util.h"
 
 #ifdef SPLIT_KEYBOARD
@@ -340,10 +341,93 @@ uint8_t matrix_scan(void) {
     if (changed) memcpy(raw_matrix, curr_matrix, sizeof(curr_matrix));
 
 #ifdef SPLIT_KEYBOARD
-    changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed) | matrix_post_scan();
+    PROFILE_ZONE("debounce", changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed));
+    changed |= matrix_post_scan();
 #else
-    changed = debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
+    PROFILE_ZONE("debounce", changed = debounce(raw_matrix, matrix, ROWS_PER_HAND, changed));
     matrix_scan_kb();
 #endif
     return (uint8_t)changed;
 }
+
+#if defined(TICKLESS_IDLE_ENABLE) && defined(TICKLESS_IDLE_MATRIX_WAKE) && defined(PROTOCOL_CHIBIOS)
+#    include "tickless_idle.h"
+
+#    if PAL_USE_CALLBACKS != TRUE
+#        error "TICKLESS_IDLE_MATRIX_WAKE requires PAL_USE_CALLBACKS to be TRUE in halconf.h"
+#    endif
+
+// While waiting, every output is selected at once, so pressing or releasing any key changes the level of an input
+#    if defined(DIRECT_PINS)
+#        define MATRIX_WAKE_INPUT_COUNT (ROWS_PER_HAND * MATRIX_COLS)
+#        define MATRIX_WAKE_INPUT(i) (direct_pins[(i) / MATRIX_COLS][(i) % MATRIX_COLS])
+#    elif (DIODE_DIRECTION == COL2ROW)
+#        define MATRIX_WAKE_INPUT_COUNT MATRIX_COLS
+#        define MATRIX_WAKE_INPUT(i) (col_pins[i])
+#    elif (DIODE_DIRECTION == ROW2COL)
+#        define MATRIX_WAKE_INPUT_COUNT ROWS_PER_HAND
+#        define MATRIX_WAKE_INPUT(i) (row_pins[i])
+#    endif
+
+static void matrix_wake_callback(void *arg) {
+    (void)arg;
+    tickless_idle_wake();
+}
+
+static void matrix_wake_select_outputs(bool select) {
+#    if !defined(DIRECT_PINS) && (DIODE_DIRECTION == COL2ROW)
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        if (select) {
+            select_row(row);
+        } else {
+            unselect_row(row);
+        }
+    }
+#    elif !defined(DIRECT_PINS) && (DIODE_DIRECTION == ROW2COL)
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (select) {
+            select_col(col);
+        } else {
+            unselect_col(col);
+        }
+    }
+#    else
+    (void)select;
+#    endif
+}
+
+bool tickless_idle_matrix_arm(void) {
+    matrix_wake_select_outputs(true);
+    matrix_output_select_delay();
+
+    for (uint16_t i = 0; i < MATRIX_WAKE_INPUT_COUNT; i++) {
+        pin_t pin = MATRIX_WAKE_INPUT(i);
+        if (pin != NO_PIN) {
+            palSetLineCallback(pin, matrix_wake_callback, NULL);
+            palEnableLineEvent(pin, PAL_EVENT_MODE_BOTH_EDGES);
+        }
+    }
+
+    // Checked once the events are enabled, so that a key pressed in the meantime is not missed. A held key keeps its
+    // input low, which would hide further presses sharing that input.
+    for (uint16_t i = 0; i < MATRIX_WAKE_INPUT_COUNT; i++) {
+        if (!readMatrixPin(MATRIX_WAKE_INPUT(i))) {
+            tickless_idle_matrix_disarm();
+            return false;
+        }
+    }
+    return true;
+}
+
+void tickless_idle_matrix_disarm(void) {
+    for (uint16_t i = 0; i < MATRIX_WAKE_INPUT_COUNT; i++) {
+        pin_t pin = MATRIX_WAKE_INPUT(i);
+        if (pin != NO_PIN) {
+            palDisableLineEvent(pin);
+        }
+    }
+
+    matrix_wake_select_outputs(false);
+    matrix_output_unselect_delay(0, true);
+}
+#endif
@@ -1,5 +1,6 @@
 #include "matrix.h"
 #include "debounce.h"
+#include "profiling.h"
 #include "wait.h"
 #include "print.h"
 #include "debug.h"
@@ -169,9 +170,10 @@ __attribute__((weak)) uint8_t matrix_scan(void) {
     bool changed = matrix_scan_custom(raw_matrix);
 
 #ifdef SPLIT_KEYBOARD
-    changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed) | matrix_post_scan();
+    PROFILE_ZONE("debounce", changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed));
+    changed |= matrix_post_scan();
 #else
-    changed = debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
+    PROFILE_ZONE("debounce", changed = debounce(raw_matrix, matrix, ROWS_PER_HAND, changed));
     matrix_scan_kb();
 #endif
 
@@ -678,3 +678,16 @@ report_mouse_t mousekey_get_report(void) {
 bool should_mousekey_report_send(report_mouse_t *mouse_report) {
     return mouse_report->x || mouse_report->y || mouse_report->v || mouse_report->h;
 }
+
+bool mousekey_next_deadline(uint32_t *deadline) {
+    // Movement is repeated on its own timers while a movement key is held or the cursor is still coasting, so keep polling
+    bool moving = should_mousekey_report_send(&mouse_report);
+#ifdef MOUSEKEY_INERTIA
+    moving = moving || mousekey_frame;
+#endif
+    if (!moving) {
+        return false;
+    }
+    *deadline = timer_read32();
+    return true;
+}
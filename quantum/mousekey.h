@@ -202,6 +202,7 @@ void           mousekey_clear(void);
 void           mousekey_send(void);
 report_mouse_t mousekey_get_report(void);
 bool           should_mousekey_report_send(report_mouse_t *mouse_report);
+bool           mousekey_next_deadline(uint32_t *deadline);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,199 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "output_queue.h"
+#include "quantum.h"
+#include "timer.h"
+
+#ifdef UNICODE_ENABLE
+#    include "unicode.h"
+#endif
+#ifdef UNICODEMAP_ENABLE
+#    include "unicodemap.h"
+#endif
+
+typedef enum {
+    OUTPUT_STEP_REGISTER,
+    OUTPUT_STEP_UNREGISTER,
+    OUTPUT_STEP_DELAY,
+    OUTPUT_STEP_CALLBACK,
+} output_step_type_t;
+
+typedef struct {
+    uint8_t type;
+    union {
+        uint16_t code;
+        uint16_t delay;
+        struct {
+            output_queue_callback_t callback;
+            void                   *cb_arg;
+        };
+    };
+} output_step_t;
+
+// One slot is kept empty to tell a full queue from an empty one
+static output_step_t steps[OUTPUT_QUEUE_SIZE + 1];
+static uint8_t       head = 0;
+static uint8_t       tail = 0;
+
+static bool     waiting   = false;
+static uint16_t step_time = 0;
+static bool     cleared   = false;
+
+static uint8_t next_step(uint8_t index) {
+    return index == OUTPUT_QUEUE_SIZE ? 0 : index + 1;
+}
+
+static uint8_t free_steps(void) {
+    return OUTPUT_QUEUE_SIZE - (tail >= head ? tail - head : tail + OUTPUT_QUEUE_SIZE + 1 - head);
+}
+
+static bool push_step(output_step_t step) {
+    if (free_steps() == 0) {
+        return false;
+    }
+    steps[tail] = step;
+    tail        = next_step(tail);
+    return true;
+}
+
+static bool is_unicode_keycode(uint16_t code) {
+#ifdef UNICODE_ENABLE
+    if (IS_QK_UNICODE(code)) {
+        return true;
+    }
+#endif
+#ifdef UNICODEMAP_ENABLE
+    if (IS_QK_UNICODEMAP(code) || IS_QK_UNICODEMAP_PAIR(code)) {
+        return true;
+    }
+#endif
+    return false;
+}
+
+/** \brief Whether a keycode can be sent by the queue, warning about the ones which can't
+ */
+static bool is_queueable_keycode(uint16_t code) {
+    if (IS_QK_BASIC(code) || IS_QK_MODS(code) || is_unicode_keycode(code)) {
+        return true;
+    }
+    dprintf("output queue: keycode 0x%04X can't be sent\n", code);
+    return false;
+}
+
+bool output_queue_register_code16(uint16_t code) {
+    return is_queueable_keycode(code) && push_step((output_step_t){.type = OUTPUT_STEP_REGISTER, .code = code});
+}
+
+bool output_queue_unregister_code16(uint16_t code) {
+    return is_queueable_keycode(code) && push_step((output_step_t){.type = OUTPUT_STEP_UNREGISTER, .code = code});
+}
+
+bool output_queue_delay(uint16_t delay) {
+    return push_step((output_step_t){.type = OUTPUT_STEP_DELAY, .delay = delay});
+}
+
+bool output_queue_tap_code16_delay(uint16_t code, uint16_t delay) {
+    if (!is_queueable_keycode(code) || free_steps() < (delay ? 3 : 2)) {
+        return false;
+    }
+    output_queue_register_code16(code);
+    if (delay) {
+        output_queue_delay(delay);
+    }
+    return output_queue_unregister_code16(code);
+}
+
+bool output_queue_tap_code16(uint16_t code) {
+    return output_queue_tap_code16_delay(code, code == KC_CAPS_LOCK ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
+}
+
+bool output_queue_callback(output_queue_callback_t callback, void *cb_arg) {
+    return push_step((output_step_t){.type = OUTPUT_STEP_CALLBACK, .callback = callback, .cb_arg = cb_arg});
+}
+
+bool output_queue_pending(void) {
+    return head != tail;
+}
+
+void output_queue_clear(void) {
+    head    = tail;
+    waiting = false;
+    cleared = true;
+}
+
+bool output_queue_next_deadline(uint32_t *deadline) {
+    if (head == tail) {
+        return false;
+    }
+    *deadline = timer_read32();
+    if (waiting && !timer_expired(timer_read(), step_time)) {
+        *deadline += TIMER_DIFF_16(step_time, timer_read());
+    }
+    return true;
+}
+
+/** \brief Press a keycode, typing the whole input sequence of Unicode keycodes instead
+ */
+static void register_step(uint16_t code) {
+#ifdef UNICODE_ENABLE
+    if (IS_QK_UNICODE(code)) {
+        register_unicode(QK_UNICODE_GET_CODE_POINT(code));
+        return;
+    }
+#endif
+#ifdef UNICODEMAP_ENABLE
+    if (IS_QK_UNICODEMAP(code) || IS_QK_UNICODEMAP_PAIR(code)) {
+        register_unicodemap(unicodemap_index(code));
+        return;
+    }
+#endif
+    register_code16(code);
+}
+
+static void wait_for(uint16_t delay) {
+    waiting   = true;
+    step_time = timer_read() + delay;
+}
+
+void output_queue_task(void) {
+    while (head != tail) {
+        if (waiting) {
+            if (!timer_expired(timer_read(), step_time)) {
+                return;
+            }
+            waiting = false;
+        }
+
+        output_step_t *step = &steps[head];
+        uint16_t       delay;
+        switch (step->type) {
+            case OUTPUT_STEP_REGISTER:
+                register_step(step->code);
+                break;
+            case OUTPUT_STEP_UNREGISTER:
+                if (!is_unicode_keycode(step->code)) {
+                    unregister_code16(step->code);
+                }
+                break;
+            case OUTPUT_STEP_DELAY:
+                head = next_step(head);
+                wait_for(step->delay);
+                return;
+            case OUTPUT_STEP_CALLBACK:
+                cleared = false;
+                delay   = step->callback(step->cb_arg);
+                if (cleared) {
+                    // The callback cleared the queue, including itself
+                    return;
+                }
+                if (delay) {
+                    // Keep the callback at the head of the queue until it's done
+                    wait_for(delay);
+                    return;
+                }
+                break;
+        }
+        head = next_step(head);
+    }
+}
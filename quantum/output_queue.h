@@ -0,0 +1,87 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \defgroup output_queue Output Queue
+ *
+ * \brief Schedules key presses, releases and delays, to be sent in the background while the keyboard keeps running.
+ *
+ * Steps are executed in order by output_queue_task(), a step only starting once the delays before it have elapsed.
+ * Unlike tap_code16_delay() and friends, queueing returns straight away, so matrix scanning, lighting and split
+ * syncing carry on while long macros are being sent.
+ *
+ * \{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "action.h"
+
+/** \brief Number of steps which can be waiting in the queue
+ */
+#ifndef OUTPUT_QUEUE_SIZE
+#    define OUTPUT_QUEUE_SIZE 32
+#endif
+
+/** \brief Step run by the queue
+ *
+ * \param cb_arg the argument given when queueing the callback
+ * \return non-zero to run the callback again after that many milliseconds, holding back the following steps, or zero
+ *         once done.
+ */
+typedef uint16_t (*output_queue_callback_t)(void *cb_arg);
+
+/** \brief Queue the press of a keycode
+ *
+ * \return false if the queue is full
+ */
+bool output_queue_register_code16(uint16_t code);
+
+/** \brief Queue the release of a keycode
+ *
+ * \return false if the queue is full
+ */
+bool output_queue_unregister_code16(uint16_t code);
+
+/** \brief Queue a pause, in milliseconds, before the following steps
+ *
+ * \return false if the queue is full
+ */
+bool output_queue_delay(uint16_t delay);
+
+/** \brief Queue the tap of a keycode, held down for the given number of milliseconds
+ *
+ * \return false if the queue doesn't have room for the whole tap, in which case nothing is queued
+ */
+bool output_queue_tap_code16_delay(uint16_t code, uint16_t delay);
+
+/** \brief Queue the tap of a keycode, held down for the same time as tap_code16()
+ *
+ * \return false if the queue doesn't have room for the whole tap, in which case nothing is queued
+ */
+bool output_queue_tap_code16(uint16_t code);
+
+/** \brief Queue a function, which may keep running in the background for as long as it needs
+ *
+ * \return false if the queue is full
+ */
+bool output_queue_callback(output_queue_callback_t callback, void *cb_arg);
+
+/** \brief Whether any steps are waiting to be run
+ */
+bool output_queue_pending(void);
+
+/** \brief Drop all queued steps
+ *
+ * Keys already pressed by the queue are left pressed.
+ */
+void output_queue_clear(void);
+
+void output_queue_task(void);
+bool output_queue_next_deadline(uint32_t *deadline);
+
+/** \} */
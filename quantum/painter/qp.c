@@ -7,6 +7,7 @@
 #include "qp_internal.h"
 #include "qp_comms.h"
 #include "qp_draw.h"
+#include "profiling.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Internal driver validation
@@ -124,7 +125,8 @@ bool qp_flush(painter_device_t device) {
         return false;
     }
 
-    bool ret = driver->driver_vtable->flush(device);
+    bool ret;
+    PROFILE_ZONE("qp_flush", ret = driver->driver_vtable->flush(device));
     qp_comms_stop(device);
     qp_dprintf("qp_flush: %s\n", ret ? "ok" : "fail");
     return ret;
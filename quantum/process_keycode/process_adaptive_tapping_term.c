@@ -0,0 +1,186 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "process_adaptive_tapping_term.h"
+#include "action_tapping.h"
+#include "keycodes.h"
+#include "quantum_keycodes.h"
+#include "timer.h"
+#include "util.h"
+#include "keyboard.h"
+
+#define ADAPTIVE_TAPPING_TERM_KV_STORE_VERSION 1
+
+/* Longest duration learned as a tap, keeping the scaled average within 16 bits */
+#define ADAPTIVE_TAPPING_TERM_MAX_SAMPLE 1000
+
+typedef struct PACKED adaptive_tapping_term_stats_t {
+    uint16_t keycode;
+    uint16_t average;   // average tap duration, in 1/8 ms
+    uint16_t deviation; // four times the average deviation of the tap duration, in ms
+    uint8_t  taps;
+    uint8_t  holds;
+} adaptive_tapping_term_stats_t;
+
+static adaptive_tapping_term_stats_t stats[ADAPTIVE_TAPPING_TERM_KEYS];
+
+// State of the keys currently held, which isn't persisted
+static uint16_t press_time[ADAPTIVE_TAPPING_TERM_KEYS];
+static bool     held[ADAPTIVE_TAPPING_TERM_KEYS];
+static bool     used[ADAPTIVE_TAPPING_TERM_KEYS];
+
+#ifdef ADAPTIVE_TAPPING_TERM_PERSIST
+_Static_assert(sizeof(stats) <= UINT8_MAX, "ADAPTIVE_TAPPING_TERM_KEYS is too large to persist");
+static uint16_t taps_since_save = 0;
+#endif
+
+static int8_t find_key(uint16_t keycode) {
+    for (int8_t i = 0; i < ADAPTIVE_TAPPING_TERM_KEYS; i++) {
+        if (stats[i].keycode == keycode) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/** \brief Find the entry of a keycode, or make room for it by replacing the least used key not currently held
+ */
+static int8_t allocate_key(uint16_t keycode) {
+    int8_t index = find_key(keycode);
+    if (index >= 0) {
+        return index;
+    }
+    uint16_t least_used = UINT16_MAX;
+    for (int8_t i = 0; i < ADAPTIVE_TAPPING_TERM_KEYS; i++) {
+        uint16_t uses = stats[i].keycode == KC_NO ? 0 : stats[i].taps + stats[i].holds + 1;
+        if (!held[i] && uses < least_used) {
+            least_used = uses;
+            index      = i;
+        }
+    }
+    if (index >= 0) {
+        stats[index] = (adaptive_tapping_term_stats_t){.keycode = keycode};
+    }
+    return index;
+}
+
+static uint16_t learned_term(const adaptive_tapping_term_stats_t *entry) {
+    uint16_t term = (entry->average >> 3) + entry->deviation;
+    return MIN(MAX(term, ADAPTIVE_TAPPING_TERM_MIN), ADAPTIVE_TAPPING_TERM_MAX);
+}
+
+static void learn_tap(adaptive_tapping_term_stats_t *entry, uint16_t duration) {
+    duration = MIN(duration, ADAPTIVE_TAPPING_TERM_MAX_SAMPLE);
+    if (entry->taps == 0) {
+        entry->average   = duration << 3;
+        entry->deviation = duration << 1;
+    } else {
+        int16_t error = duration - (entry->average >> 3);
+        entry->average += error;
+        entry->deviation += (error < 0 ? -error : error) - (entry->deviation >> 2);
+    }
+    if (entry->taps < UINT8_MAX) {
+        entry->taps++;
+    }
+
+#ifdef ADAPTIVE_TAPPING_TERM_PERSIST
+    if (taps_since_save < UINT16_MAX) {
+        taps_since_save++;
+    }
+#endif
+}
+
+uint16_t get_adaptive_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    int8_t index = find_key(keycode);
+    if (index >= 0 && stats[index].taps >= ADAPTIVE_TAPPING_TERM_MIN_SAMPLES) {
+        return learned_term(&stats[index]);
+    }
+#if defined(TAPPING_TERM_PER_KEY)
+    return get_tapping_term(keycode, record);
+#elif defined(DYNAMIC_TAPPING_TERM_ENABLE)
+    return g_tapping_term;
+#else
+    return TAPPING_TERM;
+#endif
+}
+
+uint8_t adaptive_tapping_term_samples(uint16_t keycode) {
+    int8_t index = find_key(keycode);
+    return index >= 0 ? stats[index].taps : 0;
+}
+
+void preprocess_adaptive_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    if (!IS_EVENT(record->event)) {
+        return;
+    }
+    const bool dual_role = IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode);
+
+    if (record->event.pressed) {
+        // Dual-role keys held while another key is pressed were held on purpose
+        for (uint8_t i = 0; i < ADAPTIVE_TAPPING_TERM_KEYS; i++) {
+            used[i] |= held[i];
+        }
+        if (dual_role) {
+            int8_t index = allocate_key(keycode);
+            if (index >= 0) {
+                press_time[index] = record->event.time;
+                held[index]       = true;
+                used[index]       = false;
+            }
+        }
+        return;
+    }
+
+    int8_t index = dual_role ? find_key(keycode) : -1;
+    if (index < 0 || !held[index]) {
+        return;
+    }
+    held[index]             = false;
+    const uint16_t duration = TIMER_DIFF_16(record->event.time, press_time[index]);
+    if (record->tap.count == 1) {
+        learn_tap(&stats[index], duration);
+    } else if (record->tap.count == 0) {
+        // A hold released soon after the tapping term, without doing anything with it, was meant to be a tap
+        if (!used[index] && duration < get_adaptive_tapping_term(keycode, record) + ADAPTIVE_TAPPING_TERM_MISFIRE_WINDOW) {
+            learn_tap(&stats[index], duration);
+        } else if (stats[index].holds < UINT8_MAX) {
+            stats[index].holds++;
+        }
+    }
+}
+
+void adaptive_tapping_term_save(void) {
+#ifdef ADAPTIVE_TAPPING_TERM_PERSIST
+    kv_store_write(ADAPTIVE_TAPPING_TERM_KV_STORE_ID, ADAPTIVE_TAPPING_TERM_KV_STORE_VERSION, stats, sizeof(stats));
+    taps_since_save = 0;
+#endif
+}
+
+void adaptive_tapping_term_task(void) {
+#if defined(ADAPTIVE_TAPPING_TERM_PERSIST) && ADAPTIVE_TAPPING_TERM_SAVE_INTERVAL > 0
+    // Writes are held back until typing pauses, so they don't delay key presses
+    if (taps_since_save >= ADAPTIVE_TAPPING_TERM_SAVE_INTERVAL && last_input_activity_elapsed() >= ADAPTIVE_TAPPING_TERM_SAVE_IDLE_TIMEOUT) {
+        adaptive_tapping_term_save();
+    }
+#endif
+}
+
+void adaptive_tapping_term_init(void) {
+    memset(held, 0, sizeof(held));
+#ifdef ADAPTIVE_TAPPING_TERM_PERSIST
+    if (kv_store_read(ADAPTIVE_TAPPING_TERM_KV_STORE_ID, ADAPTIVE_TAPPING_TERM_KV_STORE_VERSION, stats, sizeof(stats))) {
+        return;
+    }
+#endif
+    memset(stats, 0, sizeof(stats));
+}
+
+void adaptive_tapping_term_reset(void) {
+    memset(stats, 0, sizeof(stats));
+    memset(held, 0, sizeof(held));
+#ifdef ADAPTIVE_TAPPING_TERM_PERSIST
+    kv_store_delete(ADAPTIVE_TAPPING_TERM_KV_STORE_ID);
+    taps_since_save = 0;
+#endif
+}
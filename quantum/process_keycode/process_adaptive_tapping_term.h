@@ -0,0 +1,96 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \defgroup adaptive_tapping_term Adaptive Tapping Term
+ *
+ * \brief Learns the tapping term of each dual-role key from how long it is held when tapped.
+ *
+ * Tap durations are tracked per keycode in a small statistics table, as a running average and average deviation,
+ * in the same way TCP estimates its retransmission timeout from round-trip times. Once enough taps have been seen,
+ * the tapping term of the key becomes the average tap duration plus four times its deviation. Holds released
+ * shortly after the tapping term without any other key being pressed are counted as taps, letting the term grow back
+ * for keys which keep being held too long.
+ *
+ * \{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "action.h"
+
+/** \brief Number of dual-role keys which can be tracked at once
+ */
+#ifndef ADAPTIVE_TAPPING_TERM_KEYS
+#    define ADAPTIVE_TAPPING_TERM_KEYS 8
+#endif
+
+/** \brief Number of taps needed before the learned tapping term is used
+ */
+#ifndef ADAPTIVE_TAPPING_TERM_MIN_SAMPLES
+#    define ADAPTIVE_TAPPING_TERM_MIN_SAMPLES 8
+#endif
+
+#ifndef ADAPTIVE_TAPPING_TERM_MIN
+#    define ADAPTIVE_TAPPING_TERM_MIN (TAPPING_TERM / 2)
+#endif
+
+#ifndef ADAPTIVE_TAPPING_TERM_MAX
+#    define ADAPTIVE_TAPPING_TERM_MAX (TAPPING_TERM * 3 / 2)
+#endif
+
+/** \brief Time past the tapping term within which a hold released without using it is considered a missed tap
+ */
+#ifndef ADAPTIVE_TAPPING_TERM_MISFIRE_WINDOW
+#    define ADAPTIVE_TAPPING_TERM_MISFIRE_WINDOW (TAPPING_TERM / 2)
+#endif
+
+#ifdef ADAPTIVE_TAPPING_TERM_PERSIST
+#    ifndef KV_STORE_ENABLE
+#        error "ADAPTIVE_TAPPING_TERM_PERSIST requires KV_STORE_ENABLE"
+#    endif
+#    include "kv_store.h"
+/** \brief Key-value store record holding the statistics table
+ */
+#    ifndef ADAPTIVE_TAPPING_TERM_KV_STORE_ID
+#        define ADAPTIVE_TAPPING_TERM_KV_STORE_ID KV_STORE_MAX_ID
+#    endif
+/** \brief Minimum number of taps learned between automatic saves, 0 to only save through adaptive_tapping_term_save()
+ */
+#    ifndef ADAPTIVE_TAPPING_TERM_SAVE_INTERVAL
+#        define ADAPTIVE_TAPPING_TERM_SAVE_INTERVAL 1024
+#    endif
+/** \brief Time in milliseconds without input activity before an automatic save
+ */
+#    ifndef ADAPTIVE_TAPPING_TERM_SAVE_IDLE_TIMEOUT
+#        define ADAPTIVE_TAPPING_TERM_SAVE_IDLE_TIMEOUT 30000
+#    endif
+#endif
+
+/** \brief Load the learned tapping terms, if persisted
+ */
+void adaptive_tapping_term_init(void);
+
+/** \brief Persist the learned tapping terms
+ */
+void adaptive_tapping_term_save(void);
+
+/** \brief Persist the learned tapping terms once enough taps were learned and typing has paused
+ */
+void adaptive_tapping_term_task(void);
+
+/** \brief Forget all learned tapping terms
+ */
+void adaptive_tapping_term_reset(void);
+
+/** \brief Number of taps learned for a keycode, saturating at 255
+ */
+uint8_t adaptive_tapping_term_samples(uint16_t keycode);
+
+void preprocess_adaptive_tapping_term(uint16_t keycode, keyrecord_t *record);
+
+/** \} */
@@ -647,6 +647,17 @@ void combo_task(void) {
 #endif
 }
 
+bool combo_next_deadline(uint32_t *deadline) {
+#ifndef COMBO_NO_TIMER
+    if (b_combo_enable && timer) {
+        uint16_t elapsed = timer_elapsed(timer);
+        *deadline        = timer_read32() + (elapsed > longest_term ? 0 : longest_term - elapsed + 1);
+        return true;
+    }
+#endif
+    return false;
+}
+
 void combo_enable(void) {
     b_combo_enable = true;
 }
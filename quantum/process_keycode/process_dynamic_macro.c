@@ -23,6 +23,11 @@
 #include "debug.h"
 #include "wait.h"
 
+#ifdef OUTPUT_QUEUE_ENABLE
+#    include "output_queue.h"
+#    include "timer.h"
+#endif
+
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -105,6 +110,94 @@ void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_
     *macro_pointer = macro_buffer;
 }
 
+#ifdef OUTPUT_QUEUE_ENABLE
+typedef struct {
+    keyrecord_t  *macro_buffer;
+    keyrecord_t  *macro_end;
+    keyrecord_t  *macro_pointer; // NULL until the playback starts
+    int8_t        direction;
+    bool          queued;
+    layer_state_t layer_state; // layers turned on by the macro itself
+} dynamic_macro_playback_t;
+
+static dynamic_macro_playback_t playback[2];
+
+/**
+ * Process a recorded key as it was recorded, on top of the default layer
+ * and the layers turned on by the macro so far. The layers of the user,
+ * who keeps typing during the playback, are left untouched.
+ */
+static void dynamic_macro_play_record(dynamic_macro_playback_t *macro, keyrecord_t *record) {
+    layer_state_t user_layer_state = layer_state;
+
+    layer_state = macro->layer_state;
+    process_record(record);
+
+    if (layer_state != macro->layer_state) {
+        // Layer callbacks were told about the layers of the macro, so tell them about the user's ones again
+        macro->layer_state = layer_state;
+        layer_state_set(user_layer_state);
+    } else {
+        layer_state = user_layer_state;
+    }
+}
+
+/**
+ * Release the keys the macro pressed but never released, rather than
+ * clearing the whole keyboard as the blocking playback does.
+ */
+static void dynamic_macro_release_held(dynamic_macro_playback_t *macro) {
+    int8_t direction = macro->direction;
+
+    for (keyrecord_t *press = macro->macro_buffer; press != macro->macro_end; press += direction) {
+        if (!press->event.pressed) {
+            continue;
+        }
+        keyrecord_t *next = press + direction;
+        while (next != macro->macro_end && !(KEYEQ(next->event.key, press->event.key) && !next->event.pressed)) {
+            next += direction;
+        }
+        if (next == macro->macro_end) {
+            keyrecord_t release   = *press;
+            release.event.pressed = false;
+            release.event.time    = timer_read();
+            dynamic_macro_play_record(macro, &release);
+        }
+    }
+}
+
+/**
+ * Play back one key of a dynamic macro from the output queue, so that
+ * the keyboard keeps running in the meantime.
+ */
+static uint16_t dynamic_macro_play_step(void *cb_arg) {
+    dynamic_macro_playback_t *macro     = (dynamic_macro_playback_t *)cb_arg;
+    int8_t                    direction = macro->direction;
+
+    if (!macro->macro_pointer) {
+        dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
+        macro->layer_state   = 0;
+        macro->macro_pointer = macro->macro_buffer;
+    }
+
+    if (macro->macro_pointer != macro->macro_end) {
+        dynamic_macro_play_record(macro, macro->macro_pointer);
+        macro->macro_pointer += direction;
+#    if defined(DYNAMIC_MACRO_DELAY) && DYNAMIC_MACRO_DELAY > 0
+        return DYNAMIC_MACRO_DELAY;
+#    else
+        return 1;
+#    endif
+    }
+
+    dynamic_macro_release_held(macro);
+    macro->macro_pointer = NULL;
+    macro->queued        = false;
+    dynamic_macro_play_kb(direction);
+    return 0;
+}
+#endif
+
 /**
  * Play the dynamic macro.
  *
@@ -113,6 +206,20 @@ void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_
  * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
  */
 void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
+#ifdef OUTPUT_QUEUE_ENABLE
+    dynamic_macro_playback_t *macro = &playback[direction > 0 ? 0 : 1];
+    if (macro->queued && output_queue_pending()) {
+        return;
+    }
+    macro->macro_buffer  = macro_buffer;
+    macro->macro_end     = macro_end;
+    macro->macro_pointer = NULL;
+    macro->direction     = direction;
+    macro->queued        = output_queue_callback(dynamic_macro_play_step, macro);
+    if (macro->queued) {
+        return;
+    }
+#endif
     dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
 
     layer_state_t saved_layer_state = layer_state;
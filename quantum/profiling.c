@@ -0,0 +1,230 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "profiling.h"
+#include "timer.h"
+#include "debug.h"
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <hal.h>
+#    if !defined(PROFILING_CPU_FREQUENCY) && defined(STM32_HCLK)
+#        define PROFILING_CPU_FREQUENCY STM32_HCLK
+#    endif
+#    if defined(DWT) && defined(PROFILING_CPU_FREQUENCY)
+#        define PROFILING_USE_DWT
+#        define PROFILING_TICKS_PER_US (PROFILING_CPU_FREQUENCY / 1000000)
+#    elif PORT_SUPPORTS_RT == TRUE && REALTIME_COUNTER_CLOCK >= 1000000
+#        define PROFILING_USE_REALTIME_COUNTER
+#        define PROFILING_TICKS_PER_US (REALTIME_COUNTER_CLOCK / 1000000)
+#    else
+#        define PROFILING_TICKS_PER_US 1
+#    endif
+#elif defined(__AVR__)
+#    define PROFILING_TICKS_PER_US 1
+#else
+#    include <time.h>
+#    define PROFILING_TICKS_PER_US 1000
+#endif
+
+typedef struct profiling_frame_t {
+    uint8_t  zone;
+    uint32_t start;
+} profiling_frame_t;
+
+static profiling_zone_t  zones[PROFILING_MAX_ZONES];
+static uint8_t           zone_count = 0;
+static profiling_frame_t stack[PROFILING_MAX_DEPTH];
+static uint8_t           depth = 0;
+
+#if defined(PROFILING_USE_DWT)
+static bool cycle_counter_enabled = false;
+
+uint32_t profiling_timestamp(void) {
+    if (!cycle_counter_enabled) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#    if defined(__CORTEX_M) && (__CORTEX_M == 7)
+        DWT->LAR = 0xC5ACCE55;
+#    endif
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        cycle_counter_enabled = true;
+    }
+    return DWT->CYCCNT;
+}
+#elif defined(PROFILING_USE_REALTIME_COUNTER)
+uint32_t profiling_timestamp(void) {
+    return chSysGetRealtimeCounterX();
+}
+#elif defined(PROTOCOL_CHIBIOS) || defined(__AVR__)
+uint32_t profiling_timestamp(void) {
+    // The system time wraps at 16 bits on some ports, so milliseconds are used instead -- multiplying keeps
+    // differences correct across the wrap of both the millisecond timer and the result
+    return timer_read32() * 1000;
+}
+#else
+uint32_t profiling_timestamp(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+#endif
+
+uint32_t profiling_ticks_to_ns(uint32_t ticks) {
+    uint64_t ns = (uint64_t)ticks * 1000 / PROFILING_TICKS_PER_US;
+    return ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+}
+
+static uint8_t histogram_bucket(uint32_t ticks) {
+    uint32_t us     = ticks / PROFILING_TICKS_PER_US;
+    uint8_t  bucket = 0;
+    while (us > 0 && bucket < PROFILING_HISTOGRAM_BUCKETS - 1) {
+        us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+static uint8_t register_zone(const char *name) {
+    for (uint8_t i = 0; i < zone_count; ++i) {
+        if (strcmp(zones[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (zone_count >= PROFILING_MAX_ZONES) {
+        return PROFILING_INVALID_ZONE;
+    }
+    memset(&zones[zone_count], 0, sizeof(profiling_zone_t));
+    zones[zone_count].name      = name;
+    zones[zone_count].min_ticks = UINT32_MAX;
+    return zone_count++;
+}
+
+void profiling_zone_begin(uint8_t *zone, const char *name) {
+    if (*zone == PROFILING_INVALID_ZONE) {
+        *zone = register_zone(name);
+    }
+    // Frames beyond the maximum depth are counted, but not measured
+    if (depth < PROFILING_MAX_DEPTH) {
+        stack[depth].zone  = *zone;
+        stack[depth].start = profiling_timestamp();
+    }
+    ++depth;
+}
+
+void profiling_zone_end(void) {
+    uint32_t now = profiling_timestamp();
+    if (depth == 0) {
+        return;
+    }
+    --depth;
+    if (depth >= PROFILING_MAX_DEPTH || stack[depth].zone == PROFILING_INVALID_ZONE) {
+        return;
+    }
+
+    profiling_zone_t *z       = &zones[stack[depth].zone];
+    uint32_t          elapsed = now - stack[depth].start;
+    ++z->count;
+    z->total_ticks += elapsed;
+    if (elapsed < z->min_ticks) {
+        z->min_ticks = elapsed;
+    }
+    if (elapsed > z->max_ticks) {
+        z->max_ticks = elapsed;
+    }
+    ++z->histogram[histogram_bucket(elapsed)];
+}
+
+uint8_t profiling_zone_count(void) {
+    return zone_count;
+}
+
+const profiling_zone_t *profiling_get_zone(uint8_t index) {
+    return index < zone_count ? &zones[index] : NULL;
+}
+
+void profiling_reset(void) {
+    for (uint8_t i = 0; i < zone_count; ++i) {
+        const char *name = zones[i].name;
+        memset(&zones[i], 0, sizeof(profiling_zone_t));
+        zones[i].name      = name;
+        zones[i].min_ticks = UINT32_MAX;
+    }
+}
+
+static uint32_t zone_min_ns(const profiling_zone_t *z) {
+    return z->count ? profiling_ticks_to_ns(z->min_ticks) : 0;
+}
+
+static uint32_t zone_avg_ns(const profiling_zone_t *z) {
+    return z->count ? profiling_ticks_to_ns((uint32_t)(z->total_ticks / z->count)) : 0;
+}
+
+void profiling_print(void) {
+    dprintf("%-24s %10s %10s %10s %10s\n", "zone", "count", "min(ns)", "avg(ns)", "max(ns)");
+    for (uint8_t i = 0; i < zone_count; ++i) {
+        const profiling_zone_t *z = &zones[i];
+        dprintf("%-24s %10lu %10lu %10lu %10lu\n", z->name, (unsigned long)z->count, (unsigned long)zone_min_ns(z), (unsigned long)zone_avg_ns(z), (unsigned long)profiling_ticks_to_ns(z->max_ticks));
+        dprintf("  ");
+        for (uint8_t b = 0; b < PROFILING_HISTOGRAM_BUCKETS; ++b) {
+            if (z->histogram[b] == 0) {
+                continue;
+            }
+            if (b == PROFILING_HISTOGRAM_BUCKETS - 1) {
+                dprintf(" >=%luus:%lu", (unsigned long)1 << (b - 1), (unsigned long)z->histogram[b]);
+            } else {
+                dprintf(" <%luus:%lu", (unsigned long)1 << b, (unsigned long)z->histogram[b]);
+            }
+        }
+        dprintf("\n");
+    }
+}
+
+static uint8_t put_u32(uint8_t *data, uint32_t value) {
+    for (uint8_t i = 0; i < 4; ++i) {
+        data[i] = (value >> (8 * i)) & 0xFF;
+    }
+    return 4;
+}
+
+uint8_t profiling_serialize_zone(uint8_t index, uint8_t *data, uint8_t length) {
+    const profiling_zone_t *z = profiling_get_zone(index);
+    if (z == NULL || length < 17) {
+        return 0;
+    }
+
+    uint8_t pos = 0;
+    data[pos++] = index;
+    pos += put_u32(&data[pos], z->count);
+    pos += put_u32(&data[pos], zone_min_ns(z));
+    pos += put_u32(&data[pos], zone_avg_ns(z));
+    pos += put_u32(&data[pos], profiling_ticks_to_ns(z->max_ticks));
+    for (const char *c = z->name; pos < length; ++c) {
+        data[pos++] = *c;
+        if (*c == '\0') {
+            break;
+        }
+    }
+    return pos;
+}
+
+uint8_t profiling_serialize_histogram(uint8_t index, uint8_t *data, uint8_t length) {
+    const profiling_zone_t *z = profiling_get_zone(index);
+    if (z == NULL || length < 2) {
+        return 0;
+    }
+
+    uint8_t pos     = 0;
+    uint8_t buckets = (length - 2) / 2;
+    if (buckets > PROFILING_HISTOGRAM_BUCKETS) {
+        buckets = PROFILING_HISTOGRAM_BUCKETS;
+    }
+    data[pos++] = index;
+    data[pos++] = buckets;
+    for (uint8_t b = 0; b < buckets; ++b) {
+        uint16_t value = z->histogram[b] > UINT16_MAX ? UINT16_MAX : z->histogram[b];
+        data[pos++]    = value & 0xFF;
+        data[pos++]    = value >> 8;
+    }
+    return pos;
+}
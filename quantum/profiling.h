@@ -0,0 +1,141 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \file
+ *
+ * \defgroup profiling Profiling zones
+ *
+ * \brief Measures the time spent in named regions of code.
+ *
+ * Zones are marked with PROFILE_ZONE_BEGIN() and PROFILE_ZONE_END(), and may be nested. Every call site is bound to its
+ * zone on first use -- call sites sharing a name share a zone. For each zone, the number of samples, the minimum,
+ * average and maximum duration, and a histogram of durations are kept.
+ *
+ * Durations are measured with the DWT cycle counter on Cortex-M3 and above, the realtime counter on other ChibiOS
+ * targets supporting one, the millisecond timer elsewhere, and the host's monotonic clock on the test platform.
+ *
+ * Usage example:
+ *
+ *     PROFILE_ZONE_BEGIN("matrix_scan");
+ *     matrix_scan();
+ *     PROFILE_ZONE_END();
+ *
+ *     // or equivalently
+ *     PROFILE_ZONE("matrix_scan", matrix_scan());
+ *
+ * \{
+ */
+
+/** \brief Maximum number of distinct zones
+ */
+#ifndef PROFILING_MAX_ZONES
+#    define PROFILING_MAX_ZONES 16
+#endif
+
+/** \brief Maximum nesting depth of zones
+ */
+#ifndef PROFILING_MAX_DEPTH
+#    define PROFILING_MAX_DEPTH 8
+#endif
+
+/** \brief Number of histogram buckets per zone, bucket n counting durations of [2^(n-1), 2^n) microseconds
+ */
+#ifndef PROFILING_HISTOGRAM_BUCKETS
+#    define PROFILING_HISTOGRAM_BUCKETS 16
+#endif
+
+#define PROFILING_INVALID_ZONE UINT8_MAX
+
+typedef struct profiling_zone_t {
+    const char *name;
+    uint32_t    count;
+    uint32_t    min_ticks;
+    uint32_t    max_ticks;
+    uint64_t    total_ticks;
+    uint32_t    histogram[PROFILING_HISTOGRAM_BUCKETS];
+} profiling_zone_t;
+
+/** \brief Read the profiling clock, in platform specific ticks
+ */
+uint32_t profiling_timestamp(void);
+
+/** \brief Convert a number of profiling clock ticks to nanoseconds
+ */
+uint32_t profiling_ticks_to_ns(uint32_t ticks);
+
+/** \brief Enter a zone, registering it on first use
+ *
+ * \param zone[in,out] per call site cache of the zone index, initialised to PROFILING_INVALID_ZONE
+ * \param name[in] the name of the zone
+ */
+void profiling_zone_begin(uint8_t *zone, const char *name);
+
+/** \brief Leave the innermost zone, recording its duration
+ */
+void profiling_zone_end(void);
+
+/** \brief Number of zones registered so far
+ */
+uint8_t profiling_zone_count(void);
+
+/** \brief Retrieve the collected data of a zone
+ *
+ * \return the zone, or NULL if index is out of range
+ */
+const profiling_zone_t *profiling_get_zone(uint8_t index);
+
+/** \brief Clear the collected data of all zones, keeping their registrations
+ */
+void profiling_reset(void);
+
+/** \brief Print a table of all zones to the console
+ */
+void profiling_print(void);
+
+/** \brief Serialise the data of a zone into a little endian buffer, for example a raw HID report
+ *
+ * The layout is: index (1), count (4), min_ns (4), avg_ns (4), max_ns (4), followed by the NUL terminated name for as
+ * long as it fits.
+ *
+ * \return the number of bytes written, or 0 if index is out of range
+ */
+uint8_t profiling_serialize_zone(uint8_t index, uint8_t *data, uint8_t length);
+
+/** \brief Serialise the histogram of a zone into a little endian buffer, for example a raw HID report
+ *
+ * The layout is: index (1), number of buckets (1), followed by as many buckets as fit (2 each, saturating).
+ *
+ * \return the number of bytes written, or 0 if index is out of range
+ */
+uint8_t profiling_serialize_histogram(uint8_t index, uint8_t *data, uint8_t length);
+
+#ifdef PROFILING_ENABLE
+#    define PROFILE_ZONE_BEGIN(name)                                       \
+        do {                                                               \
+            static uint8_t profiling_zone_index_ = PROFILING_INVALID_ZONE; \
+            profiling_zone_begin(&profiling_zone_index_, (name));          \
+        } while (0)
+#    define PROFILE_ZONE_END() profiling_zone_end()
+#else
+#    define PROFILE_ZONE_BEGIN(name) \
+        do {                         \
+        } while (0)
+#    define PROFILE_ZONE_END() \
+        do {                   \
+        } while (0)
+#endif
+
+#define PROFILE_ZONE(name, ...)   \
+    do {                          \
+        PROFILE_ZONE_BEGIN(name); \
+        __VA_ARGS__;              \
+        PROFILE_ZONE_END();       \
+    } while (0)
+
+/** \} */
@@ -24,6 +24,10 @@
 #    include "process_connection.h"
 #endif
 
+#ifdef EEPROM_DRIVER
+#    include "eeprom_driver.h"
+#endif
+
 #ifdef GRAVE_ESC_ENABLE
 #    include "process_grave_esc.h"
 #endif
@@ -210,6 +214,9 @@ void shutdown_quantum(bool jump_to_bootloader) {
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
 #endif
+#ifdef EEPROM_DRIVER
+    eeprom_driver_flush();
+#endif
 }
 
 void reset_keyboard(void) {
@@ -311,6 +318,10 @@ bool process_record_quantum(keyrecord_t *record) {
     }
 #endif
 
+#ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+    preprocess_adaptive_tapping_term(keycode, record);
+#endif
+
     if (!(
 #if defined(KEY_LOCK_ENABLE)
             // Must run first to be able to mask key_up events.
@@ -130,6 +130,10 @@ extern layer_state_t layer_state;
 #    include "process_dynamic_tapping_term.h"
 #endif
 
+#ifdef ADAPTIVE_TAPPING_TERM_ENABLE
+#    include "process_adaptive_tapping_term.h"
+#endif
+
 #ifdef COMBO_ENABLE
 #    include "process_combo.h"
 #endif
@@ -244,6 +248,14 @@ extern layer_state_t layer_state;
 #    include "layer_lock.h"
 #endif
 
+#ifdef KV_STORE_ENABLE
+#    include "kv_store.h"
+#endif
+
+#ifdef OUTPUT_QUEUE_ENABLE
+#    include "output_queue.h"
+#endif
+
 void set_single_default_layer(uint8_t default_layer);
 void set_single_persistent_default_layer(uint8_t default_layer);
 
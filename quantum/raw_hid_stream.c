@@ -0,0 +1,262 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "raw_hid_stream.h"
+#include "raw_hid.h"
+#include "timer.h"
+#include "util.h"
+
+#if RAW_HID_STREAM_TX_SIZE > UINT16_MAX || RAW_HID_STREAM_RX_SIZE > UINT16_MAX
+#    error "RAW_HID_STREAM_TX_SIZE and RAW_HID_STREAM_RX_SIZE must fit in 16 bits"
+#endif
+
+enum {
+    FRAME_ID,
+    FRAME_TYPE,
+    FRAME_SEQ,
+    FRAME_LENGTH,
+    FRAME_PAYLOAD,
+};
+
+#define FRAME_WINDOW FRAME_LENGTH
+
+// Data queued for the host. Bytes from tx_tail are split into frames of
+// tx_frame_len as they are first sent, and kept until acknowledged.
+static uint8_t  tx_buffer[RAW_HID_STREAM_TX_SIZE];
+static uint16_t tx_tail   = 0;
+static uint16_t tx_len    = 0;
+static uint16_t tx_framed = 0;
+static uint8_t  tx_frame_len[RAW_HID_STREAM_MAX_WINDOW];
+static uint8_t  tx_base       = 0; // sequence number of the oldest unacknowledged frame
+static uint8_t  tx_frames     = 0; // frames from tx_base given a sequence number
+static uint8_t  tx_next       = 0; // frames from tx_base sent since the last acknowledgement or rewind
+static uint8_t  remote_window = 0; // frames from tx_base the host has room for
+static uint32_t tx_timer      = 0;
+
+// Data received from the host, in order, until read.
+static uint8_t  rx_buffer[RAW_HID_STREAM_RX_SIZE];
+static uint16_t rx_head     = 0;
+static uint16_t rx_len      = 0;
+static uint8_t  rx_expected = 0;
+static uint8_t  rx_granted  = 0;
+
+static bool ack_pending = false;
+static bool nak_pending = false;
+static bool nak_sent    = false;
+
+static uint8_t rx_window(void) {
+    uint16_t frames = (RAW_HID_STREAM_RX_SIZE - rx_len) / RAW_HID_STREAM_PAYLOAD_SIZE;
+    return MIN(frames, RAW_HID_STREAM_MAX_WINDOW);
+}
+
+static void release_frames(uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t len = tx_frame_len[(uint8_t)(tx_base + i) % RAW_HID_STREAM_MAX_WINDOW];
+        tx_tail     = (tx_tail + len) % RAW_HID_STREAM_TX_SIZE;
+        tx_len -= len;
+        tx_framed -= len;
+    }
+    tx_base += count;
+    tx_frames -= count;
+    tx_next = tx_next > count ? tx_next - count : 0;
+}
+
+static void receive_acknowledgement(uint8_t type, uint8_t ack, uint8_t window) {
+    uint8_t count = ack - tx_base;
+    if (count > tx_frames) {
+        // Stale, or refers to frames never sent
+        return;
+    }
+
+    release_frames(count);
+    remote_window = MIN(window, RAW_HID_STREAM_MAX_WINDOW);
+    if (type == RAW_HID_STREAM_NAK) {
+        tx_next = 0;
+    }
+    tx_timer = timer_read32();
+}
+
+static void receive_data(uint8_t seq, const uint8_t *payload, uint8_t len) {
+    if (seq != rx_expected) {
+        if ((uint8_t)(rx_expected - seq) <= RAW_HID_STREAM_MAX_WINDOW) {
+            // Already received, the acknowledgement must have been lost
+            ack_pending = true;
+        } else if (!nak_sent) {
+            nak_pending = true;
+        }
+        return;
+    }
+    if (len == 0 || len > RAW_HID_STREAM_PAYLOAD_SIZE || len > RAW_HID_STREAM_RX_SIZE - rx_len) {
+        if (!nak_sent) {
+            nak_pending = true;
+        }
+        return;
+    }
+
+    for (uint8_t i = 0; i < len; i++) {
+        rx_buffer[(rx_head + rx_len + i) % RAW_HID_STREAM_RX_SIZE] = payload[i];
+    }
+    rx_len += len;
+    rx_expected++;
+    if (rx_granted > 0) {
+        rx_granted--;
+    }
+    ack_pending = true;
+    nak_pending = false;
+    nak_sent    = false;
+}
+
+bool raw_hid_stream_receive(uint8_t *data, uint8_t length) {
+    if (length < FRAME_PAYLOAD || data[FRAME_ID] != RAW_HID_STREAM_ID) {
+        return false;
+    }
+
+    switch (data[FRAME_TYPE]) {
+        case RAW_HID_STREAM_DATA:
+            receive_data(data[FRAME_SEQ], &data[FRAME_PAYLOAD], MIN(data[FRAME_LENGTH], length - FRAME_PAYLOAD));
+            break;
+        case RAW_HID_STREAM_ACK:
+        case RAW_HID_STREAM_NAK:
+            receive_acknowledgement(data[FRAME_TYPE], data[FRAME_SEQ], data[FRAME_WINDOW]);
+            break;
+        case RAW_HID_STREAM_RESET:
+            // Unacknowledged data is sent again from sequence number zero
+            tx_framed     = 0;
+            tx_base       = 0;
+            tx_frames     = 0;
+            tx_next       = 0;
+            remote_window = MIN(data[FRAME_WINDOW], RAW_HID_STREAM_MAX_WINDOW);
+            rx_expected   = 0;
+            nak_pending   = false;
+            nak_sent      = false;
+            ack_pending   = true;
+            tx_timer      = timer_read32();
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+uint16_t raw_hid_stream_write(const uint8_t *data, uint16_t length) {
+    length = MIN(length, raw_hid_stream_writable());
+    for (uint16_t i = 0; i < length; i++) {
+        tx_buffer[(tx_tail + tx_len + i) % RAW_HID_STREAM_TX_SIZE] = data[i];
+    }
+    tx_len += length;
+    return length;
+}
+
+uint16_t raw_hid_stream_read(uint8_t *data, uint16_t length) {
+    length = MIN(length, rx_len);
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = rx_buffer[(rx_head + i) % RAW_HID_STREAM_RX_SIZE];
+    }
+    rx_head = (rx_head + length) % RAW_HID_STREAM_RX_SIZE;
+    rx_len -= length;
+
+    // Let the host know as soon as there is room for more frames
+    if (rx_window() > rx_granted) {
+        ack_pending = true;
+    }
+    return length;
+}
+
+uint16_t raw_hid_stream_available(void) {
+    return rx_len;
+}
+
+uint16_t raw_hid_stream_writable(void) {
+    return RAW_HID_STREAM_TX_SIZE - tx_len;
+}
+
+bool raw_hid_stream_flushed(void) {
+    return tx_len == 0;
+}
+
+void raw_hid_stream_clear(void) {
+    tx_tail = tx_len = tx_framed = 0;
+    tx_base = tx_frames = tx_next = remote_window = 0;
+    rx_head = rx_len = rx_expected = rx_granted = 0;
+    ack_pending = nak_pending = nak_sent = false;
+}
+
+static void send_control(uint8_t type) {
+    uint8_t frame[RAW_HID_STREAM_REPORT_SIZE] = {0};
+
+    rx_granted          = rx_window();
+    frame[FRAME_ID]     = RAW_HID_STREAM_ID;
+    frame[FRAME_TYPE]   = type;
+    frame[FRAME_SEQ]    = rx_expected;
+    frame[FRAME_WINDOW] = rx_granted;
+    raw_hid_send(frame, sizeof(frame));
+}
+
+static void send_data(uint8_t index) {
+    uint8_t  frame[RAW_HID_STREAM_REPORT_SIZE] = {0};
+    uint16_t offset                            = 0;
+
+    for (uint8_t i = 0; i < index; i++) {
+        offset += tx_frame_len[(uint8_t)(tx_base + i) % RAW_HID_STREAM_MAX_WINDOW];
+    }
+
+    uint8_t seq = tx_base + index;
+    uint8_t len = tx_frame_len[seq % RAW_HID_STREAM_MAX_WINDOW];
+
+    frame[FRAME_ID]     = RAW_HID_STREAM_ID;
+    frame[FRAME_TYPE]   = RAW_HID_STREAM_DATA;
+    frame[FRAME_SEQ]    = seq;
+    frame[FRAME_LENGTH] = len;
+    for (uint8_t i = 0; i < len; i++) {
+        frame[FRAME_PAYLOAD + i] = tx_buffer[(tx_tail + offset + i) % RAW_HID_STREAM_TX_SIZE];
+    }
+    raw_hid_send(frame, sizeof(frame));
+    tx_timer = timer_read32();
+}
+
+static bool can_send_data(void) {
+    if (tx_next >= remote_window) {
+        return false;
+    }
+    return tx_next < tx_frames || (tx_frames < RAW_HID_STREAM_MAX_WINDOW && tx_framed < tx_len);
+}
+
+void raw_hid_stream_task(void) {
+    if (nak_pending) {
+        send_control(RAW_HID_STREAM_NAK);
+        nak_pending = false;
+        nak_sent    = true;
+        ack_pending = false;
+    } else if (ack_pending) {
+        send_control(RAW_HID_STREAM_ACK);
+        ack_pending = false;
+    }
+
+    if (tx_frames > 0 && tx_next == tx_frames && timer_elapsed32(tx_timer) >= RAW_HID_STREAM_RETRANSMIT_TIMEOUT) {
+        // Nothing heard back from the host, send everything unacknowledged again
+        tx_next = 0;
+    }
+
+    for (uint8_t burst = 0; burst < RAW_HID_STREAM_BURST && can_send_data(); burst++) {
+        if (tx_next == tx_frames) {
+            uint8_t len = MIN(tx_len - tx_framed, RAW_HID_STREAM_PAYLOAD_SIZE);
+
+            tx_frame_len[(uint8_t)(tx_base + tx_frames) % RAW_HID_STREAM_MAX_WINDOW] = len;
+            tx_framed += len;
+            tx_frames++;
+        }
+        send_data(tx_next++);
+    }
+}
+
+bool raw_hid_stream_next_deadline(uint32_t *deadline) {
+    if (ack_pending || nak_pending || can_send_data()) {
+        *deadline = timer_read32();
+        return true;
+    }
+    if (tx_frames > 0 && tx_next == tx_frames) {
+        *deadline = tx_timer + RAW_HID_STREAM_RETRANSMIT_TIMEOUT;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,117 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \file
+ *
+ * \defgroup raw_hid_stream Raw HID Stream
+ *
+ * \brief A reliable byte stream in both directions over raw HID reports.
+ *
+ * Data is carried in numbered frames, and each side only sends as many frames as the other has granted it credits
+ * for, which it does according to the free space in its receive buffer. Frames lost or received out of order are
+ * sent again, so nothing is dropped when the host is slow to read.
+ *
+ * Every report of the stream starts with RAW_HID_STREAM_ID, followed by the frame type:
+ *
+ * | Byte | DATA            | ACK, NAK and RESET                       |
+ * |------|-----------------|------------------------------------------|
+ * | 2    | Sequence number | Next sequence number expected            |
+ * | 3    | Payload length  | Frames granted from that sequence number |
+ * | 4-31 | Payload         | Unused                                   |
+ *
+ * A NAK asks for all frames from the given sequence number to be sent again. A RESET from the host restarts the
+ * sequence numbers of both directions, and is answered with an ACK.
+ *
+ * \{
+ */
+
+/** \brief First byte of every report belonging to the stream
+ */
+#ifndef RAW_HID_STREAM_ID
+#    define RAW_HID_STREAM_ID 0xFD
+#endif
+
+/** \brief Size of the buffer holding data until the host has acknowledged it, in bytes
+ */
+#ifndef RAW_HID_STREAM_TX_SIZE
+#    define RAW_HID_STREAM_TX_SIZE 512
+#endif
+
+/** \brief Size of the buffer holding received data until it is read, in bytes
+ */
+#ifndef RAW_HID_STREAM_RX_SIZE
+#    define RAW_HID_STREAM_RX_SIZE 256
+#endif
+
+/** \brief Maximum number of frames sent per call to raw_hid_stream_task()
+ */
+#ifndef RAW_HID_STREAM_BURST
+#    define RAW_HID_STREAM_BURST 4
+#endif
+
+/** \brief Time without acknowledgement from the host after which unacknowledged frames are sent again, in milliseconds
+ */
+#ifndef RAW_HID_STREAM_RETRANSMIT_TIMEOUT
+#    define RAW_HID_STREAM_RETRANSMIT_TIMEOUT 250
+#endif
+
+#define RAW_HID_STREAM_REPORT_SIZE 32
+#define RAW_HID_STREAM_PAYLOAD_SIZE (RAW_HID_STREAM_REPORT_SIZE - 4)
+
+/** \brief Maximum number of frames in flight in either direction
+ */
+#define RAW_HID_STREAM_MAX_WINDOW 16
+
+typedef enum raw_hid_stream_frame_type_t {
+    RAW_HID_STREAM_DATA  = 0x01,
+    RAW_HID_STREAM_ACK   = 0x02,
+    RAW_HID_STREAM_NAK   = 0x03,
+    RAW_HID_STREAM_RESET = 0x04,
+} raw_hid_stream_frame_type_t;
+
+/** \brief Handle a report received from the host
+ *
+ * To be called from raw_hid_receive(), or via_command_kb() when VIA is enabled.
+ *
+ * \return true if the report belongs to the stream, false if it should be handled otherwise
+ */
+bool raw_hid_stream_receive(uint8_t *data, uint8_t length);
+
+/** \brief Queue data to be sent to the host
+ *
+ * \return the number of bytes queued, less than length if the transmit buffer is full
+ */
+uint16_t raw_hid_stream_write(const uint8_t *data, uint16_t length);
+
+/** \brief Read data received from the host
+ *
+ * \return the number of bytes read
+ */
+uint16_t raw_hid_stream_read(uint8_t *data, uint16_t length);
+
+/** \brief Number of received bytes waiting to be read
+ */
+uint16_t raw_hid_stream_available(void);
+
+/** \brief Number of bytes which can currently be queued with raw_hid_stream_write()
+ */
+uint16_t raw_hid_stream_writable(void);
+
+/** \brief Whether all queued data has been acknowledged by the host
+ */
+bool raw_hid_stream_flushed(void);
+
+/** \brief Drop all buffered data in both directions, and wait for the host to reset the stream
+ */
+void raw_hid_stream_clear(void);
+
+void raw_hid_stream_task(void);
+bool raw_hid_stream_next_deadline(uint32_t *deadline);
+
+/** \} */
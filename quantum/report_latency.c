@@ -0,0 +1,69 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "report_latency.h"
+#include "debug.h"
+
+static report_latency_t latencies[REPORT_LATENCY_MAX_ENDPOINTS];
+
+void report_latency_record(uint8_t endpoint, uint32_t latency_us) {
+    if (endpoint >= REPORT_LATENCY_MAX_ENDPOINTS) {
+        return;
+    }
+
+    report_latency_t *l = &latencies[endpoint];
+    if (l->count == 0 || latency_us < l->min_us) {
+        l->min_us = latency_us;
+    }
+    if (latency_us > l->max_us) {
+        l->max_us = latency_us;
+    }
+    l->count++;
+    l->total_us += latency_us;
+
+    uint32_t bucket = latency_us / REPORT_LATENCY_BUCKET_US;
+    l->histogram[bucket < REPORT_LATENCY_BUCKETS ? bucket : REPORT_LATENCY_BUCKETS - 1]++;
+}
+
+const report_latency_t *get_report_latency(uint8_t endpoint) {
+    if (endpoint >= REPORT_LATENCY_MAX_ENDPOINTS) {
+        return NULL;
+    }
+    return &latencies[endpoint];
+}
+
+uint32_t get_report_latency_average(uint8_t endpoint) {
+    const report_latency_t *l = get_report_latency(endpoint);
+    if (l == NULL || l->count == 0) {
+        return 0;
+    }
+    return (uint32_t)(l->total_us / l->count);
+}
+
+void report_latency_reset(void) {
+    memset(latencies, 0, sizeof(latencies));
+}
+
+void report_latency_print(void) {
+    dprintf("%-8s %10s %10s %10s %10s\n", "endpoint", "count", "min(us)", "avg(us)", "max(us)");
+    for (uint8_t ep = 0; ep < REPORT_LATENCY_MAX_ENDPOINTS; ++ep) {
+        const report_latency_t *l = &latencies[ep];
+        if (l->count == 0) {
+            continue;
+        }
+        dprintf("%-8u %10lu %10lu %10lu %10lu\n", ep, (unsigned long)l->count, (unsigned long)l->min_us, (unsigned long)get_report_latency_average(ep), (unsigned long)l->max_us);
+        dprintf("  ");
+        for (uint8_t b = 0; b < REPORT_LATENCY_BUCKETS; ++b) {
+            if (l->histogram[b] == 0) {
+                continue;
+            }
+            if (b == REPORT_LATENCY_BUCKETS - 1) {
+                dprintf(" >=%luus:%lu", (unsigned long)b * REPORT_LATENCY_BUCKET_US, (unsigned long)l->histogram[b]);
+            } else {
+                dprintf(" <%luus:%lu", (unsigned long)(b + 1) * REPORT_LATENCY_BUCKET_US, (unsigned long)l->histogram[b]);
+            }
+        }
+        dprintf("\n");
+    }
+}
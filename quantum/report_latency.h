@@ -0,0 +1,71 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \file
+ *
+ * \defgroup report_latency Report latency
+ *
+ * \brief Measures the time from a report being queued on a USB endpoint until the host has collected it.
+ *
+ * The USB driver records one sample per report once its IN transfer completes, so the histogram shows how report
+ * submission lines up with the host's polling interval. Samples are kept per USB endpoint number.
+ *
+ * \{
+ */
+
+/** \brief Number of histogram buckets per endpoint, the last one also counting all longer latencies
+ */
+#ifndef REPORT_LATENCY_BUCKETS
+#    define REPORT_LATENCY_BUCKETS 16
+#endif
+
+/** \brief Width of each histogram bucket, in microseconds
+ */
+#ifndef REPORT_LATENCY_BUCKET_US
+#    define REPORT_LATENCY_BUCKET_US 500
+#endif
+
+/** \brief Number of USB endpoint numbers tracked
+ */
+#define REPORT_LATENCY_MAX_ENDPOINTS 16
+
+typedef struct report_latency_t {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t histogram[REPORT_LATENCY_BUCKETS];
+} report_latency_t;
+
+/** \brief Record the latency of a report collected by the host
+ *
+ * \param endpoint the USB endpoint number the report was sent on
+ * \param latency_us the time between the report being queued and its IN transfer completing
+ */
+void report_latency_record(uint8_t endpoint, uint32_t latency_us);
+
+/** \brief Retrieve the collected latencies of an endpoint
+ *
+ * \return the latencies, or NULL if endpoint is out of range
+ */
+const report_latency_t *get_report_latency(uint8_t endpoint);
+
+/** \brief Average latency of an endpoint, in microseconds, or 0 if nothing was recorded
+ */
+uint32_t get_report_latency_average(uint8_t endpoint);
+
+/** \brief Clear the collected latencies of all endpoints
+ */
+void report_latency_reset(void);
+
+/** \brief Print the latencies of all endpoints which sent reports to the console
+ */
+void report_latency_print(void);
+
+/** \} */
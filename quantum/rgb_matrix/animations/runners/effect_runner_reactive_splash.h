@@ -4,26 +4,125 @@
 
 typedef hsv_t (*reactive_splash_f)(hsv_t hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick);
 
-bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+// Narrows the distances from a hit at which the effect can still light an LED,
+// returning false once the hit can no longer light any
+typedef bool (*reactive_splash_reach_f)(uint16_t tick, uint8_t* min_dist, uint8_t* max_dist);
+
+typedef struct {
+    uint8_t  index;
+    uint8_t  min_dist;
+    uint8_t  max_dist;
+    uint16_t tick;
+#    ifdef RGB_MATRIX_GEOMETRY_CACHE
+    const uint8_t* dist;
+#    endif
+} reactive_splash_hit_t;
+
+#    ifdef RGB_MATRIX_GEOMETRY_CACHE
+// Distance of every LED from recent hits, worked out once rather than on every frame
+typedef struct {
+    led_point_t point;
+    bool        used;
+    uint8_t     dist[RGB_MATRIX_LED_COUNT];
+} reactive_splash_distances_t;
+
+static reactive_splash_distances_t reactive_splash_distances[LED_HITS_TO_REMEMBER];
+
+static bool reactive_splash_is_hit(const reactive_splash_hit_t* hits, uint8_t count, led_point_t point) {
+    for (uint8_t j = 0; j < count; j++) {
+        if (g_last_hit_tracker.x[hits[j].index] == point.x && g_last_hit_tracker.y[hits[j].index] == point.y) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static const uint8_t* reactive_splash_get_distances(const reactive_splash_hit_t* hits, uint8_t count, uint8_t x, uint8_t y) {
+    reactive_splash_distances_t* entry = NULL;
+    for (uint8_t k = 0; k < LED_HITS_TO_REMEMBER; k++) {
+        if (reactive_splash_distances[k].used && reactive_splash_distances[k].point.x == x && reactive_splash_distances[k].point.y == y) {
+            return reactive_splash_distances[k].dist;
+        }
+    }
+
+    // There are never more hits than entries, so one is always left over
+    for (uint8_t k = 0; k < LED_HITS_TO_REMEMBER && entry == NULL; k++) {
+        if (!reactive_splash_distances[k].used || !reactive_splash_is_hit(hits, count, reactive_splash_distances[k].point)) {
+            entry = &reactive_splash_distances[k];
+        }
+    }
+
+    entry->used    = true;
+    entry->point.x = x;
+    entry->point.y = y;
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        int16_t dx     = g_led_config.point[i].x - x;
+        int16_t dy     = g_led_config.point[i].y - y;
+        entry->dist[i] = sqrt16(dx * dx + dy * dy);
+    }
+    return entry->dist;
+}
+#    endif // RGB_MATRIX_GEOMETRY_CACHE
+
+bool effect_runner_reactive_splash_reach(uint8_t start, effect_params_t* params, reactive_splash_f effect_func, reactive_splash_reach_f reach_func) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
+    rgb_matrix_hsv_batch_t batch = {.count = 0};
+
+    // Hits which can't light anything are left out before going through the LEDs
+    reactive_splash_hit_t hits[LED_HITS_TO_REMEMBER];
+    uint8_t               count = 0;
+    for (uint8_t j = start; j < g_last_hit_tracker.count; j++) {
+        reactive_splash_hit_t* hit = &hits[count];
+
+        hit->index    = j;
+        hit->min_dist = 0;
+        hit->max_dist = UINT8_MAX;
+        hit->tick     = scale16by8(g_last_hit_tracker.tick[j], qadd8(rgb_matrix_config.speed, 1));
+        if (reach_func == NULL || reach_func(hit->tick, &hit->min_dist, &hit->max_dist)) {
+            count++;
+        }
+    }
+#    ifdef RGB_MATRIX_GEOMETRY_CACHE
+    for (uint8_t j = 0; j < count; j++) {
+        hits[j].dist = reactive_splash_get_distances(hits, count, g_last_hit_tracker.x[hits[j].index], g_last_hit_tracker.y[hits[j].index]);
+    }
+#    endif
 
-    uint8_t count = g_last_hit_tracker.count;
     for (uint8_t i = led_min; i < led_max; i++) {
         RGB_MATRIX_TEST_LED_FLAGS();
         hsv_t hsv = rgb_matrix_config.hsv;
         hsv.v     = 0;
-        for (uint8_t j = start; j < count; j++) {
-            int16_t  dx   = g_led_config.point[i].x - g_last_hit_tracker.x[j];
-            int16_t  dy   = g_led_config.point[i].y - g_last_hit_tracker.y[j];
-            uint8_t  dist = sqrt16(dx * dx + dy * dy);
-            uint16_t tick = scale16by8(g_last_hit_tracker.tick[j], qadd8(rgb_matrix_config.speed, 1));
-            hsv           = effect_func(hsv, dx, dy, dist, tick);
+        for (uint8_t j = 0; j < count; j++) {
+#    ifdef RGB_MATRIX_GEOMETRY_CACHE
+            uint8_t dist = hits[j].dist[i];
+            if (dist < hits[j].min_dist || dist > hits[j].max_dist) {
+                continue;
+            }
+            int16_t dx = g_led_config.point[i].x - g_last_hit_tracker.x[hits[j].index];
+            int16_t dy = g_led_config.point[i].y - g_last_hit_tracker.y[hits[j].index];
+#    else
+            int16_t dx = g_led_config.point[i].x - g_last_hit_tracker.x[hits[j].index];
+            int16_t dy = g_led_config.point[i].y - g_last_hit_tracker.y[hits[j].index];
+            // The distance is never less than either offset, so far away LEDs are skipped without the square root
+            if (abs(dx) > hits[j].max_dist || abs(dy) > hits[j].max_dist) {
+                continue;
+            }
+            uint8_t dist = sqrt16(dx * dx + dy * dy);
+            if (dist < hits[j].min_dist || dist > hits[j].max_dist) {
+                continue;
+            }
+#    endif
+            hsv = effect_func(hsv, dx, dy, dist, hits[j].tick);
         }
         hsv.v     = scale8(hsv.v, rgb_matrix_config.hsv.v);
-        rgb_t rgb = rgb_matrix_hsv_to_rgb(hsv);
-        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
+        rgb_matrix_hsv_batch_set(&batch, i, hsv);
     }
+    rgb_matrix_hsv_batch_flush(&batch);
     return rgb_matrix_check_finished_leds(led_max);
 }
 
+bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+    return effect_runner_reactive_splash_reach(start, params, effect_func, NULL);
+}
+
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
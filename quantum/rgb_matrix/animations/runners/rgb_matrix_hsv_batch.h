@@ -0,0 +1,29 @@
+#pragma once
+
+#ifndef RGB_MATRIX_HSV_BATCH_SIZE
+#    define RGB_MATRIX_HSV_BATCH_SIZE 16
+#endif
+
+// Colors gathered from an effect, to be converted to RGB together
+typedef struct {
+    uint8_t count;
+    uint8_t index[RGB_MATRIX_HSV_BATCH_SIZE];
+    hsv_t   hsv[RGB_MATRIX_HSV_BATCH_SIZE];
+} rgb_matrix_hsv_batch_t;
+
+static inline void rgb_matrix_hsv_batch_flush(rgb_matrix_hsv_batch_t* batch) {
+    rgb_t rgb[RGB_MATRIX_HSV_BATCH_SIZE];
+    rgb_matrix_hsv_to_rgb_batch(batch->hsv, rgb, batch->count);
+    for (uint8_t k = 0; k < batch->count; k++) {
+        rgb_matrix_set_color(batch->index[k], rgb[k].r, rgb[k].g, rgb[k].b);
+    }
+    batch->count = 0;
+}
+
+static inline void rgb_matrix_hsv_batch_set(rgb_matrix_hsv_batch_t* batch, uint8_t index, hsv_t hsv) {
+    batch->index[batch->count] = index;
+    batch->hsv[batch->count]   = hsv;
+    if (++batch->count == RGB_MATRIX_HSV_BATCH_SIZE) {
+        rgb_matrix_hsv_batch_flush(batch);
+    }
+}
@@ -27,3 +27,8 @@
     defined(ENABLE_RGB_MATRIX_SOLID_MULTISPLASH)
 #    define RGB_MATRIX_KEYPRESSES
 #endif
+
+// geometry cache
+#if !defined(RGB_MATRIX_GEOMETRY_CACHE) && !defined(RGB_MATRIX_DISABLE_GEOMETRY_CACHE) && !defined(__AVR__)
+#    define RGB_MATRIX_GEOMETRY_CACHE
+#endif
@@ -23,6 +23,7 @@
 #include "keyboard.h"
 #include "sync_timer.h"
 #include "debug.h"
+#include "profiling.h"
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
@@ -35,10 +36,31 @@ const led_point_t k_rgb_matrix_center = {112, 32};
 const led_point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 #endif
 
-__attribute__((weak)) rgb_t rgb_matrix_hsv_to_rgb(hsv_t hsv) {
+static rgb_t rgb_matrix_hsv_to_rgb_default(hsv_t hsv) {
     return hsv_to_rgb(hsv);
 }
 
+#ifdef __ELF__
+// An alias, so the batch conversion can tell whether the keyboard replaced it
+rgb_t rgb_matrix_hsv_to_rgb(hsv_t hsv) __attribute__((weak, alias("rgb_matrix_hsv_to_rgb_default")));
+#else
+__attribute__((weak)) rgb_t rgb_matrix_hsv_to_rgb(hsv_t hsv) {
+    return rgb_matrix_hsv_to_rgb_default(hsv);
+}
+#endif
+
+__attribute__((weak)) void rgb_matrix_hsv_to_rgb_batch(const hsv_t *hsv, rgb_t *rgb, uint8_t count) {
+#ifdef __ELF__
+    if (rgb_matrix_hsv_to_rgb == rgb_matrix_hsv_to_rgb_default) {
+        hsv_to_rgb_batch(hsv, rgb, count);
+        return;
+    }
+#endif
+    for (uint8_t i = 0; i < count; i++) {
+        rgb[i] = rgb_matrix_hsv_to_rgb(hsv[i]);
+    }
+}
+
 // Generic effect runners
 #include "rgb_matrix_runners.inc"
 
@@ -69,6 +91,9 @@ uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 last_hit_t g_last_hit_tracker;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+led_geometry_t g_rgb_matrix_geometry[RGB_MATRIX_LED_COUNT];
+#endif // RGB_MATRIX_GEOMETRY_CACHE
 
 // internals
 static bool            suspend_state     = false;
@@ -377,7 +402,7 @@ void rgb_matrix_task(void) {
             rgb_task_start();
             break;
         case RENDERING:
-            rgb_task_render(effect);
+            PROFILE_ZONE("rgb_matrix_render", rgb_task_render(effect));
             if (effect) {
                 if (rgb_task_state == FLUSHING) { // ensure we only draw basic indicators once rendering is finished
                     rgb_matrix_indicators();
@@ -386,7 +411,7 @@ void rgb_matrix_task(void) {
             }
             break;
         case FLUSHING:
-            rgb_task_flush(effect);
+            PROFILE_ZONE("rgb_matrix_flush", rgb_task_flush(effect));
             break;
         case SYNCING:
             rgb_task_sync();
@@ -394,6 +419,18 @@ void rgb_matrix_task(void) {
     }
 }
 
+bool rgb_matrix_next_deadline(uint32_t *deadline) {
+    uint32_t now = timer_read32();
+    if (rgb_task_state != SYNCING) {
+        // A frame is still being rendered or flushed
+        *deadline = now;
+        return true;
+    }
+    uint32_t elapsed = sync_timer_elapsed32(g_rgb_timer);
+    *deadline        = now + (elapsed >= RGB_MATRIX_LED_FLUSH_LIMIT ? 0 : RGB_MATRIX_LED_FLUSH_LIMIT - elapsed);
+    return true;
+}
+
 void rgb_matrix_indicators(void) {
     rgb_matrix_indicators_kb();
 }
@@ -452,8 +489,24 @@ __attribute__((weak)) bool rgb_matrix_indicators_advanced_user(uint8_t led_min,
     return true;
 }
 
+void rgb_matrix_update_geometry(void) {
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        int16_t dx = g_led_config.point[i].x - k_rgb_matrix_center.x;
+        int16_t dy = g_led_config.point[i].y - k_rgb_matrix_center.y;
+
+        g_rgb_matrix_geometry[i].dist  = sqrt16(dx * dx + dy * dy);
+        g_rgb_matrix_geometry[i].angle = atan2_8(dy, dx);
+    }
+#    ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+    memset(reactive_splash_distances, 0, sizeof(reactive_splash_distances));
+#    endif
+#endif // RGB_MATRIX_GEOMETRY_CACHE
+}
+
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
+    rgb_matrix_update_geometry();
 
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
@@ -150,9 +150,13 @@ int rgb_matrix_led_index(int index);
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue);
 
+// Converts the colors drawn by the effect runners, through rgb_matrix_hsv_to_rgb() when the keyboard replaces it
+void rgb_matrix_hsv_to_rgb_batch(const hsv_t *hsv, rgb_t *rgb, uint8_t count);
+
 void rgb_matrix_handle_key_event(uint8_t row, uint8_t col, bool pressed);
 
 void rgb_matrix_task(void);
+bool rgb_matrix_next_deadline(uint32_t *deadline);
 
 // This runs after another backlight effect and replaces
 // colors already set
@@ -165,6 +169,7 @@ bool rgb_matrix_indicators_advanced_kb(uint8_t led_min, uint8_t led_max);
 bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max);
 
 void rgb_matrix_init(void);
+void rgb_matrix_update_geometry(void);
 
 void rgb_matrix_reload_from_eeprom(void);
 
@@ -280,3 +285,6 @@ extern last_hit_t g_last_hit_tracker;
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
 #endif
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+extern led_geometry_t g_rgb_matrix_geometry[RGB_MATRIX_LED_COUNT];
+#endif
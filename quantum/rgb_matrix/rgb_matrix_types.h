@@ -21,6 +21,10 @@
 #include "color.h"
 #include "util.h"
 
+#ifdef __cplusplus
+#    define _Static_assert static_assert
+#endif
+
 #if defined(RGB_MATRIX_KEYPRESSES) || defined(RGB_MATRIX_KEYRELEASES)
 #    define RGB_MATRIX_KEYREACTIVE_ENABLED
 #endif
@@ -55,6 +59,14 @@ typedef struct PACKED {
     uint8_t y;
 } led_point_t;
 
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+// Position of an LED relative to the center, as used by the effects
+typedef struct {
+    uint8_t dist;
+    uint8_t angle;
+} led_geometry_t;
+#endif // RGB_MATRIX_GEOMETRY_CACHE
+
 #define HAS_FLAGS(bits, flags) ((bits & flags) == flags)
 #define HAS_ANY_FLAGS(bits, flags) ((bits & flags) != 0x00)
 
@@ -1454,6 +1454,35 @@ void rgblight_task(void) {
 #endif
 }
 
+bool rgblight_next_deadline(uint32_t *deadline) {
+    // Velocikey only changes the speed of animations, which wake up on their own
+    bool     found = false;
+    uint16_t wait  = UINT16_MAX;
+#ifdef RGBLIGHT_USE_TIMER
+    uint16_t now = sync_timer_read();
+    if (rgblight_status.timer_enabled) {
+        found = true;
+        wait  = (animation_status.restart || timer_expired(now, animation_status.last_timer)) ? 0 : animation_status.last_timer - now;
+    }
+#    ifdef RGBLIGHT_LAYERS
+#        ifdef RGBLIGHT_LAYER_BLINK
+    if (_blinking_layer_mask != 0) {
+        found = true;
+        wait  = MIN(wait, timer_expired(now, _repeat_timer) ? 0 : (uint16_t)(_repeat_timer - now));
+    }
+#        endif
+    if (deferred_set_layer_state) {
+        found = true;
+        wait  = 0;
+    }
+#    endif
+#endif
+    if (found) {
+        *deadline = timer_read32() + wait;
+    }
+    return found;
+}
+
 #ifdef VELOCIKEY_ENABLE
 #    define TYPING_SPEED_MAX_VALUE 200
 
@@ -387,6 +387,7 @@ void rgblight_show_solid_color(uint8_t r, uint8_t g, uint8_t b);
 
 void preprocess_rgblight(void);
 void rgblight_task(void);
+bool rgblight_next_deadline(uint32_t *deadline);
 
 #ifdef RGBLIGHT_USE_TIMER
 void rgblight_timer_init(void);
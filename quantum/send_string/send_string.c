@@ -24,6 +24,15 @@
 #include "action.h"
 #include "wait.h"
 
+#ifdef SENDSTRING_ASYNC
+#    include <string.h>
+#    include "action_util.h"
+#    include "keycode_config.h"
+#    include "report.h"
+#    include "timer.h"
+#    include "usb_device_state.h"
+#endif
+
 #if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
 #    include "audio.h"
 #    ifndef BELL_SOUND
@@ -336,3 +345,242 @@ void send_string_with_delay_P(const char *string, uint8_t interval) {
     }
 }
 #endif
+
+#ifdef SENDSTRING_ASYNC
+static char     async_queue[SENDSTRING_ASYNC_BUFFER_SIZE];
+static uint16_t async_head = 0;
+static uint16_t async_tail = 0;
+
+// Keys of the report currently held down, released on the next step. Keys and modifiers which were already held,
+// for example by the user, are left out of the owned ones so they are not released along with the others.
+static uint8_t async_keys[KEYBOARD_REPORT_KEYS];
+static uint8_t async_key_count  = 0;
+static uint8_t async_keys_owned = 0; // bitmask of the entries of async_keys
+static uint8_t async_mods       = 0;
+static uint8_t async_mods_owned = 0;
+static uint8_t async_code       = KC_NO; // keycode of an SS_TAP() held down
+static bool    async_dead_key   = false;
+
+static uint16_t async_step_time  = 0;
+static uint16_t async_step_delay = 0;
+
+static uint16_t async_queue_length(void) {
+    return (async_tail + SENDSTRING_ASYNC_BUFFER_SIZE - async_head) % SENDSTRING_ASYNC_BUFFER_SIZE;
+}
+
+static char async_queue_peek(uint16_t offset) {
+    return async_queue[(async_head + offset) % SENDSTRING_ASYNC_BUFFER_SIZE];
+}
+
+static char async_queue_pop(void) {
+    if (async_head == async_tail) {
+        return 0;
+    }
+    char ascii_code = async_queue[async_head];
+    async_head      = (async_head + 1) % SENDSTRING_ASYNC_BUFFER_SIZE;
+    return ascii_code;
+}
+
+static bool async_queue_reserve(uint16_t length) {
+    // One slot is kept empty to tell a full queue from an empty one
+    return length > 0 && length < SENDSTRING_ASYNC_BUFFER_SIZE - async_queue_length();
+}
+
+static void async_queue_push(char ascii_code) {
+    async_queue[async_tail] = ascii_code;
+    async_tail              = (async_tail + 1) % SENDSTRING_ASYNC_BUFFER_SIZE;
+}
+
+bool send_string_async(const char *string) {
+    if (!async_queue_reserve(strlen(string))) {
+        return false;
+    }
+    while (*string) {
+        async_queue_push(*string++);
+    }
+    return true;
+}
+
+#    if defined(__AVR__)
+bool send_string_async_P(const char *string) {
+    if (!async_queue_reserve(strlen_P(string))) {
+        return false;
+    }
+    char ascii_code;
+    while ((ascii_code = pgm_read_byte(string++))) {
+        async_queue_push(ascii_code);
+    }
+    return true;
+}
+#    endif
+
+bool send_string_async_pending(void) {
+    return async_head != async_tail || async_key_count || async_code != KC_NO || async_dead_key;
+}
+
+/** \brief Whether the host sees the keys of a report in the order they were added
+ *
+ * NKRO reports are bitmaps, so keys pressed at once are seen in keycode order instead.
+ */
+static bool async_report_keeps_order(void) {
+#    if defined(NKRO_ENABLE) && !defined(NKRO_AUTO)
+    return !(usb_device_state_get_protocol() == USB_PROTOCOL_REPORT && keymap_config.nkro);
+#    else
+    return true;
+#    endif
+}
+
+static bool async_can_add_key(uint8_t keycode, uint8_t mods) {
+    if (async_key_count == 0) {
+        return true;
+    }
+    if (async_key_count == KEYBOARD_REPORT_KEYS || mods != async_mods) {
+        return false;
+    }
+    if (!async_report_keeps_order() && keycode <= async_keys[async_key_count - 1]) {
+        return false;
+    }
+    for (uint8_t i = 0; i < async_key_count; i++) {
+        if (async_keys[i] == keycode) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void async_add_key(uint8_t keycode, uint8_t mods) {
+    async_keys[async_key_count++] = keycode;
+    async_mods                    = mods;
+}
+
+/** \brief Handle a SS_TAP(), SS_DOWN(), SS_UP() or SS_DELAY() sequence at the head of the queue
+ */
+static void async_process_code(void) {
+    async_queue_pop(); // SS_QMK_PREFIX
+    char code = async_queue_pop();
+
+    if (code == SS_TAP_CODE) {
+        uint8_t keycode = async_queue_pop();
+        bool    held    = IS_MODIFIER_KEYCODE(keycode) ? get_mods() & MOD_BIT(keycode) : is_key_pressed(keycode);
+        if (!held) {
+            async_code = keycode;
+            register_code(async_code);
+        }
+    } else if (code == SS_DOWN_CODE) {
+        register_code(async_queue_pop());
+    } else if (code == SS_UP_CODE) {
+        unregister_code(async_queue_pop());
+    } else if (code == SS_DELAY_CODE) {
+        uint16_t ms = 0;
+        while (async_head != async_tail && isdigit(async_queue_peek(0))) {
+            ms = ms * 10 + async_queue_pop() - '0';
+        }
+        async_queue_pop(); // terminator
+        async_step_delay += ms;
+    }
+}
+
+/** \brief Gather as many of the queued characters as possible for a single report
+ *
+ * Characters are gathered until one needs different modifiers, repeats a key already in the report, or the report is
+ * full. Dead keys end the report.
+ */
+static void async_gather_keys(void) {
+    while (async_head != async_tail) {
+        char ascii_code = async_queue_peek(0);
+        if (ascii_code == SS_QMK_PREFIX) {
+            if (async_key_count == 0) {
+                async_process_code();
+            }
+            break;
+        }
+
+#    if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+        if (ascii_code == '\a') {
+            PLAY_SONG(bell_song);
+            async_queue_pop();
+            continue;
+        }
+#    endif
+
+        uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+        uint8_t mods    = (PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code) ? MOD_BIT(KC_LEFT_SHIFT) : 0) | (PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code) ? MOD_BIT(KC_RIGHT_ALT) : 0);
+        if (keycode == KC_NO) {
+            async_queue_pop();
+            continue;
+        }
+        if (!async_can_add_key(keycode, mods)) {
+            break;
+        }
+        async_queue_pop();
+        async_add_key(keycode, mods);
+        if (PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code)) {
+            async_dead_key = true;
+            break;
+        }
+    }
+}
+
+static void async_press_keys(void) {
+    if (async_dead_key) {
+        // The space completing a dead key is pressed on its own, as other keys would combine with the dead key instead
+        async_dead_key = false;
+        async_add_key(KC_SPACE, 0);
+    } else {
+        async_gather_keys();
+    }
+
+    if (async_key_count) {
+        async_mods_owned = async_mods & ~get_weak_mods();
+        add_weak_mods(async_mods_owned);
+        async_keys_owned = 0;
+        for (uint8_t i = 0; i < async_key_count; i++) {
+            if (!is_key_pressed(async_keys[i])) {
+                async_keys_owned |= 1 << i;
+                add_key(async_keys[i]);
+            }
+        }
+        send_keyboard_report();
+    }
+}
+
+static void async_release_keys(void) {
+    if (async_code != KC_NO) {
+        unregister_code(async_code);
+        async_code = KC_NO;
+    }
+    if (async_key_count) {
+        for (uint8_t i = 0; i < async_key_count; i++) {
+            if (async_keys_owned & (1 << i)) {
+                del_key(async_keys[i]);
+            }
+        }
+        del_weak_mods(async_mods_owned);
+        send_keyboard_report();
+        async_key_count = 0;
+    }
+}
+
+bool send_string_async_next_deadline(uint32_t *deadline) {
+    if (!send_string_async_pending()) {
+        return false;
+    }
+    uint16_t elapsed = timer_elapsed(async_step_time);
+    *deadline        = timer_read32() + (elapsed >= async_step_delay ? 0 : async_step_delay - elapsed);
+    return true;
+}
+
+void send_string_task(void) {
+    if (!send_string_async_pending() || timer_elapsed(async_step_time) < async_step_delay) {
+        return;
+    }
+    async_step_time  = timer_read();
+    async_step_delay = TAP_CODE_DELAY;
+
+    if (async_key_count || async_code != KC_NO) {
+        async_release_keys();
+    } else {
+        async_press_keys();
+    }
+}
+#endif
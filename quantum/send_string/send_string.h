@@ -161,4 +161,49 @@ void send_string_with_delay_P(const char *string, uint8_t interval);
  */
 #define SEND_STRING_DELAY(string, interval) send_string_with_delay_P(PSTR(string), interval)
 
+#if defined(SENDSTRING_ASYNC) || defined(__DOXYGEN__)
+#    include <stdbool.h>
+
+#    ifndef SENDSTRING_ASYNC_BUFFER_SIZE
+#        define SENDSTRING_ASYNC_BUFFER_SIZE 128
+#    endif
+
+/**
+ * \brief Queue a string of ASCII characters to be typed out in the background.
+ *
+ * Unlike send_string(), this returns immediately, and keeps the keyboard responsive while the string is typed.
+ * Consecutive characters are pressed together in the same report until a key repeats or the modifiers change.
+ *
+ * \param string The string to type out.
+ * \return false if the string doesn't fit in the queue, in which case none of it is queued.
+ */
+bool send_string_async(const char *string);
+
+/**
+ * \brief Whether any queued characters are still being typed.
+ */
+bool send_string_async_pending(void);
+
+void send_string_task(void);
+bool send_string_async_next_deadline(uint32_t *deadline);
+
+#    if defined(__AVR__) || defined(__DOXYGEN__)
+/**
+ * \brief Queue a PROGMEM string of ASCII characters to be typed out in the background.
+ *
+ * On ARM devices, this function is simply an alias for send_string_async(string).
+ *
+ * \param string The string to type out.
+ */
+bool send_string_async_P(const char *string);
+#    else
+#        define send_string_async_P(string) send_string_async(string)
+#    endif
+
+/**
+ * \brief Shortcut macro for send_string_async_P(PSTR(string)).
+ */
+#    define SEND_STRING_ASYNC(string) send_string_async_P(PSTR(string))
+#endif
+
 /** \} */
@@ -97,6 +97,18 @@ void slave_rpc_exec_callback(uint8_t initiator2target_buffer_size, const void *i
 ////////////////////////////////////////////////////
 // Helpers
 
+// Soonest forced synchronisation, gathered while running the master transactions
+static bool     forced_sync_pending  = false;
+static uint32_t forced_sync_deadline = 0;
+
+static void track_forced_sync(uint32_t last_update) {
+    uint32_t deadline = last_update + FORCED_SYNC_THROTTLE_MS;
+    if (!forced_sync_pending || !timer_expired32(deadline, forced_sync_deadline)) {
+        forced_sync_deadline = deadline;
+    }
+    forced_sync_pending = true;
+}
+
 static bool transaction_handler_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[], const char *prefix, bool (*handler)(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])) {
     int num_retries = is_transport_connected() ? 10 : 1;
     for (int iter = 1; iter <= num_retries; ++iter) {
@@ -156,6 +168,7 @@ inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t tr
     } else {
         memcpy(destination, equiv_shmem, length);
     }
+    track_forced_sync(*last_update);
     return okay;
 }
 
@@ -167,6 +180,7 @@ inline static bool send_if_condition(int8_t trans_id, uint32_t *last_update, boo
             *last_update = timer_read32();
         }
     }
+    track_forced_sync(*last_update);
     return okay;
 }
 
@@ -307,6 +321,7 @@ static bool sync_timer_handlers_master(matrix_row_t master_matrix[], matrix_row_
             last_update = timer_read32();
         }
     }
+    track_forced_sync(last_update);
     return okay;
 }
 
@@ -432,6 +447,7 @@ static bool mods_handlers_master(matrix_row_t master_matrix[], matrix_row_t slav
             last_update = timer_read32();
         }
     }
+    track_forced_sync(last_update);
 
     return okay;
 }
@@ -955,6 +971,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 };
 
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    forced_sync_pending = false;
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
     TRANSACTIONS_ENCODERS_MASTER();
@@ -977,6 +994,14 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     return true;
 }
 
+bool transactions_next_deadline(uint32_t *deadline) {
+    if (!forced_sync_pending) {
+        return false;
+    }
+    *deadline = forced_sync_deadline;
+    return true;
+}
+
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     TRANSACTIONS_SLAVE_MATRIX_SLAVE();
     TRANSACTIONS_MASTER_MATRIX_SLAVE();
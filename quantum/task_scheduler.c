@@ -0,0 +1,118 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "task_scheduler.h"
+#include "timer.h"
+
+#ifdef TASK_SCHEDULER_STATISTICS
+#    include "debug.h"
+#endif
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#endif
+
+#if defined(PROTOCOL_CHIBIOS) && PORT_SUPPORTS_RT == TRUE && REALTIME_COUNTER_CLOCK >= 1000000
+#    define TASK_SCHEDULER_CYCLES_PER_US (REALTIME_COUNTER_CLOCK / 1000000)
+
+__attribute__((weak)) uint32_t task_scheduler_time_us(void) {
+    // The realtime counter wraps every 2^32 cycles rather than every 2^32us, so the elapsed cycles are accumulated
+    // into a microsecond count instead -- this is called far more often than the counter wraps
+    static rtcnt_t  last_cycles;
+    static uint32_t pending_cycles;
+    static uint32_t now_us;
+
+    rtcnt_t cycles = chSysGetRealtimeCounterX();
+    pending_cycles += cycles - last_cycles;
+    last_cycles = cycles;
+
+    uint32_t elapsed_us = pending_cycles / TASK_SCHEDULER_CYCLES_PER_US;
+    pending_cycles -= elapsed_us * TASK_SCHEDULER_CYCLES_PER_US;
+    now_us += elapsed_us;
+    return now_us;
+}
+#else
+__attribute__((weak)) uint32_t task_scheduler_time_us(void) {
+    // Multiplying keeps differences correct across the wrap of both the millisecond timer and the result
+    return timer_read32() * 1000;
+}
+#endif
+
+// Time is only measured if something needs it
+#if defined(TASK_SCHEDULER_STATISTICS) || TASK_SCHEDULER_LOOP_BUDGET_US > 0
+#    define TASK_SCHEDULER_ALWAYS_MEASURE true
+#else
+#    define TASK_SCHEDULER_ALWAYS_MEASURE false
+#endif
+
+void task_scheduler_run(const task_descriptor_t *tasks, task_state_t *states, uint8_t count) {
+    uint32_t now_ms = timer_read32();
+#if TASK_SCHEDULER_LOOP_BUDGET_US > 0
+    uint32_t loop_start = task_scheduler_time_us();
+#endif
+
+    for (uint8_t i = 0; i < count; ++i) {
+        const task_descriptor_t *desc  = &tasks[i];
+        task_state_t            *state = &states[i];
+
+        if (desc->period_ms > 0 && !timer_expired32(now_ms, state->next_run)) {
+            continue;
+        }
+
+        if (desc->priority != TASK_PRIORITY_CRITICAL && state->deferrals_in_a_row < TASK_SCHEDULER_MAX_DEFERRALS) {
+            bool defer = state->overran;
+#if TASK_SCHEDULER_LOOP_BUDGET_US > 0
+            defer = defer || (desc->priority == TASK_PRIORITY_COSMETIC && (task_scheduler_time_us() - loop_start) >= TASK_SCHEDULER_LOOP_BUDGET_US);
+#endif
+            if (defer) {
+                state->overran = false;
+                ++state->deferrals_in_a_row;
+#ifdef TASK_SCHEDULER_STATISTICS
+                ++state->stats.deferrals;
+#endif
+                continue;
+            }
+        }
+
+        bool     measure = TASK_SCHEDULER_ALWAYS_MEASURE || desc->budget_us > 0;
+        uint32_t start   = measure ? task_scheduler_time_us() : 0;
+
+        desc->task();
+
+        state->deferrals_in_a_row = 0;
+        state->overran            = false;
+        if (desc->period_ms > 0) {
+            state->next_run = now_ms + desc->period_ms;
+        }
+
+        if (measure) {
+            uint32_t elapsed = task_scheduler_time_us() - start;
+            if (desc->budget_us > 0 && elapsed > desc->budget_us) {
+                // Critical tasks are never skipped, but the overrun is still recorded
+                state->overran = desc->priority != TASK_PRIORITY_CRITICAL;
+#ifdef TASK_SCHEDULER_STATISTICS
+                ++state->stats.overruns;
+#endif
+            }
+#ifdef TASK_SCHEDULER_STATISTICS
+            ++state->stats.runs;
+            state->stats.total_us += elapsed;
+            if (elapsed > state->stats.max_us) {
+                state->stats.max_us = elapsed;
+            }
+#else
+            (void)elapsed;
+#endif
+        }
+    }
+}
+
+#ifdef TASK_SCHEDULER_STATISTICS
+void task_scheduler_print_statistics(const task_descriptor_t *tasks, const task_state_t *states, uint8_t count) {
+    for (uint8_t i = 0; i < count; ++i) {
+        const task_statistics_t *stats = &states[i].stats;
+        dprintf("%-24s runs:%lu deferred:%lu overruns:%lu avg:%luus max:%luus\n", tasks[i].name, (unsigned long)stats->runs, (unsigned long)stats->deferrals, (unsigned long)stats->overruns, (unsigned long)(stats->runs ? stats->total_us / stats->runs : 0), (unsigned long)stats->max_us);
+        (void)stats;
+    }
+}
+#endif
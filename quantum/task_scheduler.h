@@ -0,0 +1,97 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \file
+ *
+ * \defgroup task_scheduler Cooperative task scheduler
+ *
+ * \brief Runs a registry of tasks in order, honouring each task's period, priority and optional time budget.
+ *
+ * Critical tasks run whenever they are due. Normal tasks also run whenever they are due, but skip their next run if
+ * they exceeded their own budget. Cosmetic tasks are additionally deferred to a later loop if the loop has already
+ * used up TASK_SCHEDULER_LOOP_BUDGET_US, though never more than TASK_SCHEDULER_MAX_DEFERRALS times in a row.
+ *
+ * \{
+ */
+
+/** \brief Time allowed for a single pass of the scheduler before cosmetic tasks are deferred, 0 to disable
+ */
+#ifndef TASK_SCHEDULER_LOOP_BUDGET_US
+#    define TASK_SCHEDULER_LOOP_BUDGET_US 0
+#endif
+
+/** \brief Maximum number of consecutive passes a task may be deferred or skipped for
+ */
+#ifndef TASK_SCHEDULER_MAX_DEFERRALS
+#    define TASK_SCHEDULER_MAX_DEFERRALS 8
+#endif
+
+typedef enum task_priority_t {
+    TASK_PRIORITY_CRITICAL,
+    TASK_PRIORITY_NORMAL,
+    TASK_PRIORITY_COSMETIC,
+} task_priority_t;
+
+typedef struct task_descriptor_t {
+    void (*task)(void);
+#ifdef TASK_SCHEDULER_STATISTICS
+    const char *name;
+#endif
+    uint16_t period_ms; // minimum time between runs, 0 to run on every pass
+    uint16_t budget_us; // time the task is expected to complete within, 0 for no budget
+    uint8_t  priority;  // task_priority_t
+} task_descriptor_t;
+
+typedef struct task_statistics_t {
+    uint32_t runs;
+    uint32_t deferrals;
+    uint32_t overruns;
+    uint64_t total_us;
+    uint32_t max_us;
+} task_statistics_t;
+
+typedef struct task_state_t {
+    uint32_t next_run;
+    uint8_t  deferrals_in_a_row;
+    bool     overran;
+#ifdef TASK_SCHEDULER_STATISTICS
+    task_statistics_t stats;
+#endif
+} task_state_t;
+
+#ifdef TASK_SCHEDULER_STATISTICS
+#    define TASK_DESCRIPTOR(fn, prio, period, budget) \
+        { .task = fn, .name = #fn, .period_ms = period, .budget_us = budget, .priority = prio }
+#else
+#    define TASK_DESCRIPTOR(fn, prio, period, budget) \
+        { .task = fn, .period_ms = period, .budget_us = budget, .priority = prio }
+#endif
+
+/** \brief Run a single pass over a registry of tasks
+ *
+ * \param tasks the task registry
+ * \param states the state for each task in the registry, zero-initialised before the first pass
+ * \param count the number of tasks in the registry
+ */
+void task_scheduler_run(const task_descriptor_t *tasks, task_state_t *states, uint8_t count);
+
+/** \brief Timestamp used to measure task runtime, in microseconds
+ *
+ * Wraps at 2^32 microseconds, so only differences are meaningful. Where no cycle counter is available, the default
+ * implementation is only as precise as timer_read32().
+ */
+uint32_t task_scheduler_time_us(void);
+
+#ifdef TASK_SCHEDULER_STATISTICS
+/** \brief Print statistics for each task in a registry to the console
+ */
+void task_scheduler_print_statistics(const task_descriptor_t *tasks, const task_state_t *states, uint8_t count);
+#endif
+
+/** \} */
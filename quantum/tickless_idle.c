@@ -0,0 +1,78 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "tickless_idle.h"
+#include "keyboard.h"
+#include "timer.h"
+
+static volatile bool wake_requested = false;
+static bool          awake          = false;
+static uint32_t      last_wake      = 0;
+
+bool tickless_idle_next_deadline(uint32_t *deadline) {
+    return keyboard_next_deadline(deadline);
+}
+
+__attribute__((weak)) bool tickless_idle_matrix_arm(void) {
+    return false;
+}
+
+__attribute__((weak)) void tickless_idle_matrix_disarm(void) {}
+
+static uint32_t tickless_idle_timeout_capped(uint32_t max_sleep_ms) {
+    uint32_t now = timer_read32();
+
+    if (wake_requested) {
+        wake_requested = false;
+        awake          = true;
+        last_wake      = now;
+    }
+    if (awake && TIMER_DIFF_32(now, last_wake) >= TICKLESS_IDLE_ACTIVITY_TIMEOUT) {
+        awake = false;
+    }
+
+    // Stay awake while input is being processed, to let debounce and the like settle
+    if (awake || last_input_activity_elapsed() < TICKLESS_IDLE_ACTIVITY_TIMEOUT) {
+        return 0;
+    }
+
+    uint32_t timeout = max_sleep_ms;
+    uint32_t deadline;
+    if (tickless_idle_next_deadline(&deadline)) {
+        if (timer_expired32(now, deadline)) {
+            return 0;
+        }
+        if (deadline - now < timeout) {
+            timeout = deadline - now;
+        }
+    }
+    return timeout;
+}
+
+uint32_t tickless_idle_timeout(void) {
+    return tickless_idle_timeout_capped(TICKLESS_IDLE_MAX_SLEEP_MS);
+}
+
+void tickless_idle_wake(void) {
+    wake_requested = true;
+    tickless_idle_platform_wake();
+}
+
+void tickless_idle_task(void) {
+    uint32_t timeout = tickless_idle_timeout();
+    if (timeout == 0) {
+        return;
+    }
+
+    if (!tickless_idle_matrix_arm()) {
+        tickless_idle_platform_wait(timeout);
+        return;
+    }
+
+    // Key changes end the wait, so it can last until the next deadline
+    timeout = tickless_idle_timeout_capped(TICKLESS_IDLE_MATRIX_WAKE_MAX_SLEEP_MS);
+    if (timeout > 0) {
+        tickless_idle_platform_wait(timeout);
+    }
+    tickless_idle_matrix_disarm();
+}
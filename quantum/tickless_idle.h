@@ -0,0 +1,85 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \file
+ *
+ * \defgroup tickless_idle Tickless idle
+ *
+ * \brief Lets the main loop wait in a low power state until the next known deadline.
+ *
+ * Each pass of the main loop, the soonest deadline across debouncing, the tapping state machine, combos, leader
+ * sequences, tap dances, deferred executions, mouse keys, RGB Light animations, RGB/LED Matrix frames and split
+ * synchronisation is determined. If nothing is due immediately, the platform waits until that deadline, or until
+ * tickless_idle_wake() is called -- typically from a matrix interrupt.
+ *
+ * \{
+ */
+
+/** \brief Upper bound for a single wait, so that keyboards without matrix interrupts still scan regularly
+ */
+#ifndef TICKLESS_IDLE_MAX_SLEEP_MS
+#    define TICKLESS_IDLE_MAX_SLEEP_MS 1
+#endif
+
+/** \brief Upper bound for a single wait while the matrix is armed to wake the keyboard, see tickless_idle_matrix_arm()
+ */
+#ifndef TICKLESS_IDLE_MATRIX_WAKE_MAX_SLEEP_MS
+#    define TICKLESS_IDLE_MATRIX_WAKE_MAX_SLEEP_MS 100
+#endif
+
+/** \brief Time after input activity or a wakeup during which the keyboard stays awake, covering debounce and typing bursts
+ */
+#ifndef TICKLESS_IDLE_ACTIVITY_TIMEOUT
+#    define TICKLESS_IDLE_ACTIVITY_TIMEOUT 50
+#endif
+
+/** \brief Determine the soonest deadline across all features with pending timers
+ *
+ * \param deadline[out] the soonest deadline -- equivalent time-space as timer_read32()
+ * \return true if any feature has a pending deadline, otherwise false
+ */
+bool tickless_idle_next_deadline(uint32_t *deadline);
+
+/** \brief Determine how long the main loop may currently wait for, without matrix wakeups
+ *
+ * \return the number of milliseconds to wait, at most TICKLESS_IDLE_MAX_SLEEP_MS, or 0 if there is work to do
+ */
+uint32_t tickless_idle_timeout(void);
+
+/** \brief Request that a wait in progress ends early, safe to call from interrupt context
+ */
+void tickless_idle_wake(void);
+
+/** \brief Wait until the next deadline, called at the end of each pass of the main loop
+ */
+void tickless_idle_task(void);
+
+/** \brief Prepare the matrix so that any key changing state calls tickless_idle_wake(), before a wait
+ *
+ * The default matrix implements this on ChibiOS when TICKLESS_IDLE_MATRIX_WAKE is defined, and otherwise it does
+ * nothing.
+ *
+ * \return true if armed, allowing waits of up to TICKLESS_IDLE_MATRIX_WAKE_MAX_SLEEP_MS, or false if a key change
+ * could go unnoticed -- for example because a key is already held
+ */
+bool tickless_idle_matrix_arm(void);
+
+/** \brief Restore the matrix for scanning after a wait, only called if tickless_idle_matrix_arm() returned true
+ */
+void tickless_idle_matrix_disarm(void);
+
+/** \brief Platform specific wait, ending after timeout_ms or when tickless_idle_platform_wake() is called
+ */
+void tickless_idle_platform_wait(uint32_t timeout_ms);
+
+/** \brief Platform specific wakeup, safe to call from interrupt context
+ */
+void tickless_idle_platform_wake(void);
+
+/** \} */
@@ -33,6 +33,10 @@
 #include "wait.h"
 #include "version.h" // for QMK_BUILDDATE used in EEPROM magic
 
+#ifdef RAW_HID_STREAM_ENABLE
+#    include "raw_hid_stream.h"
+#endif
+
 #if defined(AUDIO_ENABLE)
 #    include "audio.h"
 #endif
@@ -280,6 +284,13 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
     uint8_t *command_id   = &(data[0]);
     uint8_t *command_data = &(data[1]);
 
+#ifdef RAW_HID_STREAM_ENABLE
+    // Stream frames share the endpoint, under an id VIA does not use
+    if (raw_hid_stream_receive(data, length)) {
+        return;
+    }
+#endif
+
     // If via_command_kb() returns true, the command was fully
     // handled, including calling raw_hid_send()
     if (via_command_kb(data, length)) {
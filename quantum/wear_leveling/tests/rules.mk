@@ -32,6 +32,18 @@ wear_leveling_2byte_optimized_writes_SRC := \
 wear_leveling_2byte_optimized_writes_INC := \
 	$(wear_leveling_common_INC)
 
+wear_leveling_2byte_checkpoints_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=16384 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=1024 \
+	-DWEAR_LEVELING_CHECKPOINT_INTERVAL=4096
+wear_leveling_2byte_checkpoints_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_2byte_checkpoints.cpp
+wear_leveling_2byte_checkpoints_INC := \
+	$(wear_leveling_common_INC)
+
 wear_leveling_2byte_DEFS := \
 	$(wear_leveling_common_DEFS) \
 	-DBACKING_STORE_WRITE_SIZE=2 \
@@ -63,4 +75,48 @@ wear_leveling_8byte_SRC := \
 	$(wear_leveling_common_SRC) \
 	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_8byte.cpp
 wear_leveling_8byte_INC := \
-	$(wear_leveling_common_INC)
\ No newline at end of file
+	$(wear_leveling_common_INC)
+
+wear_leveling_simulation_2byte_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=8192 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=4096
+wear_leveling_simulation_2byte_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_simulation.cpp
+wear_leveling_simulation_2byte_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_simulation_2byte_legacy_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=16384 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=1024
+wear_leveling_simulation_2byte_legacy_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_simulation.cpp
+wear_leveling_simulation_2byte_legacy_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_simulation_4byte_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=4 \
+	-DWEAR_LEVELING_BACKING_SIZE=2048 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=1024
+wear_leveling_simulation_4byte_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_simulation.cpp
+wear_leveling_simulation_4byte_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_simulation_8byte_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=8 \
+	-DWEAR_LEVELING_BACKING_SIZE=4096 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=2048
+wear_leveling_simulation_8byte_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_simulation.cpp
+wear_leveling_simulation_8byte_INC := \
+	$(wear_leveling_common_INC)
@@ -1,6 +1,11 @@
 TEST_LIST += \
 	wear_leveling_general \
 	wear_leveling_2byte_optimized_writes \
+	wear_leveling_2byte_checkpoints \
 	wear_leveling_2byte \
 	wear_leveling_4byte \
-	wear_leveling_8byte
+	wear_leveling_8byte \
+	wear_leveling_simulation_2byte \
+	wear_leveling_simulation_2byte_legacy \
+	wear_leveling_simulation_4byte \
+	wear_leveling_simulation_8byte
@@ -0,0 +1,218 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <chrono>
+#include <cstdio>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+class WearLeveling2ByteCheckpoints : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+        verify_data.fill(0);
+    }
+
+    static std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> verify_data;
+};
+
+std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> WearLeveling2ByteCheckpoints::verify_data;
+
+// Start of the write log, after the consolidated data and its FNV1a_64
+using LOG_START = std::integral_constant<std::uint32_t, WEAR_LEVELING_LOGICAL_SIZE + 8>;
+
+// Upper bound on backing store reads during init when checkpoints are in use -- checkpoint probes, one snapshot or the
+// consolidated area with its checksum, and at most a single checkpoint interval of write log
+using MAX_INIT_READS = std::integral_constant<std::uint64_t, (WEAR_LEVELING_CHECKPOINT_COUNT) + ((WEAR_LEVELING_CHECKPOINT_RECORD_SIZE) + (WEAR_LEVELING_CHECKPOINT_INTERVAL)) / BACKING_STORE_WRITE_SIZE + 1>;
+
+/**
+ * Writes a 4-byte value that is guaranteed to generate a single 4-word multibyte log entry.
+ */
+static wear_leveling_status_t test_write_multibyte(std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE>& verify_data, std::uint32_t counter) {
+    const std::uint32_t address  = 64 + ((counter * 4) % (WEAR_LEVELING_LOGICAL_SIZE - 64));
+    const std::uint8_t  value[4] = {(std::uint8_t)(0x10 + (counter & 0x7F)), 0x20, (std::uint8_t)(0x30 + (counter >> 7)), 0x40};
+    memcpy(&verify_data[address], value, sizeof(value));
+    return wear_leveling_write(address, value, sizeof(value));
+}
+
+/**
+ * Returns the number of bytes of the write log that have been used.
+ * Checkpoint snapshots may legitimately contain zeros, so search backwards for the last written element.
+ */
+static std::uint32_t log_bytes_used(void) {
+    auto& inst  = MockBackingStore::Instance();
+    auto  first = inst.storage_begin() + (LOG_START::value / BACKING_STORE_WRITE_SIZE);
+    auto  last  = std::find_if(std::make_reverse_iterator(inst.storage_end()), std::make_reverse_iterator(first), [](const MockBackingStoreElement& e) { return !e.is_erased(); });
+    return (std::uint32_t)std::distance(first, last.base()) * BACKING_STORE_WRITE_SIZE;
+}
+
+/**
+ * Reads a write log entry directly from the backing store.
+ */
+static write_log_entry_t read_log_entry(std::uint32_t address) {
+    write_log_entry_t e;
+    e.raw64 = 0;
+    MockBackingStore::Instance().read(address, e.raw16[0]);
+    return e;
+}
+
+/**
+ * This test verifies that a checkpoint record is placed at the first checkpoint location, with a valid checksum.
+ */
+TEST_F(WearLeveling2ByteCheckpoints, CheckpointWrittenAtInterval) {
+    const std::uint32_t checkpoint_address = LOG_START::value + WEAR_LEVELING_CHECKPOINT_INTERVAL;
+
+    std::uint32_t counter = 0;
+    while (log_bytes_used() <= checkpoint_address - LOG_START::value) {
+        EXPECT_EQ(test_write_multibyte(verify_data, counter++), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    }
+
+    auto header = read_log_entry(checkpoint_address);
+    EXPECT_EQ(LOG_ENTRY_GET_TYPE(header), LOG_ENTRY_TYPE_CHECKPOINT) << "Invalid checkpoint entry type";
+    EXPECT_TRUE(LOG_ENTRY_CHECKPOINT_IS_SNAPSHOT(header)) << "Checkpoint entry was not a snapshot";
+
+    // Verify the FNV1a_64 of the snapshot matches the snapshot
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> snapshot;
+    for (std::size_t i = 0; i < WEAR_LEVELING_LOGICAL_SIZE; i += BACKING_STORE_WRITE_SIZE) {
+        MockBackingStore::Instance().read(checkpoint_address + BACKING_STORE_WRITE_SIZE + i, *(backing_store_int_t*)&snapshot[i]);
+    }
+    write_log_entry_t hash;
+    for (std::size_t i = 0; i < 4; ++i) {
+        MockBackingStore::Instance().read(checkpoint_address + BACKING_STORE_WRITE_SIZE + WEAR_LEVELING_LOGICAL_SIZE + (i * BACKING_STORE_WRITE_SIZE), hash.raw16[i]);
+    }
+    EXPECT_EQ(hash.raw64, fnv_64a_buf(snapshot.data(), snapshot.size(), FNV1A_64_INIT)) << "Invalid checkpoint checksum";
+}
+
+/**
+ * This test verifies that log entries never straddle a checkpoint location, and padding is used to fill the gap.
+ */
+TEST_F(WearLeveling2ByteCheckpoints, PaddingBeforeCheckpoint) {
+    // Two checkpoints, as the second checkpoint requires padding due to the record size
+    const std::uint32_t checkpoint_address = LOG_START::value + (2 * WEAR_LEVELING_CHECKPOINT_INTERVAL);
+    _Static_assert(((WEAR_LEVELING_CHECKPOINT_INTERVAL - WEAR_LEVELING_CHECKPOINT_RECORD_SIZE) % 8) != 0, "Test requires padding before the second checkpoint");
+
+    std::uint32_t counter = 0;
+    while (log_bytes_used() <= checkpoint_address - LOG_START::value) {
+        EXPECT_EQ(test_write_multibyte(verify_data, counter++), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    }
+
+    auto padding = read_log_entry(checkpoint_address - BACKING_STORE_WRITE_SIZE);
+    EXPECT_EQ(LOG_ENTRY_GET_TYPE(padding), LOG_ENTRY_TYPE_CHECKPOINT) << "Invalid padding entry type";
+    EXPECT_FALSE(LOG_ENTRY_CHECKPOINT_IS_SNAPSHOT(padding)) << "Padding entry was a snapshot";
+
+    auto header = read_log_entry(checkpoint_address);
+    EXPECT_EQ(LOG_ENTRY_GET_TYPE(header), LOG_ENTRY_TYPE_CHECKPOINT) << "Invalid checkpoint entry type";
+    EXPECT_TRUE(LOG_ENTRY_CHECKPOINT_IS_SNAPSHOT(header)) << "Checkpoint entry was not a snapshot";
+}
+
+/**
+ * This test verifies that data is restored correctly from the latest checkpoint plus the write log following it.
+ */
+TEST_F(WearLeveling2ByteCheckpoints, RestoreFromCheckpoint) {
+    auto& inst = MockBackingStore::Instance();
+
+    std::uint32_t counter = 0;
+    while (log_bytes_used() <= (2 * WEAR_LEVELING_CHECKPOINT_INTERVAL) + 256) {
+        EXPECT_EQ(test_write_multibyte(verify_data, counter++), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    }
+    EXPECT_EQ(inst.erasure_count(), 0) << "Consolidation should not have occurred";
+
+    // Re-init and re-read, verifying the reload capability
+    std::uint64_t reads_before = inst.read_invoke_count();
+    EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Re-initialisation failed";
+    EXPECT_LE(inst.read_invoke_count() - reads_before, MAX_INIT_READS::value) << "Init did not start playback from the checkpoint";
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+    EXPECT_EQ(wear_leveling_read(0, readback.data(), WEAR_LEVELING_LOGICAL_SIZE), WEAR_LEVELING_SUCCESS) << "Failed to read back the saved data";
+    EXPECT_TRUE(memcmp(readback.data(), verify_data.data(), WEAR_LEVELING_LOGICAL_SIZE) == 0) << "Readback did not match";
+
+    // Subsequent writes should land after the existing log
+    EXPECT_EQ(test_write_multibyte(verify_data, counter++), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Re-initialisation failed";
+    EXPECT_EQ(wear_leveling_read(0, readback.data(), WEAR_LEVELING_LOGICAL_SIZE), WEAR_LEVELING_SUCCESS) << "Failed to read back the saved data";
+    EXPECT_TRUE(memcmp(readback.data(), verify_data.data(), WEAR_LEVELING_LOGICAL_SIZE) == 0) << "Readback did not match";
+}
+
+/**
+ * This test verifies that a corrupted checkpoint is ignored, falling back to an earlier checkpoint.
+ */
+TEST_F(WearLeveling2ByteCheckpoints, CorruptCheckpoint_Ignored) {
+    auto& inst = MockBackingStore::Instance();
+
+    std::uint32_t counter = 0;
+    while (log_bytes_used() <= (2 * WEAR_LEVELING_CHECKPOINT_INTERVAL) + 256) {
+        EXPECT_EQ(test_write_multibyte(verify_data, counter++), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    }
+
+    // Corrupt the snapshot inside the second checkpoint
+    auto element = inst.storage_begin() + ((LOG_START::value + (2 * WEAR_LEVELING_CHECKPOINT_INTERVAL) + BACKING_STORE_WRITE_SIZE + 128) / BACKING_STORE_WRITE_SIZE);
+    auto value   = element->get();
+    element->erase();
+    element->set(value ^ 0x5A5A);
+
+    EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Re-initialisation failed";
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+    EXPECT_EQ(wear_leveling_read(0, readback.data(), WEAR_LEVELING_LOGICAL_SIZE), WEAR_LEVELING_SUCCESS) << "Failed to read back the saved data";
+    EXPECT_TRUE(memcmp(readback.data(), verify_data.data(), WEAR_LEVELING_LOGICAL_SIZE) == 0) << "Readback did not match";
+}
+
+/**
+ * This test verifies that data is preserved across consolidation when checkpoints are in use.
+ */
+TEST_F(WearLeveling2ByteCheckpoints, ConsolidationPreservesData) {
+    auto& inst = MockBackingStore::Instance();
+
+    std::uint32_t counter = 0;
+    while (inst.erasure_count() == 0) {
+        EXPECT_NE(test_write_multibyte(verify_data, counter++), WEAR_LEVELING_FAILED) << "Write returned incorrect status";
+    }
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(test_write_multibyte(verify_data, counter++), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    }
+
+    EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Re-initialisation failed";
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+    EXPECT_EQ(wear_leveling_read(0, readback.data(), WEAR_LEVELING_LOGICAL_SIZE), WEAR_LEVELING_SUCCESS) << "Failed to read back the saved data";
+    EXPECT_TRUE(memcmp(readback.data(), verify_data.data(), WEAR_LEVELING_LOGICAL_SIZE) == 0) << "Readback did not match";
+}
+
+/**
+ * Benchmark: init time and backing store reads against write log fill level.
+ */
+TEST_F(WearLeveling2ByteCheckpoints, Benchmark_InitTimeVsFillLevel) {
+    auto&               inst       = MockBackingStore::Instance();
+    const std::uint32_t log_size   = WEAR_LEVELING_BACKING_SIZE - LOG_START::value;
+    const int           iterations = 100;
+
+    printf("  fill | log bytes | reads (checkpointed) | reads (full playback) | init time (us)\n");
+    for (int percent = 0; percent <= 90; percent += 10) {
+        inst.reset_instance();
+        wear_leveling_init();
+        verify_data.fill(0);
+
+        std::uint32_t counter = 0;
+        while (log_bytes_used() < (log_size * percent) / 100) {
+            EXPECT_EQ(test_write_multibyte(verify_data, counter++), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+        }
+        EXPECT_EQ(inst.erasure_count(), 0) << "Consolidation should not have occurred";
+
+        std::uint64_t reads_before = inst.read_invoke_count();
+        auto          start        = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Re-initialisation failed";
+        }
+        auto          elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+        std::uint64_t reads   = (inst.read_invoke_count() - reads_before) / iterations;
+
+        // Without checkpoints, the consolidated area, its checksum, and every used word of the log plus the terminator are read
+        std::uint64_t full_reads = (LOG_START::value + log_bytes_used()) / BACKING_STORE_WRITE_SIZE + 1;
+        printf("  %3d%% | %9u | %20llu | %21llu | %14.2f\n", percent, (unsigned)log_bytes_used(), (unsigned long long)reads, (unsigned long long)full_reads, elapsed);
+
+        EXPECT_LE(reads, MAX_INIT_READS::value) << "Init reads were not bounded by the checkpoint interval";
+
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+        EXPECT_EQ(wear_leveling_read(0, readback.data(), WEAR_LEVELING_LOGICAL_SIZE), WEAR_LEVELING_SUCCESS) << "Failed to read back the saved data";
+        EXPECT_TRUE(memcmp(readback.data(), verify_data.data(), WEAR_LEVELING_LOGICAL_SIZE) == 0) << "Readback did not match";
+    }
+}
@@ -0,0 +1,236 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+/*
+    Host-side endurance and write-amplification simulation.
+
+    Each workload below approximates one day of real-world usage of the eeconfig and VIA subsystems, issuing writes the
+    same way those subsystems do (eeprom_update_* comparing before writing, dynamic keymap writes being byte-by-byte,
+    etc.). The workload is replayed for WL_SIM_DAYS simulated days against the mock backing store, and the following is
+    reported for the backing store configuration this file was compiled with:
+
+        - logical bytes changed by the workload
+        - bytes programmed into the backing store
+        - write amplification (bytes programmed / logical bytes changed)
+        - erase count of the backing store
+        - worst-case single call cost, in backing store writes/erases, modelled time, and host time
+        - projected lifetime of the backing store, given its erase endurance
+
+    Configurables, for modelling different flash technologies:
+
+        - WL_SIM_DAYS: number of days to simulate
+        - WL_SIM_WRITE_TIME_US: time taken by a single backing store write
+        - WL_SIM_ERASE_TIME_US: time taken by a full erase of the backing store
+        - WL_SIM_ENDURANCE_CYCLES: number of erase cycles the backing store is rated for
+*/
+
+#ifndef WL_SIM_DAYS
+#    define WL_SIM_DAYS 365
+#endif
+
+#ifndef WL_SIM_WRITE_TIME_US
+#    define WL_SIM_WRITE_TIME_US 50
+#endif
+
+#ifndef WL_SIM_ERASE_TIME_US
+#    define WL_SIM_ERASE_TIME_US 40000
+#endif
+
+#ifndef WL_SIM_ENDURANCE_CYCLES
+#    define WL_SIM_ENDURANCE_CYCLES 10000
+#endif
+
+// Offsets matching the eeconfig/VIA layout, see eeconfig.h and via.h
+#define SIM_EECONFIG_DEBUG 2
+#define SIM_EECONFIG_DEFAULT_LAYER 3
+#define SIM_EECONFIG_KEYMAP 4
+#define SIM_EECONFIG_RGBLIGHT 8
+#define SIM_EECONFIG_USER 19
+#define SIM_EECONFIG_RGB_MATRIX 23
+#define SIM_VIA_LAYOUT_OPTIONS 39
+#define SIM_DYNAMIC_KEYMAP 40
+#define SIM_DYNAMIC_KEYMAP_SIZE (4 * 6 * 16 * 2)
+
+_Static_assert(SIM_DYNAMIC_KEYMAP + SIM_DYNAMIC_KEYMAP_SIZE <= WEAR_LEVELING_LOGICAL_SIZE, "Simulated dynamic keymap does not fit in the logical size");
+
+class WearLevelingSimulation : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+        shadow.fill(0);
+        rng.seed(0x5EED);
+        calls = changed_bytes = worst_writes = worst_erases = 0;
+        worst_host_us = worst_model_us = 0;
+    }
+
+    void TearDown() override {
+        auto&         inst       = MockBackingStore::Instance();
+        std::uint64_t programmed = inst.total_write_count() * BACKING_STORE_WRITE_SIZE;
+        double        amp        = changed_bytes ? (double)programmed / (double)changed_bytes : 0.0;
+        double        years      = (double)WL_SIM_ENDURANCE_CYCLES * (double)WL_SIM_DAYS / (double)(inst.erasure_count() ? inst.erasure_count() : 1) / 365.0;
+
+        printf("  %-24s | %2d-byte | %8u/%-8u | %10llu | %12llu | %7.2f | %6llu | %8llu/%-2llu | %10.2f | %9.2f | %s%.1f\n", ::testing::UnitTest::GetInstance()->current_test_info()->name(), BACKING_STORE_WRITE_SIZE, (unsigned)WEAR_LEVELING_LOGICAL_SIZE, (unsigned)WEAR_LEVELING_BACKING_SIZE, (unsigned long long)changed_bytes, (unsigned long long)programmed, amp, (unsigned long long)inst.erasure_count(), (unsigned long long)worst_writes, (unsigned long long)worst_erases, worst_model_us / 1000.0, worst_host_us, inst.erasure_count() ? "" : ">=", years);
+
+        // Everything written should survive a reboot
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+        EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Re-initialisation failed";
+        EXPECT_EQ(wear_leveling_read(0, readback.data(), WEAR_LEVELING_LOGICAL_SIZE), WEAR_LEVELING_SUCCESS) << "Failed to read back the saved data";
+        EXPECT_TRUE(memcmp(readback.data(), shadow.data(), WEAR_LEVELING_LOGICAL_SIZE) == 0) << "Readback did not match";
+    }
+
+    static void SetUpTestSuite() {
+        printf("  %-24s | %-7s | %-17s | %-10s | %-12s | %-7s | %-6s | %-11s | %-10s | %-9s | %s\n", "workload", "write", "logical/backing", "changed", "programmed", "amp", "erases", "worst w/e", "worst (ms)", "host (us)", "lifetime (years)");
+    }
+
+    // Equivalent of eeprom_update_block() -- only writes if there's a difference
+    void update(std::uint32_t address, const void* value, std::size_t length) {
+        if (memcmp(&shadow[address], value, length) == 0) {
+            return;
+        }
+        changed_bytes += length;
+        memcpy(&shadow[address], value, length);
+
+        auto&         inst   = MockBackingStore::Instance();
+        std::uint64_t writes = inst.write_invoke_count();
+        std::uint64_t erases = inst.erase_invoke_count();
+        auto          start  = std::chrono::steady_clock::now();
+        EXPECT_NE(wear_leveling_write(address, value, length), WEAR_LEVELING_FAILED) << "Write failed";
+        double host_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        writes = inst.write_invoke_count() - writes;
+        erases = inst.erase_invoke_count() - erases;
+
+        double model_us = (double)writes * WL_SIM_WRITE_TIME_US + (double)erases * WL_SIM_ERASE_TIME_US;
+        if (model_us > worst_model_us) {
+            worst_model_us = model_us;
+            worst_writes   = writes;
+            worst_erases   = erases;
+        }
+        if (host_us > worst_host_us) {
+            worst_host_us = host_us;
+        }
+        ++calls;
+    }
+
+    void update_byte(std::uint32_t address, std::uint8_t value) {
+        update(address, &value, sizeof(value));
+    }
+
+    void update_word(std::uint32_t address, std::uint16_t value) {
+        update(address, &value, sizeof(value));
+    }
+
+    void update_dword(std::uint32_t address, std::uint32_t value) {
+        update(address, &value, sizeof(value));
+    }
+
+    // Equivalent of dynamic_keymap_set_keycode() -- big-endian, byte-by-byte
+    void set_keycode(std::uint32_t index, std::uint16_t keycode) {
+        update_byte(SIM_DYNAMIC_KEYMAP + (index * 2) + 0, (std::uint8_t)(keycode >> 8));
+        update_byte(SIM_DYNAMIC_KEYMAP + (index * 2) + 1, (std::uint8_t)(keycode & 0xFF));
+    }
+
+    // Mostly KC_TRNS/KC_NO on upper layers, as is the case for most keymaps
+    std::uint16_t random_keycode(std::uint32_t index) {
+        std::uint32_t layer = index / (SIM_DYNAMIC_KEYMAP_SIZE / 2 / 4);
+        std::uint32_t roll  = rng() % 100;
+        if (layer > 0 && roll < 60) {
+            return 0x0001; // KC_TRNS
+        }
+        if (roll < 70) {
+            return 0x0000; // KC_NO
+        }
+        return (std::uint16_t)(0x0004 + (rng() % 0x60));
+    }
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> shadow;
+    std::mt19937                                         rng;
+    std::uint64_t                                        calls;
+    std::uint64_t                                        changed_bytes;
+    std::uint64_t                                        worst_writes;
+    std::uint64_t                                        worst_erases;
+    double                                               worst_model_us;
+    double                                               worst_host_us;
+};
+
+/**
+ * First boot: eeconfig_init() followed by the default dynamic keymap being written, then a handful of daily changes.
+ */
+TEST_F(WearLevelingSimulation, FirstBoot) {
+    update_word(0, 0xFEE5);
+    update_word(SIM_EECONFIG_KEYMAP, 0x1400);
+    for (std::uint32_t i = 0; i < SIM_DYNAMIC_KEYMAP_SIZE / 2; ++i) {
+        set_keycode(i, random_keycode(i));
+    }
+    for (int day = 0; day < WL_SIM_DAYS; ++day) {
+        update_byte(SIM_EECONFIG_DEFAULT_LAYER, (std::uint8_t)(1 << (day % 2)));
+    }
+}
+
+/**
+ * Debug/keymap config toggles: magic keycodes, NKRO toggles, default layer changes.
+ */
+TEST_F(WearLevelingSimulation, EeconfigToggles) {
+    for (int day = 0; day < WL_SIM_DAYS; ++day) {
+        for (int i = 0; i < 20; ++i) {
+            update_word(SIM_EECONFIG_KEYMAP, (std::uint16_t)(0x1400 ^ (1 << (rng() % 16))));
+            update_byte(SIM_EECONFIG_DEBUG, (std::uint8_t)(rng() % 2));
+            update_byte(SIM_EECONFIG_DEFAULT_LAYER, (std::uint8_t)(1 << (rng() % 2)));
+        }
+    }
+}
+
+/**
+ * RGB tuning: stepping through modes, hue, saturation, brightness and speed with persistence enabled.
+ */
+TEST_F(WearLevelingSimulation, RgbTuning) {
+    for (int day = 0; day < WL_SIM_DAYS; ++day) {
+        for (int i = 0; i < 40; ++i) {
+            std::uint64_t rgb_matrix = ((std::uint64_t)(rng() % 256) << 40) | ((std::uint64_t)(rng() % 256) << 32) | ((std::uint64_t)(rng() % 256) << 24) | ((std::uint64_t)(rng() % 256) << 16) | ((rng() % 40) << 2) | 1;
+            update(SIM_EECONFIG_RGB_MATRIX, &rgb_matrix, sizeof(rgb_matrix));
+            update_dword(SIM_EECONFIG_RGBLIGHT, (std::uint32_t)rng());
+        }
+    }
+}
+
+/**
+ * VIA single key remaps, each invoking dynamic_keymap_set_keycode().
+ */
+TEST_F(WearLevelingSimulation, ViaRemap) {
+    for (int day = 0; day < WL_SIM_DAYS; ++day) {
+        for (int i = 0; i < 10; ++i) {
+            std::uint32_t index = rng() % (SIM_DYNAMIC_KEYMAP_SIZE / 2);
+            set_keycode(index, random_keycode(index));
+        }
+        update_byte(SIM_VIA_LAYOUT_OPTIONS, (std::uint8_t)(rng() % 4));
+    }
+}
+
+/**
+ * VIA keymap upload, invoking dynamic_keymap_set_buffer() for the entire keymap once per day.
+ */
+TEST_F(WearLevelingSimulation, ViaKeymapUpload) {
+    for (int day = 0; day < WL_SIM_DAYS; ++day) {
+        for (std::uint32_t i = 0; i < SIM_DYNAMIC_KEYMAP_SIZE / 2; ++i) {
+            set_keycode(i, random_keycode(i));
+        }
+    }
+}
+
+/**
+ * User config: EECONFIG_USER toggled by user code, such as persisted feature flags.
+ */
+TEST_F(WearLevelingSimulation, UserConfig) {
+    for (int day = 0; day < WL_SIM_DAYS; ++day) {
+        for (int i = 0; i < 50; ++i) {
+            update_dword(SIM_EECONFIG_USER, (std::uint32_t)(1 << (rng() % 8)));
+        }
+    }
+}
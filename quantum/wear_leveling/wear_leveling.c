@@ -61,12 +61,18 @@
             to other subsystems performing reads/writes. This must be a multiple
             of the write size.
 
+        - WEAR_LEVELING_CHECKPOINT_INTERVAL: Optional. The number of bytes of
+            write log between checkpoints. Must be a multiple of the write
+            size, and larger than a checkpoint record. See "Checkpoints" below.
+
     General algorithm:
 
         During initialization:
-            * The contents of the consolidated data section are read into cache.
-            * The contents of the write log are "played back" and update the
-                cache accordingly.
+            * If checkpoints are enabled, the latest valid checkpoint is read
+                into cache, otherwise the contents of the consolidated data
+                section are read into cache.
+            * The contents of the write log after the checkpoint (or the whole
+                write log) are "played back" and update the cache accordingly.
 
         During reads:
             * Logical data is served from the cache.
@@ -153,7 +159,41 @@
         ║  │Address >> 1 ║
         ║  └── Value: 1  ║
         ╚════════════════╝
-        0 <= Address <= 0x3FFE (16382) */
+        0 <= Address <= 0x3FFE (16382)
+
+    Checkpoints:
+
+        With large backing stores, playback of a nearly-full write log can take
+        a noticeable amount of time during startup. If
+        WEAR_LEVELING_CHECKPOINT_INTERVAL is defined, a snapshot of the cache is
+        written into the write log at fixed offsets from the start of the log:
+
+            (WEAR_LEVELING_LOGICAL_SIZE + 8) + (n * WEAR_LEVELING_CHECKPOINT_INTERVAL), n >= 1
+
+        Log entries never straddle a checkpoint offset -- if the next entry
+        would do so, the remainder of the log up to the checkpoint offset is
+        filled with padding entries, followed by the checkpoint record:
+
+        ╔ Padding ═╗
+        ║11XXXXX0║…║
+        ║       │  ║
+        ║  Kind: 0 ║
+        ╚══════════╝
+        One backing store write.
+
+        ╔ Checkpoint Record ══════════════════════════════╗
+        ║11XXXXX1║…║Cache snapshot ...║FNV1a_64 (8 bytes)║
+        ║       │  ║└──────┬─────────┘║└──────┬─────────┘║
+        ║  Kind: 1 ║ Logical size     ║  Of the snapshot ║
+        ╚══════════╩══════════════════╩══════════════════╝
+        One backing store write for the header, followed by the snapshot.
+
+        On startup the checkpoint offsets are probed from the end of the log
+        backwards. The first checkpoint with a matching FNV1a_64 is loaded into
+        the cache, and playback continues from the end of that record. If none
+        match, the consolidated data and full write log are used as normal.
+        Playback always skips over checkpoint records, so a write log created
+        with checkpoints enabled remains readable with them disabled. */
 
 /**
  * Storage area for the wear-leveling cache.
@@ -205,6 +245,37 @@ static void wear_leveling_clear_cache(void) {
     wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 is due to the FNV1a_64 of the consolidated buffer
 }
 
+/**
+ * Reads a FNV1a_64 hash from the backing store.
+ */
+static bool wear_leveling_read_hash(uint32_t address, uint64_t *hash) {
+    write_log_entry_t entry;
+#if BACKING_STORE_WRITE_SIZE == 2
+    bool ok = backing_store_read_bulk(address, entry.raw16, 4);
+#elif BACKING_STORE_WRITE_SIZE == 4
+    bool ok = backing_store_read_bulk(address, entry.raw32, 2);
+#elif BACKING_STORE_WRITE_SIZE == 8
+    bool ok = backing_store_read(address, &entry.raw64);
+#endif
+    *hash = entry.raw64;
+    return ok;
+}
+
+/**
+ * Writes a FNV1a_64 hash to the backing store.
+ */
+static bool wear_leveling_write_hash(uint32_t address, uint64_t hash) {
+    write_log_entry_t entry;
+    entry.raw64 = hash;
+#if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_write_bulk(address, entry.raw16, 4);
+#elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_write_bulk(address, entry.raw32, 2);
+#elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_write(address, entry.raw64);
+#endif
+}
+
 /**
  * Reads the consolidated data from the backing store into the cache.
  * Does not consider the write log.
@@ -220,19 +291,13 @@ static wear_leveling_status_t wear_leveling_read_consolidated(void) {
 
     // Verify the FNV1a_64 result
     if (status != WEAR_LEVELING_FAILED) {
-        uint64_t          expected = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
-        write_log_entry_t entry;
+        uint64_t expected = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
+        uint64_t actual   = 0;
         wl_dprintf("Reading checksum\n");
-#if BACKING_STORE_WRITE_SIZE == 2
-        backing_store_read_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw16, 4);
-#elif BACKING_STORE_WRITE_SIZE == 4
-        backing_store_read_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw32, 2);
-#elif BACKING_STORE_WRITE_SIZE == 8
-        backing_store_read((WEAR_LEVELING_LOGICAL_SIZE) + 0, &entry.raw64);
-#endif
+        wear_leveling_read_hash((WEAR_LEVELING_LOGICAL_SIZE), &actual);
         // If we have a mismatch, clear the cache but do not flag a failure,
         // which will cater for the completely clean MCU case.
-        if (entry.raw64 == expected) {
+        if (actual == expected) {
             wl_dprintf("Checksum matches, consolidated data is correct\n");
         } else {
             wl_dprintf("Checksum mismatch, clearing cache\n");
@@ -265,27 +330,10 @@ static wear_leveling_status_t wear_leveling_write_consolidated(void) {
 
     if (status != WEAR_LEVELING_FAILED) {
         // Write out the FNV1a_64 result of the consolidated data
-        write_log_entry_t entry;
-        entry.raw64 = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
         wl_dprintf("Writing checksum\n");
-        do {
-#if BACKING_STORE_WRITE_SIZE == 2
-            if (!backing_store_write_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw16, 4)) {
-                status = WEAR_LEVELING_FAILED;
-                break;
-            }
-#elif BACKING_STORE_WRITE_SIZE == 4
-            if (!backing_store_write_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw32, 2)) {
-                status = WEAR_LEVELING_FAILED;
-                break;
-            }
-#elif BACKING_STORE_WRITE_SIZE == 8
-            if (!backing_store_write((WEAR_LEVELING_LOGICAL_SIZE), entry.raw64)) {
-                status = WEAR_LEVELING_FAILED;
-                break;
-            }
-#endif
-        } while (0);
+        if (!wear_leveling_write_hash((WEAR_LEVELING_LOGICAL_SIZE), fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT))) {
+            status = WEAR_LEVELING_FAILED;
+        }
     }
 
     if (lock_status == STATUS_SUCCESS) {
@@ -351,6 +399,131 @@ static wear_leveling_status_t wear_leveling_append_raw(backing_store_int_t value
     return wear_leveling_consolidate_if_needed();
 }
 
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+/**
+ * Determines the location of the next checkpoint record at or after the supplied address.
+ *
+ * @return the backing store address of the checkpoint, or WEAR_LEVELING_BACKING_SIZE if no more checkpoints fit in the write log
+ */
+static uint32_t wear_leveling_next_checkpoint_address(uint32_t address) {
+    const uint32_t log_start = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
+    uint32_t       index     = 1;
+    if (address > log_start) {
+        index = (address - log_start + (WEAR_LEVELING_CHECKPOINT_INTERVAL) - 1) / (WEAR_LEVELING_CHECKPOINT_INTERVAL);
+    }
+    if (index > (WEAR_LEVELING_CHECKPOINT_COUNT)) {
+        return (WEAR_LEVELING_BACKING_SIZE);
+    }
+    return log_start + (index * (WEAR_LEVELING_CHECKPOINT_INTERVAL));
+}
+
+/**
+ * Writes a checkpoint record if the next log entry would reach or straddle a checkpoint location.
+ * Any remaining space before the checkpoint is filled with padding entries.
+ *
+ * @return WEAR_LEVELING_SUCCESS if no checkpoint was due or it was written, WEAR_LEVELING_CONSOLIDATED if
+ *         the checkpoint filled the write log and it was consolidated, or WEAR_LEVELING_FAILED on a write failure
+ */
+static wear_leveling_status_t wear_leveling_checkpoint_if_needed(size_t entry_size) {
+    const uint32_t checkpoint_address = wear_leveling_next_checkpoint_address(wear_leveling.write_address);
+    if (checkpoint_address >= (WEAR_LEVELING_BACKING_SIZE) || wear_leveling.write_address + entry_size <= checkpoint_address) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    wl_dprintf("Writing checkpoint\n");
+
+    // Pad out the write log up until the checkpoint location
+    write_log_entry_t log = LOG_ENTRY_MAKE_CHECKPOINT(false);
+    while (wear_leveling.write_address < checkpoint_address) {
+#    if BACKING_STORE_WRITE_SIZE == 2
+        bool ok = backing_store_write(wear_leveling.write_address, log.raw16[0]);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+        bool ok = backing_store_write(wear_leveling.write_address, log.raw32[0]);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+        bool ok = backing_store_write(wear_leveling.write_address, log.raw64);
+#    endif
+        if (!ok) {
+            wl_dprintf("Failed to write to backing store\n");
+            return WEAR_LEVELING_FAILED;
+        }
+        wear_leveling.write_address += (BACKING_STORE_WRITE_SIZE);
+    }
+
+    // Write the checkpoint header, the snapshot of the cache, then the FNV1a_64 of the snapshot
+    log = LOG_ENTRY_MAKE_CHECKPOINT(true);
+#    if BACKING_STORE_WRITE_SIZE == 2
+    bool ok = backing_store_write(checkpoint_address, log.raw16[0]);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+    bool ok = backing_store_write(checkpoint_address, log.raw32[0]);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+    bool ok = backing_store_write(checkpoint_address, log.raw64);
+#    endif
+    if (!ok) {
+        wl_dprintf("Failed to write to backing store\n");
+        return WEAR_LEVELING_FAILED;
+    }
+
+    // Once the header is written playback skips the whole record, so the space is consumed even if the rest fails
+    wear_leveling.write_address = checkpoint_address + (WEAR_LEVELING_CHECKPOINT_RECORD_SIZE);
+    ok                          = backing_store_write_bulk(checkpoint_address + (BACKING_STORE_WRITE_SIZE), (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t));
+    ok                          = ok && wear_leveling_write_hash(checkpoint_address + (BACKING_STORE_WRITE_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE), fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT));
+    if (!ok) {
+        wl_dprintf("Failed to write checkpoint to backing store\n");
+        return WEAR_LEVELING_FAILED;
+    }
+
+    return wear_leveling_consolidate_if_needed();
+}
+
+/**
+ * Loads the latest valid checkpoint into the cache.
+ *
+ * @return the backing store address to start playback of the write log, or 0 if no valid checkpoint was found
+ */
+static uint32_t wear_leveling_restore_checkpoint(void) {
+    const uint32_t log_start = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
+    for (uint32_t index = (WEAR_LEVELING_CHECKPOINT_COUNT); index > 0; --index) {
+        const uint32_t      checkpoint_address = log_start + (index * (WEAR_LEVELING_CHECKPOINT_INTERVAL));
+        backing_store_int_t value;
+        if (!backing_store_read(checkpoint_address, &value) || value == 0) {
+            continue;
+        }
+
+        write_log_entry_t log;
+#    if BACKING_STORE_WRITE_SIZE == 2
+        log.raw16[0] = value;
+#    elif BACKING_STORE_WRITE_SIZE == 4
+        log.raw32[0] = value;
+#    elif BACKING_STORE_WRITE_SIZE == 8
+        log.raw64 = value;
+#    endif
+        if (LOG_ENTRY_GET_TYPE(log) != LOG_ENTRY_TYPE_CHECKPOINT || !LOG_ENTRY_CHECKPOINT_IS_SNAPSHOT(log)) {
+            continue;
+        }
+
+        // Load the snapshot directly into the cache -- if it turns out to be invalid the caller reloads the consolidated data
+        uint64_t hash = 0;
+        if (!backing_store_read_bulk(checkpoint_address + (BACKING_STORE_WRITE_SIZE), (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
+            continue;
+        }
+        if (!wear_leveling_read_hash(checkpoint_address + (BACKING_STORE_WRITE_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE), &hash)) {
+            continue;
+        }
+        if (hash != fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT)) {
+            wl_dprintf("Checkpoint checksum mismatch, skipping\n");
+            continue;
+        }
+
+        wl_dprintf("Restored checkpoint\n");
+        return checkpoint_address + (WEAR_LEVELING_CHECKPOINT_RECORD_SIZE);
+    }
+
+    return 0;
+}
+#else
+#    define wear_leveling_checkpoint_if_needed(entry_size) (WEAR_LEVELING_SUCCESS)
+#endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+
 /**
  * Handles writing multi_byte-encoded data to the backing store.
  *
@@ -366,6 +539,11 @@ static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address
     // Write to the backing store. See the multi-byte log format in the documentation header at the top of the file.
     wear_leveling_status_t status;
 #if BACKING_STORE_WRITE_SIZE == 2
+    status = wear_leveling_checkpoint_if_needed((BACKING_STORE_WRITE_SIZE) * (2 + (length > 1 ? 1 : 0) + (length > 3 ? 1 : 0)));
+    if (status != WEAR_LEVELING_SUCCESS) {
+        return status;
+    }
+
     status = wear_leveling_append_raw(log.raw16[0]);
     if (status != WEAR_LEVELING_SUCCESS) {
         return status;
@@ -390,6 +568,11 @@ static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address
         }
     }
 #elif BACKING_STORE_WRITE_SIZE == 4
+    status = wear_leveling_checkpoint_if_needed((BACKING_STORE_WRITE_SIZE) * (1 + (length > 1 ? 1 : 0)));
+    if (status != WEAR_LEVELING_SUCCESS) {
+        return status;
+    }
+
     status = wear_leveling_append_raw(log.raw32[0]);
     if (status != WEAR_LEVELING_SUCCESS) {
         return status;
@@ -402,6 +585,11 @@ static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address
         }
     }
 #elif BACKING_STORE_WRITE_SIZE == 8
+    status = wear_leveling_checkpoint_if_needed((BACKING_STORE_WRITE_SIZE));
+    if (status != WEAR_LEVELING_SUCCESS) {
+        return status;
+    }
+
     status = wear_leveling_append_raw(log.raw64);
     if (status != WEAR_LEVELING_SUCCESS) {
         return status;
@@ -424,7 +612,10 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
             const uint16_t v = ((uint16_t)p[1]) << 8 | p[0]; // don't just dereference a uint16_t here -- if unaligned it generates faults on some MCUs
             if (v == 0 || v == 1) {
                 const write_log_entry_t log = LOG_ENTRY_MAKE_WORD_01(address, v);
-                status                      = wear_leveling_append_raw(log.raw16[0]);
+                status                      = wear_leveling_checkpoint_if_needed((BACKING_STORE_WRITE_SIZE));
+                if (status == WEAR_LEVELING_SUCCESS) {
+                    status = wear_leveling_append_raw(log.raw16[0]);
+                }
                 if (status != WEAR_LEVELING_SUCCESS) {
                     // If consolidation occurred, then the cache has already been written to the consolidated area. No need to continue.
                     // If a failure occurred, pass it on.
@@ -441,7 +632,10 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
         // Small-write optimizations - address<64:
         if (address < 64) {
             const write_log_entry_t log = LOG_ENTRY_MAKE_OPTIMIZED_64(address, *p);
-            status                      = wear_leveling_append_raw(log.raw16[0]);
+            status                      = wear_leveling_checkpoint_if_needed((BACKING_STORE_WRITE_SIZE));
+            if (status == WEAR_LEVELING_SUCCESS) {
+                status = wear_leveling_append_raw(log.raw16[0]);
+            }
             if (status != WEAR_LEVELING_SUCCESS) {
                 // If consolidation occurred, then the cache has already been written to the consolidated area. No need to continue.
                 // If a failure occurred, pass it on.
@@ -471,13 +665,14 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
 
 /**
  * "Replays" the write log from the backing store, updating the local cache with updated values.
+ *
+ * @param address[in] the backing store address to start playback from
  */
-static wear_leveling_status_t wear_leveling_playback_log(void) {
+static wear_leveling_status_t wear_leveling_playback_log(uint32_t address) {
     wl_dprintf("Playback write log\n");
 
     wear_leveling_status_t status          = WEAR_LEVELING_SUCCESS;
     bool                   cancel_playback = false;
-    uint32_t               address         = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
     while (!cancel_playback && address < (WEAR_LEVELING_BACKING_SIZE)) {
         backing_store_int_t value;
         bool                ok = backing_store_read(address, &value);
@@ -590,6 +785,17 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
                 wear_leveling.cache[a + 1] = 0;
             } break;
 #endif // BACKING_STORE_WRITE_SIZE == 2
+            case LOG_ENTRY_TYPE_CHECKPOINT: {
+                // Padding needs no action, and a checkpoint's snapshot matches the cache at this point in playback -- skip over it
+                if (LOG_ENTRY_CHECKPOINT_IS_SNAPSHOT(log)) {
+                    address += (WEAR_LEVELING_CHECKPOINT_RECORD_SIZE) - (BACKING_STORE_WRITE_SIZE);
+                    if (address > (WEAR_LEVELING_BACKING_SIZE)) {
+                        cancel_playback = true;
+                        status          = WEAR_LEVELING_FAILED;
+                        break;
+                    }
+                }
+            } break;
             default: {
                 cancel_playback = true;
                 status          = WEAR_LEVELING_FAILED;
@@ -627,15 +833,25 @@ wear_leveling_status_t wear_leveling_init(void) {
         return WEAR_LEVELING_FAILED;
     }
 
-    // Read the previous consolidated values, then replay the existing write log so that the cache has the "live" values
-    wear_leveling_status_t status = wear_leveling_read_consolidated();
-    if (status == WEAR_LEVELING_FAILED) {
-        // If it failed, clear the cache and return with failure
-        wear_leveling_clear_cache();
-        return status;
+    wear_leveling_status_t status           = WEAR_LEVELING_SUCCESS;
+    uint32_t               playback_address = 0;
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+    // Start from the latest checkpoint if there is one, skipping playback of everything before it
+    playback_address = wear_leveling_restore_checkpoint();
+#endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+
+    if (playback_address == 0) {
+        // Read the previous consolidated values, then replay the existing write log so that the cache has the "live" values
+        status = wear_leveling_read_consolidated();
+        if (status == WEAR_LEVELING_FAILED) {
+            // If it failed, clear the cache and return with failure
+            wear_leveling_clear_cache();
+            return status;
+        }
+        playback_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
     }
 
-    status = wear_leveling_playback_log();
+    status = wear_leveling_playback_log(playback_address);
     if (status == WEAR_LEVELING_FAILED) {
         // If it failed, clear the cache and return with failure
         wear_leveling_clear_cache();
@@ -66,6 +66,17 @@ _Static_assert(WEAR_LEVELING_BACKING_SIZE >= (WEAR_LEVELING_LOGICAL_SIZE * 2), "
 _Static_assert(WEAR_LEVELING_LOGICAL_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Logical size must be a multiple of write size");
 _Static_assert(WEAR_LEVELING_BACKING_SIZE % WEAR_LEVELING_LOGICAL_SIZE == 0, "Backing size must be a multiple of logical size");
 
+// Size of a checkpoint record in the write log: header, snapshot of logical data, FNV1a_64 of the snapshot
+#define WEAR_LEVELING_CHECKPOINT_RECORD_SIZE ((BACKING_STORE_WRITE_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE) + 8)
+
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+// Number of checkpoint slots that fit inside the write log
+#    define WEAR_LEVELING_CHECKPOINT_COUNT (((WEAR_LEVELING_BACKING_SIZE) - ((WEAR_LEVELING_LOGICAL_SIZE) + 8) - (WEAR_LEVELING_CHECKPOINT_RECORD_SIZE)) / (WEAR_LEVELING_CHECKPOINT_INTERVAL))
+_Static_assert(WEAR_LEVELING_CHECKPOINT_INTERVAL % BACKING_STORE_WRITE_SIZE == 0, "Checkpoint interval must be a multiple of write size");
+_Static_assert(WEAR_LEVELING_CHECKPOINT_INTERVAL > WEAR_LEVELING_CHECKPOINT_RECORD_SIZE, "Checkpoint interval must be larger than a checkpoint record");
+_Static_assert(WEAR_LEVELING_BACKING_SIZE > ((WEAR_LEVELING_LOGICAL_SIZE) + 8 + (WEAR_LEVELING_CHECKPOINT_INTERVAL) + (WEAR_LEVELING_CHECKPOINT_RECORD_SIZE)), "Checkpoint interval too large, no checkpoints fit in the write log");
+#endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+
 // Backing Store API, to be implemented elsewhere by flash driver etc.
 bool backing_store_init(void);
 bool backing_store_unlock(void);
@@ -101,6 +112,9 @@ enum {
     // 0x02 -- 2-byte backing store write optimization: word-encoded 0/1 values
     LOG_ENTRY_TYPE_WORD_01,
 
+    // 0x03 -- Checkpoint snapshot of logical data, or alignment padding preceding it
+    LOG_ENTRY_TYPE_CHECKPOINT,
+
     LOG_ENTRY_TYPES
 };
 
@@ -149,3 +163,13 @@ _Static_assert(LOG_ENTRY_TYPES <= (1 << 2), "Too many log entry types to fit int
             [1] = (uint8_t)((address) >> 1), /* address */                                            \
         }                                                                                             \
     }
+
+#define LOG_ENTRY_CHECKPOINT_IS_SNAPSHOT(entry) ((bool)((entry).raw8[0] & BITMASK_FOR_BITCOUNT(1)))
+#define LOG_ENTRY_MAKE_CHECKPOINT(snapshot)                                                             \
+    (write_log_entry_t) {                                                                               \
+        .raw8 = {                                                                                       \
+            [0] = (((((uint8_t)LOG_ENTRY_TYPE_CHECKPOINT) & BITMASK_FOR_BITCOUNT(2)) << 6) /* type */   \
+                   | ((((uint8_t)((snapshot) ? 1 : 0))) & BITMASK_FOR_BITCOUNT(1))         /* kind */   \
+                   ),                                                                                   \
+        }                                                                                               \
+    }
@@ -0,0 +1,14 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define ADAPTIVE_TAPPING_TERM_PERSIST
+#define ADAPTIVE_TAPPING_TERM_MIN 50
+#define ADAPTIVE_TAPPING_TERM_SAVE_INTERVAL 16
+#define ADAPTIVE_TAPPING_TERM_SAVE_IDLE_TIMEOUT 1000
+
+#define EEPROM_TEST_HARNESS_SIZE 256
+#define KV_STORE_EEPROM_SIZE 128
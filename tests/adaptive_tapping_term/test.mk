@@ -0,0 +1,5 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+ADAPTIVE_TAPPING_TERM_ENABLE = yes
+KV_STORE_ENABLE = yes
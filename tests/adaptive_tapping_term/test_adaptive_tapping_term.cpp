@@ -0,0 +1,193 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class AdaptiveTappingTerm : public TestFixture {
+   public:
+    void SetUp() override {
+        adaptive_tapping_term_reset();
+    }
+
+    bool saved(void) {
+        uint8_t data[8 * ADAPTIVE_TAPPING_TERM_KEYS];
+        return kv_store_read(ADAPTIVE_TAPPING_TERM_KV_STORE_ID, 1, data, sizeof(data));
+    }
+
+    uint16_t term(uint16_t keycode) {
+        keyrecord_t record = {};
+        return get_adaptive_tapping_term(keycode, &record);
+    }
+};
+
+TEST_F(AdaptiveTappingTerm, uses_tapping_term_until_enough_taps) {
+    TestDriver driver;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    set_keymap({mod_tap_key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < ADAPTIVE_TAPPING_TERM_MIN_SAMPLES - 1; i++) {
+        tap_key(mod_tap_key, 40);
+        idle_for(TAPPING_TERM);
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(adaptive_tapping_term_samples(SFT_T(KC_P)), ADAPTIVE_TAPPING_TERM_MIN_SAMPLES - 1);
+    EXPECT_EQ(term(SFT_T(KC_P)), TAPPING_TERM);
+}
+
+TEST_F(AdaptiveTappingTerm, fast_taps_lower_tapping_term) {
+    TestDriver driver;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    set_keymap({mod_tap_key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < 32; i++) {
+        tap_key(mod_tap_key, 40 + (i % 3) * 10);
+        idle_for(TAPPING_TERM);
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    const uint16_t learned = term(SFT_T(KC_P));
+    EXPECT_GT(learned, 60);
+    EXPECT_LT(learned, 120);
+
+    /* The key is now held once the learned tapping term expires */
+    InSequence s;
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    idle_for(learned - 1);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    idle_for(2);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(AdaptiveTappingTerm, unused_holds_raise_tapping_term) {
+    TestDriver driver;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    set_keymap({mod_tap_key});
+
+    /* Held slightly too long, with nothing pressed in the meantime */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < ADAPTIVE_TAPPING_TERM_MIN_SAMPLES; i++) {
+        tap_key(mod_tap_key, TAPPING_TERM + 30);
+        idle_for(TAPPING_TERM);
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_GT(term(SFT_T(KC_P)), TAPPING_TERM + 30);
+
+    /* The same press is now a tap */
+    InSequence s;
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(mod_tap_key, TAPPING_TERM + 30);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(AdaptiveTappingTerm, used_holds_are_not_learned) {
+    TestDriver driver;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key = KeymapKey(0, 2, 0, KC_A);
+    set_keymap({mod_tap_key, regular_key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < ADAPTIVE_TAPPING_TERM_MIN_SAMPLES; i++) {
+        mod_tap_key.press();
+        idle_for(TAPPING_TERM + 1);
+        tap_key(regular_key);
+        mod_tap_key.release();
+        idle_for(TAPPING_TERM);
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(adaptive_tapping_term_samples(SFT_T(KC_P)), 0);
+    EXPECT_EQ(term(SFT_T(KC_P)), TAPPING_TERM);
+}
+
+TEST_F(AdaptiveTappingTerm, learns_each_key_separately) {
+    TestDriver driver;
+    auto       fast_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       slow_key = KeymapKey(0, 2, 0, LT(1, KC_A));
+    set_keymap({fast_key, slow_key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < 16; i++) {
+        tap_key(fast_key, 40);
+        idle_for(TAPPING_TERM);
+        tap_key(slow_key, 150);
+        idle_for(TAPPING_TERM);
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_LT(term(SFT_T(KC_P)), term(LT(1, KC_A)));
+    EXPECT_GE(term(LT(1, KC_A)), 150);
+}
+
+TEST_F(AdaptiveTappingTerm, persists_learned_terms) {
+    TestDriver driver;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    set_keymap({mod_tap_key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < 16; i++) {
+        tap_key(mod_tap_key, 40);
+        idle_for(TAPPING_TERM);
+    }
+    adaptive_tapping_term_save();
+    const uint16_t saved = term(SFT_T(KC_P));
+
+    for (int i = 0; i < 16; i++) {
+        tap_key(mod_tap_key, 120);
+        idle_for(TAPPING_TERM);
+    }
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_NE(term(SFT_T(KC_P)), saved);
+
+    /* Reloading restores the saved state */
+    adaptive_tapping_term_init();
+    EXPECT_EQ(term(SFT_T(KC_P)), saved);
+    EXPECT_EQ(adaptive_tapping_term_samples(SFT_T(KC_P)), 16);
+
+    adaptive_tapping_term_reset();
+    adaptive_tapping_term_init();
+    EXPECT_EQ(term(SFT_T(KC_P)), TAPPING_TERM);
+}
+
+TEST_F(AdaptiveTappingTerm, saves_once_typing_pauses) {
+    TestDriver driver;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    set_keymap({mod_tap_key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < ADAPTIVE_TAPPING_TERM_SAVE_INTERVAL - 1; i++) {
+        tap_key(mod_tap_key, 40);
+        idle_for(ADAPTIVE_TAPPING_TERM_SAVE_IDLE_TIMEOUT);
+    }
+    EXPECT_FALSE(saved());
+
+    /* Enough taps were learned, but the keyboard is still in use */
+    tap_key(mod_tap_key, 40);
+    idle_for(ADAPTIVE_TAPPING_TERM_SAVE_IDLE_TIMEOUT / 2);
+    EXPECT_FALSE(saved());
+
+    idle_for(ADAPTIVE_TAPPING_TERM_SAVE_IDLE_TIMEOUT / 2);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_TRUE(saved());
+}
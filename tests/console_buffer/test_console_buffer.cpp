@@ -0,0 +1,95 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "sendchar.h"
+}
+
+class ConsoleBuffer : public TestFixture {
+   public:
+    void SetUp() override {
+        console_buffer_clear();
+    }
+
+    void put(const std::string &text) {
+        for (char c : text) {
+            console_buffer_put(c);
+        }
+    }
+
+    std::string read(uint16_t size) {
+        std::string text(size, '\0');
+        text.resize(console_buffer_read(reinterpret_cast<uint8_t *>(&text[0]), size));
+        return text;
+    }
+};
+
+TEST_F(ConsoleBuffer, characters_are_read_in_order) {
+    put("hello");
+    EXPECT_EQ(console_buffer_available(), 5);
+    EXPECT_EQ(read(3), "hel");
+    EXPECT_EQ(read(8), "lo");
+    EXPECT_EQ(console_buffer_available(), 0);
+    EXPECT_EQ(read(8), "");
+}
+
+TEST_F(ConsoleBuffer, overflow_drops_and_counts_new_characters) {
+    put("0123456789abcdef");
+    EXPECT_EQ(console_buffer_put('g'), -1);
+    put("hi");
+    EXPECT_EQ(console_buffer_dropped(), 3);
+    EXPECT_EQ(read(CONSOLE_BUFFER_SIZE), "0123456789abcdef");
+
+    EXPECT_EQ(console_buffer_put('j'), -1);
+    EXPECT_EQ(read(32), "[4 bytes dropped]\n");
+    EXPECT_EQ(console_buffer_put('k'), 0);
+    EXPECT_EQ(read(32), "k");
+    EXPECT_EQ(console_buffer_dropped(), 4);
+
+    console_buffer_clear();
+    EXPECT_EQ(console_buffer_dropped(), 0);
+}
+
+TEST_F(ConsoleBuffer, characters_are_dropped_until_the_marker_is_read) {
+    put("0123456789abcdef");
+    put("lost");
+    EXPECT_EQ(read(4), "0123");
+    put("kept");
+    put("lost again");
+
+    /* Until the marker is read, everything after it is dropped and counted
+     * in it, even once there is room again */
+    EXPECT_EQ(read(32), "456789abcdef");
+    EXPECT_NE(console_buffer_available(), 0);
+    EXPECT_EQ(read(32), "[18 bytes dropped]\n");
+    EXPECT_EQ(console_buffer_available(), 0);
+    EXPECT_EQ(read(32), "");
+
+    put("kept");
+    EXPECT_EQ(read(32), "kept");
+}
+
+TEST_F(ConsoleBuffer, dropped_marker_is_truncated_to_the_read_size) {
+    put("0123456789abcdef");
+    put("lost");
+    EXPECT_EQ(read(32), "0123456789abcdef");
+    EXPECT_EQ(read(8), "[4 bytes");
+    EXPECT_EQ(console_buffer_available(), 0);
+}
+
+TEST_F(ConsoleBuffer, reads_wrap_around_the_buffer) {
+    std::string written, received;
+    for (int i = 0; i < 40; i++) {
+        std::string line = "line " + std::to_string(i) + "\n";
+        put(line);
+        written += line;
+        received += read(8);
+    }
+    received += read(CONSOLE_BUFFER_SIZE);
+    EXPECT_EQ(console_buffer_dropped(), 0);
+    EXPECT_EQ(received, written);
+}
@@ -0,0 +1,375 @@
+/* Copyright 2024 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "deferred_exec.h"
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+#define TABLE_COUNT 64
+
+struct Invocation {
+    int      id;
+    uint32_t trigger_time;
+    uint32_t now;
+};
+
+struct CallbackState {
+    int                      id;
+    uint32_t                 repeat_ms;
+    int                      repeats_left;
+    std::vector<Invocation> *log;
+};
+
+static uint32_t record_callback(uint32_t trigger_time, void *cb_arg) {
+    CallbackState *state = (CallbackState *)cb_arg;
+    state->log->push_back({state->id, trigger_time, timer_read32()});
+    if (state->repeats_left > 0) {
+        --state->repeats_left;
+        return state->repeat_ms;
+    }
+    return 0;
+}
+
+class DeferredExec : public TestFixture {
+   public:
+    void SetUp() override {
+        memset(table, 0, sizeof(table));
+        last_exec = 0;
+        set_time(1000);
+    }
+
+    void run_for(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; ++i) {
+            advance_time(1);
+            deferred_exec_advanced_task(table, TABLE_COUNT, &last_exec);
+        }
+    }
+
+    deferred_token defer(CallbackState &state, uint32_t delay_ms) {
+        state.log = &log;
+        return defer_exec_advanced(table, TABLE_COUNT, delay_ms, record_callback, &state);
+    }
+
+    deferred_executor_t     table[TABLE_COUNT];
+    uint32_t                last_exec;
+    std::vector<Invocation> log;
+};
+
+TEST_F(DeferredExec, InvalidArguments) {
+    CallbackState state = {1, 0, 0, &log};
+    EXPECT_EQ(defer_exec_advanced(table, TABLE_COUNT, 0, record_callback, &state), INVALID_DEFERRED_TOKEN);
+    EXPECT_EQ(defer_exec_advanced(table, TABLE_COUNT, 10, NULL, &state), INVALID_DEFERRED_TOKEN);
+    EXPECT_EQ(defer_exec_advanced(NULL, TABLE_COUNT, 10, record_callback, &state), INVALID_DEFERRED_TOKEN);
+    EXPECT_FALSE(cancel_deferred_exec_advanced(table, TABLE_COUNT, INVALID_DEFERRED_TOKEN));
+    EXPECT_FALSE(extend_deferred_exec_advanced(table, TABLE_COUNT, 1, 10));
+
+    uint32_t deadline;
+    EXPECT_FALSE(deferred_exec_advanced_next_deadline(table, TABLE_COUNT, &deadline));
+}
+
+TEST_F(DeferredExec, ExecutesInDeadlineOrder) {
+    std::vector<uint32_t>      delays = {50, 10, 30, 20, 40, 5, 45, 15};
+    std::vector<CallbackState> states(delays.size());
+    for (size_t i = 0; i < delays.size(); ++i) {
+        states[i].id = (int)delays[i];
+        EXPECT_NE(defer(states[i], delays[i]), INVALID_DEFERRED_TOKEN);
+    }
+
+    run_for(60);
+
+    ASSERT_EQ(log.size(), delays.size());
+    std::sort(delays.begin(), delays.end());
+    for (size_t i = 0; i < delays.size(); ++i) {
+        EXPECT_EQ(log[i].id, (int)delays[i]);
+        EXPECT_EQ(log[i].trigger_time, 1000 + delays[i]);
+        EXPECT_EQ(log[i].now, 1000 + delays[i]);
+    }
+}
+
+TEST_F(DeferredExec, RepeatsRelativeToTriggerTime) {
+    CallbackState state = {1, 25, 3, nullptr};
+    EXPECT_NE(defer(state, 10), INVALID_DEFERRED_TOKEN);
+
+    run_for(100);
+
+    ASSERT_EQ(log.size(), 4);
+    EXPECT_EQ(log[0].trigger_time, 1010);
+    EXPECT_EQ(log[1].trigger_time, 1035);
+    EXPECT_EQ(log[2].trigger_time, 1060);
+    EXPECT_EQ(log[3].trigger_time, 1085);
+
+    uint32_t deadline;
+    EXPECT_FALSE(deferred_exec_advanced_next_deadline(table, TABLE_COUNT, &deadline));
+}
+
+TEST_F(DeferredExec, LateRepeatRunsOncePerPass) {
+    CallbackState fast  = {1, 1, 5, nullptr};
+    CallbackState other = {2, 0, 0, nullptr};
+    EXPECT_NE(defer(fast, 10), INVALID_DEFERRED_TOKEN);
+    EXPECT_NE(defer(other, 12), INVALID_DEFERRED_TOKEN);
+
+    // Simulate a stall, so that both are overdue on the next pass
+    advance_time(20);
+    deferred_exec_advanced_task(table, TABLE_COUNT, &last_exec);
+    ASSERT_EQ(log.size(), 2);
+    EXPECT_EQ(log[0].id, 1);
+    EXPECT_EQ(log[1].id, 2);
+
+    // The repeating executor catches up one invocation per pass
+    run_for(10);
+    std::vector<int> ids;
+    for (auto &inv : log) {
+        ids.push_back(inv.id);
+    }
+    EXPECT_EQ(ids, (std::vector<int>{1, 2, 1, 1, 1, 1, 1}));
+}
+
+static uint32_t always_behind_callback(uint32_t trigger_time, void *cb_arg) {
+    // Takes longer than its own period, so it is overdue again as soon as it returns
+    advance_time(2);
+    return record_callback(trigger_time, cb_arg);
+}
+
+TEST_F(DeferredExec, AlwaysBehindRepeatDoesNotStarveOthers) {
+    CallbackState behind = {1, 1, 1000, &log};
+    EXPECT_NE(defer_exec_advanced(table, TABLE_COUNT, 1, always_behind_callback, &behind), INVALID_DEFERRED_TOKEN);
+
+    std::vector<CallbackState> others(4);
+    for (size_t i = 0; i < others.size(); ++i) {
+        others[i].id = (int)(10 + i);
+        EXPECT_NE(defer(others[i], 5 + i), INVALID_DEFERRED_TOKEN);
+    }
+
+    run_for(20);
+
+    // The others run in the first pass after they become due, rather than waiting for it to catch up
+    std::set<int> ran;
+    for (auto &inv : log) {
+        ran.insert(inv.id);
+        if (inv.id != 1) {
+            EXPECT_LE(inv.now - inv.trigger_time, 5) << "Executor " << inv.id << " was held back";
+        }
+    }
+    EXPECT_EQ(ran, (std::set<int>{1, 10, 11, 12, 13}));
+}
+
+TEST_F(DeferredExec, CancelAndExtend) {
+    CallbackState a = {1, 0, 0, nullptr};
+    CallbackState b = {2, 0, 0, nullptr};
+    CallbackState c = {3, 0, 0, nullptr};
+
+    deferred_token ta = defer(a, 10);
+    deferred_token tb = defer(b, 20);
+    deferred_token tc = defer(c, 30);
+
+    uint32_t deadline;
+    EXPECT_TRUE(deferred_exec_advanced_next_deadline(table, TABLE_COUNT, &deadline));
+    EXPECT_EQ(deadline, 1010);
+
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, TABLE_COUNT, ta));
+    EXPECT_FALSE(cancel_deferred_exec_advanced(table, TABLE_COUNT, ta));
+    EXPECT_TRUE(deferred_exec_advanced_next_deadline(table, TABLE_COUNT, &deadline));
+    EXPECT_EQ(deadline, 1020);
+
+    EXPECT_TRUE(extend_deferred_exec_advanced(table, TABLE_COUNT, tb, 50));
+    EXPECT_TRUE(deferred_exec_advanced_next_deadline(table, TABLE_COUNT, &deadline));
+    EXPECT_EQ(deadline, 1030);
+
+    run_for(60);
+    ASSERT_EQ(log.size(), 2);
+    EXPECT_EQ(log[0].id, 3);
+    EXPECT_EQ(log[1].id, 2);
+    EXPECT_EQ(log[1].now, 1050);
+
+    EXPECT_FALSE(cancel_deferred_exec_advanced(table, TABLE_COUNT, tb));
+    EXPECT_FALSE(cancel_deferred_exec_advanced(table, TABLE_COUNT, tc));
+}
+
+static deferred_executor_t *requeue_table;
+static deferred_token       requeue_token;
+static int                  requeue_count;
+
+static uint32_t requeue_callback(uint32_t trigger_time, void *cb_arg) {
+    ++requeue_count;
+    cancel_deferred_exec_advanced(requeue_table, TABLE_COUNT, requeue_token);
+    if (requeue_count < 3) {
+        requeue_token = defer_exec_advanced(requeue_table, TABLE_COUNT, 5, requeue_callback, NULL);
+    }
+    return 100;
+}
+
+TEST_F(DeferredExec, CallbackCancelsAndRequeues) {
+    requeue_table = table;
+    requeue_count = 0;
+    requeue_token = defer_exec_advanced(table, TABLE_COUNT, 5, requeue_callback, NULL);
+
+    run_for(50);
+    EXPECT_EQ(requeue_count, 3);
+
+    uint32_t deadline;
+    EXPECT_FALSE(deferred_exec_advanced_next_deadline(table, TABLE_COUNT, &deadline));
+}
+
+TEST_F(DeferredExec, TableFullAndTokensUnique) {
+    std::vector<CallbackState>  states(TABLE_COUNT + 1);
+    std::vector<deferred_token> tokens;
+    for (int i = 0; i < TABLE_COUNT; ++i) {
+        states[i].id         = i;
+        deferred_token token = defer(states[i], 100 + i);
+        EXPECT_NE(token, INVALID_DEFERRED_TOKEN);
+        tokens.push_back(token);
+    }
+    EXPECT_EQ(std::set<deferred_token>(tokens.begin(), tokens.end()).size(), TABLE_COUNT);
+    EXPECT_EQ(defer(states[TABLE_COUNT], 10), INVALID_DEFERRED_TOKEN);
+
+    // A freed slot can be reused, but the stale token must not refer to the new executor
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, TABLE_COUNT, tokens[7]));
+    deferred_token reused = defer(states[TABLE_COUNT], 10);
+    EXPECT_NE(reused, INVALID_DEFERRED_TOKEN);
+    EXPECT_NE(reused, tokens[7]);
+    EXPECT_FALSE(cancel_deferred_exec_advanced(table, TABLE_COUNT, tokens[7]));
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, TABLE_COUNT, reused));
+}
+
+TEST_F(DeferredExec, StaleTokenSurvivesSlotReuse) {
+    std::vector<CallbackState>  states(TABLE_COUNT + 1);
+    std::vector<deferred_token> tokens;
+    for (int i = 0; i < TABLE_COUNT; ++i) {
+        states[i].id = i;
+        tokens.push_back(defer(states[i], 1000 + i));
+    }
+
+    // With the table full, the freed slot is the one handed out again every time
+    deferred_token stale = tokens[7];
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, TABLE_COUNT, stale));
+    for (int i = 0; i < 100; ++i) {
+        deferred_token reused = defer(states[TABLE_COUNT], 10);
+        ASSERT_NE(reused, INVALID_DEFERRED_TOKEN);
+        ASSERT_NE(reused, stale) << "Token handed out again after " << i << " reuses";
+        EXPECT_FALSE(extend_deferred_exec_advanced(table, TABLE_COUNT, stale, 500));
+        EXPECT_FALSE(cancel_deferred_exec_advanced(table, TABLE_COUNT, stale));
+        EXPECT_TRUE(cancel_deferred_exec_advanced(table, TABLE_COUNT, reused));
+    }
+}
+
+TEST_F(DeferredExec, RandomOperationsMatchReference) {
+    std::mt19937                   rng(1234);
+    std::vector<CallbackState>     states(TABLE_COUNT);
+    std::map<deferred_token, int>  live;     // token -> state index
+    std::map<int, uint32_t>        expected; // state index -> trigger time
+    std::vector<int>               free_states;
+    for (int i = 0; i < TABLE_COUNT; ++i) {
+        states[i].id = i;
+        free_states.push_back(i);
+    }
+
+    for (int step = 0; step < 5000; ++step) {
+        uint32_t op = rng() % 10;
+        if (op < 4 && !free_states.empty()) {
+            int idx = free_states.back();
+            free_states.pop_back();
+            uint32_t       delay = 1 + rng() % 200;
+            deferred_token token = defer(states[idx], delay);
+            ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+            ASSERT_EQ(live.count(token), 0);
+            live[token]   = idx;
+            expected[idx] = timer_read32() + delay;
+        } else if (op < 6 && !live.empty()) {
+            auto it = live.begin();
+            std::advance(it, rng() % live.size());
+            ASSERT_TRUE(cancel_deferred_exec_advanced(table, TABLE_COUNT, it->first));
+            expected.erase(it->second);
+            free_states.push_back(it->second);
+            live.erase(it);
+        } else if (op < 7 && !live.empty()) {
+            auto it = live.begin();
+            std::advance(it, rng() % live.size());
+            uint32_t delay = 1 + rng() % 200;
+            ASSERT_TRUE(extend_deferred_exec_advanced(table, TABLE_COUNT, it->first, delay));
+            expected[it->second] = timer_read32() + delay;
+        } else {
+            log.clear();
+            run_for(1 + rng() % 5);
+            for (auto &inv : log) {
+                ASSERT_EQ(expected.count(inv.id), 1);
+                EXPECT_EQ(inv.trigger_time, expected[inv.id]);
+                EXPECT_EQ(inv.now, inv.trigger_time);
+                expected.erase(inv.id);
+                free_states.push_back(inv.id);
+                for (auto it = live.begin(); it != live.end(); ++it) {
+                    if (it->second == inv.id) {
+                        live.erase(it);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Nothing should have been missed, and the next deadline should be the soonest outstanding
+        uint32_t deadline;
+        if (expected.empty()) {
+            ASSERT_FALSE(deferred_exec_advanced_next_deadline(table, TABLE_COUNT, &deadline));
+        } else {
+            uint32_t soonest = UINT32_MAX;
+            for (auto &e : expected) {
+                soonest = std::min(soonest, e.second);
+            }
+            ASSERT_TRUE(deferred_exec_advanced_next_deadline(table, TABLE_COUNT, &deadline));
+            ASSERT_EQ(deadline, soonest);
+            ASSERT_GT(deadline, timer_read32());
+        }
+    }
+}
+
+TEST_F(DeferredExec, BasicApi) {
+    CallbackState state = {1, 0, 0, &log};
+
+    // Fill the default table, as configured in config.h
+    std::vector<deferred_token> tokens;
+    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
+        deferred_token token = defer_exec(10 + i, record_callback, &state);
+        ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+        tokens.push_back(token);
+    }
+    EXPECT_EQ(defer_exec(10, record_callback, &state), INVALID_DEFERRED_TOKEN);
+
+    uint32_t deadline;
+    EXPECT_TRUE(deferred_exec_next_deadline(&deadline));
+    EXPECT_EQ(deadline, 1010);
+
+    EXPECT_TRUE(cancel_deferred_exec(tokens[0]));
+    EXPECT_TRUE(extend_deferred_exec(tokens[1], 500));
+    for (int i = 0; i < 300; ++i) {
+        advance_time(1);
+        deferred_exec_task();
+    }
+    EXPECT_EQ(log.size(), MAX_DEFERRED_EXECUTORS - 2);
+
+    EXPECT_TRUE(deferred_exec_next_deadline(&deadline));
+    EXPECT_EQ(deadline, 1500);
+    EXPECT_TRUE(cancel_deferred_exec(tokens[1]));
+    EXPECT_FALSE(deferred_exec_next_deadline(&deadline));
+}
@@ -0,0 +1,196 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+#include "test_trace_replay.hpp"
+
+extern "C" {
+#include "event_trace.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class EventTrace : public TestFixture {
+   public:
+    void SetUp() override {
+        event_trace_enable(true);
+        event_trace_clear();
+    }
+
+    std::vector<uint8_t> dump(uint8_t chunk_size = 32) {
+        std::vector<uint8_t> result;
+        uint8_t              chunk[UINT8_MAX];
+        uint8_t              length;
+        event_trace_dump_begin();
+        while ((length = event_trace_dump(chunk, chunk_size)) > 0) {
+            result.insert(result.end(), chunk, chunk + length);
+        }
+        return result;
+    }
+};
+
+TEST_F(EventTrace, RecordsKeyEventsReportsAndLayers) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 1, 2, KC_A);
+    KeymapKey  key_layer(0, 0, 0, MO(1));
+    set_keymap({key_a, key_layer, KeymapKey(1, 1, 2, KC_B)});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    idle_for(9);
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    key_layer.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // clang-format off
+    std::vector<uint8_t> expected = {
+        0x12, 0x00, 0x00, 0x02, 0x81,
+        0x32, 0x00, 0x00, 0x00, KC_A,
+        0x12, 0x0A, 0x00, 0x02, 0x01,
+        0x31, 0x00, 0x00, 0x00,
+        0x12, 0x01, 0x00, 0x00, 0x80,
+        0x24, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    };
+    // clang-format on
+    EXPECT_EQ(dump(), expected);
+    EXPECT_EQ(event_trace_size(), expected.size());
+    EXPECT_EQ(event_trace_dropped(), 0);
+
+    key_layer.release();
+    run_one_scan_loop();
+}
+
+TEST_F(EventTrace, DumpsWholeRecordsOnly) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    set_keymap({key_a});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap_key(key_a);
+
+    std::vector<uint8_t> full = dump();
+    ASSERT_EQ(full.size(), 19);
+
+    // An 8 byte buffer only fits one record at a time
+    uint8_t chunk[8];
+    event_trace_dump_begin();
+    EXPECT_EQ(event_trace_dump(chunk, sizeof(chunk)), 5);
+    EXPECT_EQ(event_trace_dump(chunk, sizeof(chunk)), 5);
+    EXPECT_EQ(event_trace_dump(chunk, sizeof(chunk)), 5);
+    EXPECT_EQ(event_trace_dump(chunk, sizeof(chunk)), 4);
+    EXPECT_EQ(event_trace_dump(chunk, sizeof(chunk)), 0);
+
+    // Too small for any record
+    event_trace_dump_begin();
+    EXPECT_EQ(event_trace_dump(chunk, 4), 0);
+
+    EXPECT_EQ(dump(8), full);
+}
+
+TEST_F(EventTrace, DropsOldestRecordsWhenFull) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    set_keymap({key_a});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < 10; i++) {
+        tap_key(key_a);
+    }
+
+    EXPECT_LE(event_trace_size(), EVENT_TRACE_BUFFER_SIZE);
+    EXPECT_GT(event_trace_dropped(), 0);
+
+    // Records stay intact, the most recent ones are kept
+    TraceReplay replay(dump());
+    ASSERT_FALSE(replay.expected_reports().empty());
+    EXPECT_EQ(replay.expected_reports().back().data, std::vector<uint8_t>({0x00}));
+
+    event_trace_clear();
+    EXPECT_EQ(event_trace_size(), 0);
+    EXPECT_EQ(event_trace_dropped(), 0);
+}
+
+TEST_F(EventTrace, DisabledRecordsNothing) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    set_keymap({key_a});
+
+    event_trace_enable(false);
+    EXPECT_FALSE(event_trace_is_enabled());
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap_key(key_a);
+    EXPECT_EQ(event_trace_size(), 0);
+}
+
+TEST_F(EventTrace, ReplayReproducesRecordedSession) {
+    TestDriver driver;
+    KeymapKey  mod_tap_key(0, 0, 0, LSFT_T(KC_A));
+    KeymapKey  key_b(0, 1, 0, KC_B);
+    KeymapKey  key_layer(0, 2, 0, MO(1));
+    set_keymap({mod_tap_key, key_b, key_layer, KeymapKey(1, 1, 0, KC_C)});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    mod_tap_key.press();
+    idle_for(30);
+    key_b.press();
+    idle_for(20);
+    mod_tap_key.release();
+    idle_for(15);
+    key_b.release();
+    idle_for(40);
+    mod_tap_key.press();
+    idle_for(TAPPING_TERM + 20);
+    tap_key(key_b, 10);
+    mod_tap_key.release();
+    idle_for(5);
+    key_layer.press();
+    idle_for(3);
+    tap_key(key_b, 7);
+    key_layer.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    ASSERT_EQ(event_trace_dropped(), 0);
+    TraceReplay replay(dump());
+    ASSERT_GE(replay.expected_reports().size(), 8);
+
+    event_trace_clear();
+    idle_for(TAPPING_TERM);
+    replay.run(*this, driver, TAPPING_TERM);
+    EXPECT_EQ(replay.expected_layers().size(), 2);
+    EXPECT_EQ(replay.actual_reports(), replay.expected_reports());
+    EXPECT_EQ(replay.actual_layers(), replay.expected_layers());
+}
+
+TEST_F(EventTrace, ReplayFromHexDump) {
+    TestDriver driver;
+    KeymapKey  mod_tap_key(0, 0, 0, LSFT_T(KC_A));
+    KeymapKey  key_b(0, 1, 0, KC_B);
+    set_keymap({mod_tap_key, key_b});
+
+    // Rolling from a mod-tap key onto another key within the tapping term
+    TraceReplay replay(
+        "12 00 00 00 80 "
+        "12 32 00 00 81 "
+        "12 1e 00 00 00 "
+        "32 00 00 00 04 "
+        "33 00 00 00 04 05 "
+        "32 00 00 00 05 "
+        "12 28 00 00 01 "
+        "31 00 00 00");
+    EXPECT_EQ(replay.duration(), 120);
+
+    replay.run(*this, driver);
+    EXPECT_EQ(replay.actual_reports(), replay.expected_reports());
+}
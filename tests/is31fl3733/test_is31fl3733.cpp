@@ -0,0 +1,149 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "i2c_master.h"
+#include "rgb_matrix.h"
+}
+
+// Each row of keys uses three SW lines, one per colour, and each column a CS line
+#define LED(row, col) {0, (row) * 48 + (col), (row) * 48 + 16 + (col), (row) * 48 + 32 + (col)}
+
+// clang-format off
+const is31fl3733_led_t PROGMEM g_is31fl3733_leds[IS31FL3733_LED_COUNT] = {
+    LED(0, 0), LED(0, 1), LED(0, 2), LED(0, 3), LED(0, 4), LED(0, 5), LED(0, 6), LED(0, 7), LED(0, 8), LED(0, 9),
+    LED(1, 0), LED(1, 1), LED(1, 2), LED(1, 3), LED(1, 4), LED(1, 5), LED(1, 6), LED(1, 7), LED(1, 8), LED(1, 9),
+    LED(2, 0), LED(2, 1), LED(2, 2), LED(2, 3), LED(2, 4), LED(2, 5), LED(2, 6), LED(2, 7), LED(2, 8), LED(2, 9),
+    LED(3, 0), LED(3, 1), LED(3, 2), LED(3, 3), LED(3, 4), LED(3, 5), LED(3, 6), LED(3, 7), LED(3, 8), LED(3, 9)
+};
+
+led_config_t g_led_config = {
+    {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+        {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+        {30, 31, 32, 33, 34, 35, 36, 37, 38, 39}
+    }, {
+        {  0,  0}, { 25,  0}, { 50,  0}, { 75,  0}, {100,  0}, {124,  0}, {149,  0}, {174,  0}, {199,  0}, {224,  0},
+        {  0, 21}, { 25, 21}, { 50, 21}, { 75, 21}, {100, 21}, {124, 21}, {149, 21}, {174, 21}, {199, 21}, {224, 21},
+        {  0, 43}, { 25, 43}, { 50, 43}, { 75, 43}, {100, 43}, {124, 43}, {149, 43}, {174, 43}, {199, 43}, {224, 43},
+        {  0, 64}, { 25, 64}, { 50, 64}, { 75, 64}, {100, 64}, {124, 64}, {149, 64}, {174, 64}, {199, 64}, {224, 64}
+    }, {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+    }
+};
+// clang-format on
+
+struct Transfer {
+    uint8_t  reg;
+    uint16_t length;
+};
+
+static std::vector<Transfer> transfers;
+static bool                  pwm_writes_fail = false;
+
+extern "C" void i2c_init(void) {}
+
+extern "C" i2c_status_t i2c_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    transfers.push_back({regaddr, length});
+    if (pwm_writes_fail && length > 1) {
+        return I2C_STATUS_TIMEOUT;
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+/* The first register of every PWM transfer, for each flush which selected the PWM page */
+static std::vector<std::vector<uint8_t>> pwm_flushes() {
+    std::vector<std::vector<uint8_t>> flushes;
+    for (const auto &transfer : transfers) {
+        if (transfer.reg == IS31FL3733_REG_COMMAND) {
+            flushes.emplace_back();
+        } else if (transfer.length > 1 && !flushes.empty()) {
+            flushes.back().push_back(transfer.reg);
+        }
+    }
+    return flushes;
+}
+
+/* Bytes sent over the bus, counting the device and register address of every transfer */
+static size_t bytes_written() {
+    size_t bytes = 0;
+    for (const auto &transfer : transfers) {
+        bytes += 2 + transfer.length;
+    }
+    return bytes;
+}
+
+class Is31fl3733 : public TestFixture {
+   public:
+    TestDriver driver;
+
+    void SetUp() override {
+        pwm_writes_fail = false;
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+        rgb_matrix_sethsv_noeeprom(0, 0, 100);
+        idle_for(100);
+        transfers.clear();
+    }
+};
+
+TEST_F(Is31fl3733, unchanged_frames_write_nothing) {
+    idle_for(100);
+    EXPECT_TRUE(transfers.empty());
+}
+
+TEST_F(Is31fl3733, full_screen_change_writes_every_transfer) {
+    rgb_matrix_sethsv_noeeprom(0, 0, 50);
+    idle_for(100);
+
+    auto flushes = pwm_flushes();
+    ASSERT_EQ(flushes.size(), 1);
+    EXPECT_EQ(flushes[0], (std::vector<uint8_t>{0, 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176}));
+    /* Selecting the page takes two single register writes */
+    EXPECT_EQ(bytes_written(), 2 * 3 + 12 * (2 + 16));
+}
+
+TEST_F(Is31fl3733, key_highlight_writes_only_its_transfers) {
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_REACTIVE_SIMPLE);
+    idle_for(100);
+    transfers.clear();
+
+    rgb_matrix_handle_key_event(1, 2, true);
+    rgb_matrix_handle_key_event(1, 2, false);
+    idle_for(1000);
+
+    /* LED 12 has its colours on SW4 to SW6, so only their transfers are sent while it fades out */
+    auto flushes = pwm_flushes();
+    ASSERT_GT(flushes.size(), 1);
+    for (const auto &flush : flushes) {
+        EXPECT_EQ(flush, (std::vector<uint8_t>{48, 64, 80}));
+    }
+    EXPECT_EQ(bytes_written(), flushes.size() * (2 * 3 + 3 * (2 + 16)));
+}
+
+TEST_F(Is31fl3733, failed_transfers_are_sent_again) {
+    pwm_writes_fail = true;
+    rgb_matrix_sethsv_noeeprom(0, 0, 50);
+    idle_for(100);
+    EXPECT_GT(pwm_flushes().size(), 1);
+
+    /* Nothing changes after the bus recovers, but the lost transfers are still owed */
+    pwm_writes_fail = false;
+    transfers.clear();
+    idle_for(100);
+
+    auto flushes = pwm_flushes();
+    ASSERT_EQ(flushes.size(), 1);
+    EXPECT_EQ(flushes[0], (std::vector<uint8_t>{0, 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176}));
+
+    transfers.clear();
+    idle_for(100);
+    EXPECT_TRUE(transfers.empty());
+}
@@ -0,0 +1,189 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+/* Keys held in an NKRO report, in ascending order */
+static std::vector<uint8_t> nkro_keys(const report_nkro_t &report) {
+    std::vector<uint8_t> keys;
+    for (uint16_t code = 0; code < NKRO_REPORT_BITS * 8; code++) {
+        if (report.bits[code >> 3] & 1 << (code & 7)) {
+            keys.push_back(code);
+        }
+    }
+    return keys;
+}
+
+MATCHER_P(NkroReport, keys, "") {
+    return arg.mods == 0 && nkro_keys(arg) == std::vector<uint8_t>(keys);
+}
+
+#define EXPECT_NKRO_REPORT(driver, ...) EXPECT_CALL(driver, send_nkro_mock(NkroReport(std::vector<uint8_t>{__VA_ARGS__})))
+
+class NkroAuto : public TestFixture {
+   public:
+    /* Adds keys sending consecutive letters to the keymap */
+    std::vector<KeymapKey> letters(uint8_t count) {
+        std::vector<KeymapKey> keys;
+        for (uint8_t i = 0; i < count; i++) {
+            keys.emplace_back(0, i % MATRIX_COLS, i / MATRIX_COLS, KC_A + i);
+            add_key(keys.back());
+        }
+        return keys;
+    }
+};
+
+TEST_F(NkroAuto, typing_only_sends_6kro_reports) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+
+    set_keymap({key_a, key_b});
+
+    EXPECT_CALL(driver, send_nkro_mock(_)).Times(0);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.press();
+    run_one_scan_loop();
+    key_b.press();
+    run_one_scan_loop();
+    key_a.release();
+    run_one_scan_loop();
+    key_b.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(NkroAuto, keys_beyond_six_go_to_nkro_report) {
+    TestDriver driver;
+    auto       keys = letters(8);
+
+    /* The first six keys fill the 6KRO report */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    EXPECT_CALL(driver, send_nkro_mock(_)).Times(0);
+    for (uint8_t i = 0; i < 6; i++) {
+        keys[i].press();
+        run_one_scan_loop();
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    /* The following ones are sent in the NKRO report, leaving the 6KRO report untouched */
+    {
+        InSequence s;
+        EXPECT_NO_REPORT(driver);
+        EXPECT_NKRO_REPORT(driver, KC_G);
+        EXPECT_NKRO_REPORT(driver, KC_G, KC_H);
+        keys[6].press();
+        run_one_scan_loop();
+        keys[7].press();
+        run_one_scan_loop();
+        VERIFY_AND_CLEAR(driver);
+    }
+
+    /* Releasing a key of the 6KRO report doesn't move the overflowing keys over */
+    {
+        InSequence s;
+        EXPECT_REPORT(driver, (KC_B, KC_C, KC_D, KC_E, KC_F));
+        EXPECT_CALL(driver, send_nkro_mock(_)).Times(0);
+        keys[0].release();
+        run_one_scan_loop();
+        VERIFY_AND_CLEAR(driver);
+    }
+
+    {
+        InSequence s;
+        EXPECT_NO_REPORT(driver);
+        EXPECT_NKRO_REPORT(driver, KC_H);
+        EXPECT_NKRO_REPORT(driver);
+        keys[6].release();
+        run_one_scan_loop();
+        keys[7].release();
+        run_one_scan_loop();
+        VERIFY_AND_CLEAR(driver);
+    }
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(5);
+    EXPECT_CALL(driver, send_nkro_mock(_)).Times(0);
+    for (uint8_t i = 1; i < 6; i++) {
+        keys[i].release();
+        run_one_scan_loop();
+    }
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(NkroAuto, freed_6kro_slot_is_reused_before_nkro_report) {
+    TestDriver driver;
+    auto       keys = letters(8);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    EXPECT_NKRO_REPORT(driver, KC_G);
+    for (uint8_t i = 0; i < 7; i++) {
+        keys[i].press();
+        run_one_scan_loop();
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    /* The key pressed after a slot of the 6KRO report is freed takes it */
+    {
+        InSequence s;
+        EXPECT_REPORT(driver, (KC_B, KC_C, KC_D, KC_E, KC_F));
+        EXPECT_REPORT(driver, (KC_B, KC_C, KC_D, KC_E, KC_F, KC_H));
+        EXPECT_CALL(driver, send_nkro_mock(_)).Times(0);
+        keys[0].release();
+        run_one_scan_loop();
+        keys[7].press();
+        run_one_scan_loop();
+        VERIFY_AND_CLEAR(driver);
+    }
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    EXPECT_NKRO_REPORT(driver);
+    for (uint8_t i = 1; i < 8; i++) {
+        keys[i].release();
+        run_one_scan_loop();
+    }
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(NkroAuto, modifiers_are_sent_in_6kro_report) {
+    TestDriver driver;
+    auto       keys  = letters(7);
+    auto       shift = KeymapKey(0, 0, 3, KC_LEFT_SHIFT);
+
+    add_key(shift);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(7);
+    EXPECT_NKRO_REPORT(driver, KC_G);
+    shift.press();
+    run_one_scan_loop();
+    for (auto &key : keys) {
+        key.press();
+        run_one_scan_loop();
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D, KC_E, KC_F));
+    EXPECT_CALL(driver, send_nkro_mock(_)).Times(0);
+    shift.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    EXPECT_NKRO_REPORT(driver);
+    for (auto &key : keys) {
+        key.release();
+        run_one_scan_loop();
+    }
+    VERIFY_AND_CLEAR(driver);
+}
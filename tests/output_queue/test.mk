@@ -0,0 +1,6 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+OUTPUT_QUEUE_ENABLE = yes
+DYNAMIC_MACRO_ENABLE = yes
+UNICODE_ENABLE = yes
@@ -0,0 +1,225 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class OutputQueue : public TestFixture {
+   public:
+    void SetUp() override {
+        output_queue_clear();
+    }
+};
+
+TEST_F(OutputQueue, tap_is_held_without_blocking) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    EXPECT_TRUE(output_queue_tap_code16_delay(LSFT(KC_A), 50));
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_A));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(48);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(2);
+    EXPECT_FALSE(output_queue_pending());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(OutputQueue, keys_are_processed_during_delays) {
+    TestDriver driver;
+    InSequence s;
+    auto       regular_key = KeymapKey(0, 1, 0, KC_B);
+
+    set_keymap({regular_key});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_TRUE(output_queue_tap_code16(KC_A));
+    EXPECT_TRUE(output_queue_delay(200));
+    EXPECT_TRUE(output_queue_tap_code16(KC_C));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* The keyboard keeps running while the queue waits */
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(50);
+    tap_key(regular_key);
+    EXPECT_TRUE(output_queue_pending());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(200);
+    EXPECT_FALSE(output_queue_pending());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(OutputQueue, full_queue_rejects_whole_tap) {
+    TestDriver driver;
+
+    EXPECT_TRUE(output_queue_tap_code16_delay(KC_A, 10));
+    EXPECT_TRUE(output_queue_tap_code16_delay(KC_B, 10));
+    EXPECT_FALSE(output_queue_tap_code16_delay(KC_C, 10));
+    EXPECT_TRUE(output_queue_tap_code16(KC_D));
+
+    InSequence s;
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(25);
+    EXPECT_FALSE(output_queue_pending());
+    VERIFY_AND_CLEAR(driver);
+}
+
+static uint16_t count_down(void *cb_arg) {
+    uint8_t *remaining = (uint8_t *)cb_arg;
+    tap_code(KC_X);
+    return --*remaining ? 10 : 0;
+}
+
+TEST_F(OutputQueue, callback_holds_back_following_steps) {
+    TestDriver driver;
+    uint8_t    remaining = 3;
+
+    EXPECT_TRUE(output_queue_callback(count_down, &remaining));
+    EXPECT_TRUE(output_queue_tap_code16(KC_Y));
+
+    InSequence s;
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_Y));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(20);
+    EXPECT_EQ(remaining, 0);
+    EXPECT_FALSE(output_queue_pending());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(OutputQueue, dynamic_macro_plays_in_background) {
+    TestDriver driver;
+    auto       record_key = KeymapKey(0, 0, 0, DM_REC1);
+    auto       stop_key   = KeymapKey(0, 1, 0, DM_RSTP);
+    auto       play_key   = KeymapKey(0, 2, 0, DM_PLY1);
+    auto       key_a      = KeymapKey(0, 3, 0, KC_A);
+    auto       key_b      = KeymapKey(0, 4, 0, KC_B);
+
+    set_keymap({record_key, stop_key, play_key, key_a, key_b});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(4);
+    tap_key(record_key);
+    tap_key(key_a);
+    tap_key(key_b);
+    tap_key(stop_key);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Playback runs from the queue, one recorded event per millisecond */
+    InSequence s;
+    EXPECT_REPORT(driver, (KC_A));
+    tap_key(play_key);
+    EXPECT_TRUE(output_queue_pending());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(10);
+    EXPECT_FALSE(output_queue_pending());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(OutputQueue, dynamic_macro_leaves_user_keys_and_layers_alone) {
+    TestDriver driver;
+    auto       record_key = KeymapKey(0, 0, 0, DM_REC1);
+    auto       stop_key   = KeymapKey(0, 1, 0, DM_RSTP);
+    auto       no_key     = KeymapKey(0, 2, 0, KC_NO);
+    auto       play_key   = KeymapKey(1, 2, 0, DM_PLY1);
+    auto       key_a      = KeymapKey(0, 3, 0, KC_A);
+    auto       key_x      = KeymapKey(1, 3, 0, KC_X);
+    auto       key_b      = KeymapKey(0, 4, 0, KC_B);
+    auto       key_y      = KeymapKey(1, 4, 0, KC_Y);
+    auto       layer_key  = KeymapKey(0, 5, 0, MO(1));
+    auto       key_c      = KeymapKey(0, 6, 0, KC_C);
+    auto       trans_c    = KeymapKey(1, 6, 0, KC_TRANSPARENT);
+
+    set_keymap({record_key, stop_key, no_key, play_key, key_a, key_x, key_b, key_y, layer_key, key_c, trans_c});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(4);
+    tap_key(record_key);
+    tap_key(key_a);
+    tap_key(key_b);
+    tap_key(stop_key);
+    VERIFY_AND_CLEAR(driver);
+
+    InSequence s;
+    EXPECT_REPORT(driver, (KC_C));
+    key_c.press();
+    run_one_scan_loop();
+    layer_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* The macro plays on the layers it was recorded on, while the user's key and layer stay held */
+    EXPECT_REPORT(driver, (KC_C, KC_A));
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_REPORT(driver, (KC_C, KC_B));
+    EXPECT_REPORT(driver, (KC_C));
+    tap_key(play_key);
+    idle_for(10);
+    EXPECT_FALSE(output_queue_pending());
+    EXPECT_TRUE(layer_state_is(1));
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    layer_key.release();
+    run_one_scan_loop();
+    key_c.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(OutputQueue, unicode_keycodes_are_typed) {
+    TestDriver driver;
+
+    EXPECT_ANY_REPORT(driver).Times(testing::AtLeast(2));
+    EXPECT_TRUE(output_queue_tap_code16(UC(0x00E9)));
+    idle_for(10);
+    EXPECT_FALSE(output_queue_pending());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(OutputQueue, unsupported_keycodes_are_rejected) {
+    TestDriver driver;
+
+    EXPECT_NO_REPORT(driver);
+    EXPECT_FALSE(output_queue_tap_code16(QK_BOOT));
+    EXPECT_FALSE(output_queue_register_code16(MO(1)));
+    EXPECT_FALSE(output_queue_pending());
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,187 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <string>
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "profiling.h"
+}
+
+using testing::_;
+
+static void busy_wait_us(uint32_t us) {
+    uint32_t start = profiling_timestamp();
+    while (profiling_ticks_to_ns(profiling_timestamp() - start) < us * 1000) {
+    }
+}
+
+static const profiling_zone_t *find_zone(const char *name, uint8_t *index = nullptr) {
+    for (uint8_t i = 0; i < profiling_zone_count(); ++i) {
+        const profiling_zone_t *zone = profiling_get_zone(i);
+        if (strcmp(zone->name, name) == 0) {
+            if (index) {
+                *index = i;
+            }
+            return zone;
+        }
+    }
+    return nullptr;
+}
+
+static uint32_t read_u32(const uint8_t *data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+class Profiling : public TestFixture {
+   public:
+    void SetUp() override {
+        profiling_reset();
+    }
+};
+
+TEST_F(Profiling, CallSitesSharingANameShareAZone) {
+    for (int i = 0; i < 3; ++i) {
+        PROFILE_ZONE_BEGIN("shared");
+        PROFILE_ZONE_END();
+    }
+    PROFILE_ZONE("shared", busy_wait_us(1));
+
+    const profiling_zone_t *zone = find_zone("shared");
+    ASSERT_NE(zone, nullptr);
+    EXPECT_EQ(zone->count, 4);
+
+    uint8_t count = profiling_zone_count();
+    PROFILE_ZONE("shared", {});
+    EXPECT_EQ(profiling_zone_count(), count);
+}
+
+TEST_F(Profiling, MeasuresDurations) {
+    for (int i = 0; i < 5; ++i) {
+        PROFILE_ZONE("busy", busy_wait_us(200));
+    }
+
+    const profiling_zone_t *zone = find_zone("busy");
+    ASSERT_NE(zone, nullptr);
+    EXPECT_EQ(zone->count, 5);
+    EXPECT_GE(profiling_ticks_to_ns(zone->min_ticks), 200000);
+    EXPECT_GE(profiling_ticks_to_ns(zone->max_ticks), profiling_ticks_to_ns(zone->min_ticks));
+    EXPECT_GE(zone->total_ticks, (uint64_t)zone->min_ticks * 5);
+
+    uint32_t histogram_total = 0;
+    for (uint8_t b = 0; b < PROFILING_HISTOGRAM_BUCKETS; ++b) {
+        histogram_total += zone->histogram[b];
+    }
+    EXPECT_EQ(histogram_total, zone->count);
+    // 200us falls in [128, 256) or above, never below
+    for (uint8_t b = 0; b < 8; ++b) {
+        EXPECT_EQ(zone->histogram[b], 0) << "bucket " << (int)b;
+    }
+}
+
+TEST_F(Profiling, NestedZonesIncludeInnerTime) {
+    PROFILE_ZONE_BEGIN("outer");
+    busy_wait_us(50);
+    PROFILE_ZONE("inner", busy_wait_us(100));
+    PROFILE_ZONE_END();
+
+    const profiling_zone_t *outer = find_zone("outer");
+    const profiling_zone_t *inner = find_zone("inner");
+    ASSERT_NE(outer, nullptr);
+    ASSERT_NE(inner, nullptr);
+    EXPECT_EQ(outer->count, 1);
+    EXPECT_EQ(inner->count, 1);
+    EXPECT_GE(profiling_ticks_to_ns(inner->max_ticks), 100000);
+    EXPECT_GE(outer->total_ticks, inner->total_ticks);
+}
+
+TEST_F(Profiling, FramesBeyondMaximumDepthAreNotMeasured) {
+    PROFILE_ZONE_BEGIN("depth_1");
+    PROFILE_ZONE_BEGIN("depth_2");
+    PROFILE_ZONE_BEGIN("depth_3");
+    PROFILE_ZONE_END();
+    PROFILE_ZONE_END();
+    PROFILE_ZONE_END();
+
+    EXPECT_EQ(find_zone("depth_1")->count, 1);
+    EXPECT_EQ(find_zone("depth_2")->count, 1);
+    EXPECT_EQ(find_zone("depth_3")->count, 0);
+
+    // Unbalanced ends are ignored
+    PROFILE_ZONE_END();
+    PROFILE_ZONE("depth_1", {});
+    EXPECT_EQ(find_zone("depth_1")->count, 2);
+}
+
+TEST_F(Profiling, ResetKeepsRegistrations) {
+    PROFILE_ZONE("reset", busy_wait_us(1));
+    uint8_t count = profiling_zone_count();
+
+    profiling_reset();
+    EXPECT_EQ(profiling_zone_count(), count);
+    const profiling_zone_t *zone = find_zone("reset");
+    ASSERT_NE(zone, nullptr);
+    EXPECT_EQ(zone->count, 0);
+    EXPECT_EQ(zone->total_ticks, 0);
+    EXPECT_EQ(zone->max_ticks, 0);
+}
+
+TEST_F(Profiling, SerializesZones) {
+    for (int i = 0; i < 3; ++i) {
+        PROFILE_ZONE("serialized", busy_wait_us(20));
+    }
+    uint8_t                 index;
+    const profiling_zone_t *zone = find_zone("serialized", &index);
+    ASSERT_NE(zone, nullptr);
+
+    uint8_t data[64];
+    uint8_t length = profiling_serialize_zone(index, data, sizeof(data));
+    EXPECT_EQ(length, 17 + strlen("serialized") + 1);
+    EXPECT_EQ(data[0], index);
+    EXPECT_EQ(read_u32(&data[1]), 3);
+    EXPECT_GE(read_u32(&data[5]), 20000);
+    EXPECT_GE(read_u32(&data[9]), read_u32(&data[5]));
+    EXPECT_GE(read_u32(&data[13]), read_u32(&data[9]));
+    EXPECT_STREQ((const char *)&data[17], "serialized");
+
+    // Names are truncated to fit, and invalid requests produce nothing
+    EXPECT_EQ(profiling_serialize_zone(index, data, 20), 20);
+    EXPECT_EQ(std::string((const char *)&data[17], 3), "ser");
+    EXPECT_EQ(profiling_serialize_zone(index, data, 16), 0);
+    EXPECT_EQ(profiling_serialize_zone(PROFILING_MAX_ZONES, data, sizeof(data)), 0);
+
+    length = profiling_serialize_histogram(index, data, sizeof(data));
+    EXPECT_EQ(length, 2 + PROFILING_HISTOGRAM_BUCKETS * 2);
+    EXPECT_EQ(data[1], PROFILING_HISTOGRAM_BUCKETS);
+    uint32_t histogram_total = 0;
+    for (uint8_t b = 0; b < data[1]; ++b) {
+        histogram_total += data[2 + b * 2] | (data[3 + b * 2] << 8);
+    }
+    EXPECT_EQ(histogram_total, 3);
+
+    EXPECT_EQ(profiling_serialize_histogram(index, data, 8), 8);
+    EXPECT_EQ(data[1], 3);
+}
+
+TEST_F(Profiling, CoreZonesAreAnnotated) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    set_keymap({key_a});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    const profiling_zone_t *matrix_scan = find_zone("matrix_scan");
+    ASSERT_NE(matrix_scan, nullptr);
+    EXPECT_GT(matrix_scan->count, 0);
+
+    const profiling_zone_t *action_exec = find_zone("action_exec");
+    ASSERT_NE(action_exec, nullptr);
+    EXPECT_EQ(action_exec->count, 2);
+}
@@ -0,0 +1,9 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define RAW_HID_STREAM_TX_SIZE 256
+#define RAW_HID_STREAM_RX_SIZE 112
@@ -0,0 +1,256 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <deque>
+#include <vector>
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "raw_hid.h"
+#include "raw_hid_stream.h"
+}
+
+using Report = std::array<uint8_t, RAW_HID_STREAM_REPORT_SIZE>;
+
+static std::deque<Report> sent;
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) {
+    Report report{};
+    std::copy(data, data + std::min<size_t>(length, report.size()), report.begin());
+    sent.push_back(report);
+}
+
+class RawHidStream : public TestFixture {
+   public:
+    TestDriver driver;
+
+    void SetUp() override {
+        raw_hid_stream_clear();
+        sent.clear();
+    }
+
+    /* Sends a frame from the host, returning whether the device took it as part of the stream */
+    bool host_send(uint8_t type, uint8_t seq, uint8_t length, const std::vector<uint8_t> &payload = {}) {
+        Report report{};
+        report[0] = RAW_HID_STREAM_ID;
+        report[1] = type;
+        report[2] = seq;
+        report[3] = length;
+        std::copy(payload.begin(), payload.end(), report.begin() + 4);
+        return raw_hid_stream_receive(report.data(), report.size());
+    }
+
+    Report next_frame() {
+        EXPECT_FALSE(sent.empty());
+        if (sent.empty()) {
+            return Report{};
+        }
+        Report report = sent.front();
+        sent.pop_front();
+        EXPECT_EQ(report[0], RAW_HID_STREAM_ID);
+        return report;
+    }
+
+    void expect_control(uint8_t type, uint8_t ack, uint8_t window) {
+        Report report = next_frame();
+        EXPECT_EQ(report[1], type);
+        EXPECT_EQ(report[2], ack);
+        EXPECT_EQ(report[3], window);
+    }
+
+    /* Pops a data frame, appending its payload to the data received by the host */
+    void expect_data(uint8_t seq, std::vector<uint8_t> &received) {
+        Report report = next_frame();
+        EXPECT_EQ(report[1], RAW_HID_STREAM_DATA);
+        EXPECT_EQ(report[2], seq);
+        ASSERT_GE(report[3], 1);
+        ASSERT_LE(report[3], RAW_HID_STREAM_PAYLOAD_SIZE);
+        received.insert(received.end(), report.begin() + 4, report.begin() + 4 + report[3]);
+    }
+};
+
+static std::vector<uint8_t> pattern(size_t length, uint8_t start = 0) {
+    std::vector<uint8_t> data(length);
+    for (size_t i = 0; i < length; i++) {
+        data[i] = start + i;
+    }
+    return data;
+}
+
+TEST_F(RawHidStream, other_reports_are_not_consumed) {
+    Report report{};
+    report[0] = 0x01;
+    EXPECT_FALSE(raw_hid_stream_receive(report.data(), report.size()));
+    run_one_scan_loop();
+    EXPECT_TRUE(sent.empty());
+}
+
+TEST_F(RawHidStream, nothing_is_sent_until_the_host_resets) {
+    auto data = pattern(10);
+    EXPECT_EQ(raw_hid_stream_write(data.data(), data.size()), 10);
+    idle_for(100);
+    EXPECT_TRUE(sent.empty());
+    EXPECT_FALSE(raw_hid_stream_flushed());
+
+    /* The device answers with its own window, 112 bytes being four frames */
+    EXPECT_TRUE(host_send(RAW_HID_STREAM_RESET, 0, 8));
+    run_one_scan_loop();
+    expect_control(RAW_HID_STREAM_ACK, 0, 4);
+
+    std::vector<uint8_t> received;
+    expect_data(0, received);
+    EXPECT_EQ(received, data);
+    EXPECT_TRUE(sent.empty());
+
+    host_send(RAW_HID_STREAM_ACK, 1, 8);
+    EXPECT_TRUE(raw_hid_stream_flushed());
+}
+
+TEST_F(RawHidStream, device_sends_no_more_than_the_window) {
+    auto data = pattern(200);
+    EXPECT_EQ(raw_hid_stream_write(data.data(), data.size()), 200);
+    host_send(RAW_HID_STREAM_RESET, 0, 3);
+    run_one_scan_loop();
+    expect_control(RAW_HID_STREAM_ACK, 0, 4);
+
+    std::vector<uint8_t> received;
+    expect_data(0, received);
+    expect_data(1, received);
+    expect_data(2, received);
+    EXPECT_TRUE(sent.empty());
+    idle_for(10);
+    EXPECT_TRUE(sent.empty());
+
+    /* Each acknowledgement moves the window on, up to the burst limit per task */
+    host_send(RAW_HID_STREAM_ACK, 2, 16);
+    run_one_scan_loop();
+    for (uint8_t seq = 3; seq < 3 + RAW_HID_STREAM_BURST; seq++) {
+        expect_data(seq, received);
+    }
+    EXPECT_TRUE(sent.empty());
+    run_one_scan_loop();
+    expect_data(7, received);
+    EXPECT_TRUE(sent.empty());
+    EXPECT_EQ(received, data);
+
+    host_send(RAW_HID_STREAM_ACK, 8, 16);
+    EXPECT_TRUE(raw_hid_stream_flushed());
+    EXPECT_EQ(raw_hid_stream_writable(), RAW_HID_STREAM_TX_SIZE);
+}
+
+TEST_F(RawHidStream, write_is_limited_by_the_transmit_buffer) {
+    auto data = pattern(RAW_HID_STREAM_TX_SIZE + 10);
+    EXPECT_EQ(raw_hid_stream_write(data.data(), data.size()), RAW_HID_STREAM_TX_SIZE);
+    EXPECT_EQ(raw_hid_stream_writable(), 0);
+
+    host_send(RAW_HID_STREAM_RESET, 0, 1);
+    run_one_scan_loop();
+    sent.clear();
+
+    /* Space is only freed once acknowledged */
+    EXPECT_EQ(raw_hid_stream_writable(), 0);
+    host_send(RAW_HID_STREAM_ACK, 1, 1);
+    EXPECT_EQ(raw_hid_stream_writable(), RAW_HID_STREAM_PAYLOAD_SIZE);
+}
+
+TEST_F(RawHidStream, nak_resends_from_the_sequence_number) {
+    auto data = pattern(100);
+    raw_hid_stream_write(data.data(), data.size());
+    host_send(RAW_HID_STREAM_RESET, 0, 4);
+    run_one_scan_loop();
+    expect_control(RAW_HID_STREAM_ACK, 0, 4);
+
+    std::vector<uint8_t> received;
+    expect_data(0, received);
+    sent.clear();
+
+    host_send(RAW_HID_STREAM_NAK, 1, 4);
+    run_one_scan_loop();
+    expect_data(1, received);
+    expect_data(2, received);
+    expect_data(3, received);
+    EXPECT_TRUE(sent.empty());
+    EXPECT_EQ(received, data);
+}
+
+TEST_F(RawHidStream, unacknowledged_frames_are_resent_after_timeout) {
+    auto data = pattern(40);
+    raw_hid_stream_write(data.data(), data.size());
+    host_send(RAW_HID_STREAM_RESET, 0, 4);
+    run_one_scan_loop();
+    sent.clear();
+
+    idle_for(RAW_HID_STREAM_RETRANSMIT_TIMEOUT - 2);
+    EXPECT_TRUE(sent.empty());
+    idle_for(2);
+
+    std::vector<uint8_t> received;
+    expect_data(0, received);
+    expect_data(1, received);
+    EXPECT_TRUE(sent.empty());
+    EXPECT_EQ(received, data);
+
+    /* A stale acknowledgement is ignored */
+    host_send(RAW_HID_STREAM_ACK, 5, 4);
+    EXPECT_FALSE(raw_hid_stream_flushed());
+    host_send(RAW_HID_STREAM_ACK, 2, 4);
+    EXPECT_TRUE(raw_hid_stream_flushed());
+    idle_for(RAW_HID_STREAM_RETRANSMIT_TIMEOUT * 2);
+    EXPECT_TRUE(sent.empty());
+}
+
+TEST_F(RawHidStream, host_data_is_acknowledged_with_remaining_window) {
+    host_send(RAW_HID_STREAM_RESET, 0, 0);
+    run_one_scan_loop();
+    expect_control(RAW_HID_STREAM_ACK, 0, 4);
+
+    host_send(RAW_HID_STREAM_DATA, 0, 28, pattern(28));
+    host_send(RAW_HID_STREAM_DATA, 1, 28, pattern(28, 28));
+    host_send(RAW_HID_STREAM_DATA, 2, 28, pattern(28, 56));
+    host_send(RAW_HID_STREAM_DATA, 3, 28, pattern(28, 84));
+    run_one_scan_loop();
+    expect_control(RAW_HID_STREAM_ACK, 4, 0);
+    EXPECT_TRUE(sent.empty());
+    EXPECT_EQ(raw_hid_stream_available(), 112);
+
+    /* A frame beyond the window is refused, once */
+    host_send(RAW_HID_STREAM_DATA, 4, 28, pattern(28, 112));
+    host_send(RAW_HID_STREAM_DATA, 5, 28, pattern(28, 140));
+    run_one_scan_loop();
+    expect_control(RAW_HID_STREAM_NAK, 4, 0);
+    EXPECT_TRUE(sent.empty());
+
+    /* Reading makes room, and the host is told right away */
+    std::vector<uint8_t> buffer(60);
+    EXPECT_EQ(raw_hid_stream_read(buffer.data(), 10), 10);
+    run_one_scan_loop();
+    EXPECT_TRUE(sent.empty());
+    EXPECT_EQ(raw_hid_stream_read(buffer.data() + 10, 50), 50);
+    EXPECT_EQ(buffer, pattern(60));
+    run_one_scan_loop();
+    expect_control(RAW_HID_STREAM_ACK, 4, 2);
+    EXPECT_EQ(raw_hid_stream_available(), 52);
+}
+
+TEST_F(RawHidStream, host_frames_out_of_order) {
+    host_send(RAW_HID_STREAM_RESET, 0, 0);
+    run_one_scan_loop();
+    sent.clear();
+
+    host_send(RAW_HID_STREAM_DATA, 1, 5, pattern(5));
+    host_send(RAW_HID_STREAM_DATA, 2, 5, pattern(5));
+    run_one_scan_loop();
+    expect_control(RAW_HID_STREAM_NAK, 0, 4);
+    EXPECT_TRUE(sent.empty());
+    EXPECT_EQ(raw_hid_stream_available(), 0);
+
+    /* A duplicate is acknowledged again without being stored twice */
+    host_send(RAW_HID_STREAM_DATA, 0, 5, pattern(5));
+    host_send(RAW_HID_STREAM_DATA, 0, 5, pattern(5));
+    run_one_scan_loop();
+    expect_control(RAW_HID_STREAM_ACK, 1, 3);
+    EXPECT_TRUE(sent.empty());
+    EXPECT_EQ(raw_hid_stream_available(), 5);
+}
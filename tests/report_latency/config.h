@@ -0,0 +1,9 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define REPORT_LATENCY_BUCKET_US 1000
+#define REPORT_LATENCY_BUCKETS 10
@@ -0,0 +1,149 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "test_polling_host.hpp"
+
+extern "C" {
+#include "report_latency.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class ReportLatency : public TestFixture {
+   public:
+    void SetUp() override {
+        report_latency_reset();
+    }
+
+    const report_latency_t &keyboard_latency() {
+        return *get_report_latency(TestPollingHost::KEYBOARD_ENDPOINT);
+    }
+};
+
+TEST_F(ReportLatency, histogram_buckets) {
+    report_latency_record(2, 200);
+    report_latency_record(2, 1500);
+    report_latency_record(2, 1999);
+    report_latency_record(2, 250000);
+
+    const report_latency_t *latency = get_report_latency(2);
+    ASSERT_NE(latency, nullptr);
+    EXPECT_EQ(latency->count, 4);
+    EXPECT_EQ(latency->min_us, 200);
+    EXPECT_EQ(latency->max_us, 250000);
+    EXPECT_EQ(get_report_latency_average(2), (200 + 1500 + 1999 + 250000) / 4);
+    EXPECT_EQ(latency->histogram[0], 1);
+    EXPECT_EQ(latency->histogram[1], 2);
+    EXPECT_EQ(latency->histogram[REPORT_LATENCY_BUCKETS - 1], 1);
+
+    /* Other endpoints are kept apart, and unknown ones ignored */
+    EXPECT_EQ(get_report_latency(1)->count, 0);
+    EXPECT_EQ(get_report_latency_average(1), 0);
+    report_latency_record(REPORT_LATENCY_MAX_ENDPOINTS, 100);
+    EXPECT_EQ(get_report_latency(REPORT_LATENCY_MAX_ENDPOINTS), nullptr);
+
+    report_latency_reset();
+    EXPECT_EQ(get_report_latency(2)->count, 0);
+}
+
+TEST_F(ReportLatency, reports_wait_for_the_host_to_poll) {
+    TestDriver      driver;
+    TestPollingHost host(8);
+    auto            key = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key});
+
+    /* Pressed at 1ms, the report waits in the queue until the poll at 8ms */
+    idle_for(1);
+    EXPECT_NO_REPORT(driver);
+    key.press();
+    run_one_scan_loop();
+    EXPECT_EQ(host.queued(TestPollingHost::KEYBOARD_ENDPOINT), 1);
+    idle_for(5);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    idle_for(1);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(host.queued(TestPollingHost::KEYBOARD_ENDPOINT), 0);
+    EXPECT_EQ(keyboard_latency().count, 1);
+    EXPECT_EQ(keyboard_latency().max_us, 7000);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    idle_for(8);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ReportLatency, every_transition_is_delivered_in_order) {
+    TestDriver      driver;
+    TestPollingHost host(4);
+    auto            key_a = KeymapKey(0, 0, 0, KC_A);
+    auto            key_b = KeymapKey(0, 1, 0, KC_B);
+    set_keymap({key_a, key_b});
+
+    /* Four reports sent within one polling interval are polled one per interval, from 4ms */
+    InSequence s;
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    tap_key(key_b);
+    EXPECT_EQ(host.queued(TestPollingHost::KEYBOARD_ENDPOINT), 3);
+    idle_for(16);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(keyboard_latency().count, 4);
+    EXPECT_EQ(keyboard_latency().min_us, 4000);
+    EXPECT_EQ(keyboard_latency().max_us, 13000);
+}
+
+TEST_F(ReportLatency, latency_spreads_over_the_polling_interval) {
+    TestDriver      driver;
+    TestPollingHost host(8);
+    auto            key = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key});
+
+    /* Each cycle takes 33ms, so the presses and releases hit every phase of the polling interval */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int cycle = 0; cycle < 8; cycle++) {
+        key.press();
+        idle_for(16);
+        key.release();
+        idle_for(17);
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    const report_latency_t &latency = keyboard_latency();
+    EXPECT_EQ(latency.count, 16);
+    EXPECT_EQ(latency.min_us, 1000);
+    EXPECT_EQ(latency.max_us, 8000);
+    EXPECT_EQ(get_report_latency_average(TestPollingHost::KEYBOARD_ENDPOINT), 4500);
+    for (uint8_t b = 1; b <= 8; b++) {
+        EXPECT_GT(latency.histogram[b], 0) << "bucket " << +b;
+    }
+}
+
+TEST_F(ReportLatency, reports_are_immediate_without_polling_host) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(keyboard_latency().count, 0);
+}
@@ -0,0 +1,10 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define RGB_MATRIX_LED_COUNT 20
+#define RGB_MATRIX_HSV_BATCH_SIZE 8
+#define ENABLE_RGB_MATRIX_CYCLE_LEFT_RIGHT
@@ -0,0 +1,87 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+}
+
+// clang-format off
+led_config_t g_led_config = {
+    {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19}
+    }, {
+        {  0,  0}, { 25,  0}, { 50,  0}, { 75,  0}, {100,  0}, {124,  0}, {149,  0}, {174,  0}, {199,  0}, {224,  0},
+        {  0, 64}, { 25, 64}, { 50, 64}, { 75, 64}, {100, 64}, {124, 64}, {149, 64}, {174, 64}, {199, 64}, {224, 64}
+    }, {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+    }
+};
+// clang-format on
+
+static rgb_t leds[RGB_MATRIX_LED_COUNT];
+
+static void fake_init(void) {}
+
+static void fake_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+    leds[index] = (rgb_t){r, g, b};
+}
+
+static void fake_set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        fake_set_color(i, r, g, b);
+    }
+}
+
+static void fake_flush(void) {}
+
+extern "C" const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = fake_init,
+    .set_color     = fake_set_color,
+    .set_color_all = fake_set_color_all,
+    .flush         = fake_flush,
+};
+
+static bool limit_brightness = false;
+
+/* Halves the brightness, like keyboards which limit it to the power available */
+extern "C" rgb_t rgb_matrix_hsv_to_rgb(hsv_t hsv) {
+    if (limit_brightness) {
+        hsv.v /= 2;
+    }
+    return hsv_to_rgb(hsv);
+}
+
+class RgbMatrixHsvToRgb : public TestFixture {
+   public:
+    TestDriver driver;
+
+    void SetUp() override {
+        limit_brightness = false;
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_CYCLE_LEFT_RIGHT);
+        rgb_matrix_sethsv_noeeprom(0, 255, 200);
+        rgb_matrix_set_speed_noeeprom(0);
+    }
+
+    std::vector<rgb_t> frame() {
+        idle_for(100);
+        return std::vector<rgb_t>(leds, leds + RGB_MATRIX_LED_COUNT);
+    }
+};
+
+TEST_F(RgbMatrixHsvToRgb, effect_runners_use_the_replaced_conversion) {
+    auto full = frame();
+    limit_brightness = true;
+    auto limited = frame();
+
+    /* Every LED is drawn, in more than one batch, at the halved brightness */
+    for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        SCOPED_TRACE(i);
+        EXPECT_EQ(MAX(full[i].r, MAX(full[i].g, full[i].b)), hsv_to_rgb({0, 0, 200}).r);
+        EXPECT_EQ(MAX(limited[i].r, MAX(limited[i].g, limited[i].b)), hsv_to_rgb({0, 0, 100}).r);
+    }
+}
@@ -0,0 +1,10 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+RGB_MATRIX_ENABLE = yes
+RGB_MATRIX_DRIVER = custom
+RGB_MATRIX_CUSTOM_USER = yes
+
+# Same tests and effect as the parent suite, without the geometry cache
+VPATH += $(TOP_DIR)/tests/rgb_matrix_reactive_splash
+SRC += tests/rgb_matrix_reactive_splash/test_rgb_matrix_reactive_splash.cpp
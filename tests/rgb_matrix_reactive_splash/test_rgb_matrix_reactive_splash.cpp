@@ -0,0 +1,169 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+}
+
+using testing::_;
+
+// clang-format off
+led_config_t g_led_config = {
+    {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+        {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+        {30, 31, 32, 33, 34, 35, 36, 37, 38, 39}
+    }, {
+        {  0,  0}, { 25,  0}, { 50,  0}, { 75,  0}, {100,  0}, {124,  0}, {149,  0}, {174,  0}, {199,  0}, {224,  0},
+        {  0, 21}, { 25, 21}, { 50, 21}, { 75, 21}, {100, 21}, {124, 21}, {149, 21}, {174, 21}, {199, 21}, {224, 21},
+        {  0, 43}, { 25, 43}, { 50, 43}, { 75, 43}, {100, 43}, {124, 43}, {149, 43}, {174, 43}, {199, 43}, {224, 43},
+        {  0, 64}, { 25, 64}, { 50, 64}, { 75, 64}, {100, 64}, {124, 64}, {149, 64}, {174, 64}, {199, 64}, {224, 64}
+    }, {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+    }
+};
+// clang-format on
+
+static rgb_t leds[RGB_MATRIX_LED_COUNT];
+static rgb_t culled[RGB_MATRIX_LED_COUNT];
+static rgb_t unculled[RGB_MATRIX_LED_COUNT];
+
+static void fake_init(void) {}
+
+static void fake_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+    leds[index] = (rgb_t){r, g, b};
+}
+
+static void fake_set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        fake_set_color(i, r, g, b);
+    }
+}
+
+static void fake_flush(void) {}
+
+extern "C" const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = fake_init,
+    .set_color     = fake_set_color,
+    .set_color_all = fake_set_color_all,
+    .flush         = fake_flush,
+};
+
+/* With full saturation, the brightest channel only depends on the value, not on the hue */
+static uint8_t brightness(rgb_t rgb) {
+    return MAX(rgb.r, MAX(rgb.g, rgb.b));
+}
+
+extern "C" uint8_t reactive_splash_culling_mode = 0;
+
+static int passes;
+static int partly_lit_passes;
+static int mismatches;
+
+extern "C" void reactive_splash_culled_rendered(void) {
+    memcpy(culled, leds, sizeof(leds));
+}
+
+extern "C" void reactive_splash_unculled_rendered(void) {
+    memcpy(unculled, leds, sizeof(leds));
+}
+
+/* Compares the renderings of the pass just completed */
+extern "C" void reactive_splash_uncached_rendered(void) {
+    int lit = 0;
+    for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        if (brightness(culled[i]) != brightness(leds[i]) || brightness(unculled[i]) != brightness(leds[i])) {
+            mismatches++;
+        }
+        if (brightness(leds[i]) > 0) {
+            lit++;
+        }
+    }
+    passes++;
+    if (lit > 0 && lit < RGB_MATRIX_LED_COUNT) {
+        partly_lit_passes++;
+    }
+}
+
+class RgbMatrixReactiveSplash : public TestFixture {
+   public:
+    TestDriver             driver;
+    std::vector<KeymapKey> keys;
+
+    void SetUp() override {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keys.push_back(KeymapKey(0, col, row, KC_NO));
+                add_key(keys.back());
+            }
+        }
+        g_last_hit_tracker.count = 0;
+        passes                   = 0;
+        partly_lit_passes        = 0;
+        mismatches               = 0;
+    }
+
+    KeymapKey &key(uint8_t col, uint8_t row) {
+        return keys[row * MATRIX_COLS + col];
+    }
+
+    /* More hits than LED_HITS_TO_REMEMBER, some on the same key, each pressed before the previous ones faded. Every
+     * pass is rendered with and without culling, and each LED must be lit as brightly every way. */
+    void render_hits(uint8_t mode, uint8_t speed, uint16_t interval) {
+        static const uint8_t hits[][2] = {{0, 0}, {9, 3}, {4, 1}, {4, 1}, {2, 3}, {7, 0}, {0, 3}, {9, 0}, {5, 2}, {1, 1}, {4, 1}};
+
+        reactive_splash_culling_mode = mode;
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_CUSTOM_REACTIVE_SPLASH_CULLING);
+        rgb_matrix_sethsv_noeeprom(0, 255, 255);
+        rgb_matrix_set_speed_noeeprom(speed);
+
+        EXPECT_NO_REPORT(driver);
+        for (auto &hit : hits) {
+            key(hit[0], hit[1]).press();
+            idle_for(30);
+            key(hit[0], hit[1]).release();
+            idle_for(interval - 30);
+        }
+        // Until every hit faded
+        idle_for(3000);
+
+        EXPECT_GT(passes, 100);
+        EXPECT_GT(partly_lit_passes, 50);
+        EXPECT_EQ(mismatches, 0);
+    }
+};
+
+TEST_F(RgbMatrixReactiveSplash, splash_lights_leds_as_without_culling) {
+    render_hits(RGB_MATRIX_SPLASH, 128, 100);
+}
+
+TEST_F(RgbMatrixReactiveSplash, multisplash_lights_leds_as_without_culling) {
+    render_hits(RGB_MATRIX_MULTISPLASH, 255, 250);
+}
+
+TEST_F(RgbMatrixReactiveSplash, frequent_multisplash_lights_leds_as_without_culling) {
+    render_hits(RGB_MATRIX_MULTISPLASH, 255, 100);
+}
+
+TEST_F(RgbMatrixReactiveSplash, multiwide_lights_leds_as_without_culling) {
+    render_hits(RGB_MATRIX_SOLID_REACTIVE_MULTIWIDE, 128, 100);
+}
+
+TEST_F(RgbMatrixReactiveSplash, multicross_lights_leds_as_without_culling) {
+    render_hits(RGB_MATRIX_SOLID_REACTIVE_MULTICROSS, 128, 100);
+}
+
+TEST_F(RgbMatrixReactiveSplash, multinexus_lights_leds_as_without_culling) {
+    render_hits(RGB_MATRIX_SOLID_REACTIVE_MULTINEXUS, 128, 100);
+}
+
+TEST_F(RgbMatrixReactiveSplash, slow_multinexus_lights_leds_as_without_culling) {
+    render_hits(RGB_MATRIX_SOLID_REACTIVE_MULTINEXUS, 16, 100);
+}
@@ -0,0 +1,216 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "test_logger.hpp"
+
+extern "C" {
+#include "timer.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+struct TypedKey {
+    uint8_t keycode;
+    uint8_t mods;
+
+    bool operator==(const TypedKey &other) const {
+        return keycode == other.keycode && mods == other.mods;
+    }
+};
+
+std::ostream &operator<<(std::ostream &stream, const TypedKey &value) {
+    return stream << "{" << +value.keycode << ", mods " << +value.mods << "}";
+}
+
+/* What the host sees typed: each key newly pressed in a report, in report order, with the modifiers held */
+struct Host {
+    std::vector<TypedKey> typed;
+    size_t                reports = 0;
+
+    void listen(TestDriver &driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(testing::Invoke([this](const report_keyboard_t &report) {
+            for (size_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+                if (report.keys[i] && std::find(m_held.begin(), m_held.end(), report.keys[i]) == m_held.end()) {
+                    typed.push_back({report.keys[i], report.mods});
+                }
+            }
+            m_held.assign(report.keys, report.keys + KEYBOARD_REPORT_KEYS);
+            reports++;
+        }));
+    }
+
+   private:
+    std::vector<uint8_t> m_held;
+};
+
+/* '^' is a dead key in this test, as it is on many non-US layouts */
+extern "C" const uint8_t ascii_to_dead_lut[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 << ('^' % 8), 0, 0, 0, 0};
+
+static const char *const pangram = "The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs!\n";
+
+class SendStringAsync : public TestFixture {
+   public:
+    /* Runs the keyboard until the queued string is typed, returning how long it took */
+    uint16_t drain() {
+        const uint16_t start = timer_read();
+        while (send_string_async_pending()) {
+            run_one_scan_loop();
+        }
+        return TIMER_DIFF_16(timer_read(), start);
+    }
+};
+
+TEST_F(SendStringAsync, returns_immediately) {
+    TestDriver driver;
+
+    EXPECT_NO_REPORT(driver);
+    EXPECT_TRUE(send_string_async("abc"));
+    EXPECT_TRUE(send_string_async_pending());
+    VERIFY_AND_CLEAR(driver);
+
+    InSequence s;
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    drain();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringAsync, splits_on_repeated_keys_and_modifier_changes) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_H, KC_E, KC_L));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_L, KC_O));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_W));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_O, KC_R, KC_L, KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_TRUE(send_string_async("helloWorld"));
+    drain();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringAsync, report_holds_at_most_six_keys) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D, KC_E, KC_F));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_G));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_TRUE(send_string_async("abcdefg"));
+    drain();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringAsync, keycodes_and_delays_do_not_block) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_TRUE(send_string_async("a" SS_DELAY(100) SS_TAP(X_ENTER) "b"));
+    run_one_scan_loop();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* The delay is spent scanning rather than waiting */
+    EXPECT_NO_REPORT(driver);
+    idle_for(50);
+    EXPECT_TRUE(send_string_async_pending());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_ENTER));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(50);
+    drain();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringAsync, dead_key_space_is_pressed_alone) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_6));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_SPACE));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_TRUE(send_string_async("^ab"));
+    drain();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringAsync, keys_held_by_the_user_stay_held) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    KeymapKey  key_enter(0, 1, 0, KC_ENTER);
+    set_keymap({key_a, key_enter});
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    EXPECT_REPORT(driver, (KC_A, KC_ENTER));
+    key_enter.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A, KC_ENTER, KC_B, KC_C));
+    EXPECT_REPORT(driver, (KC_A, KC_ENTER));
+    EXPECT_TRUE(send_string_async("abc" SS_TAP(X_ENTER)));
+    drain();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_ENTER));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    key_enter.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringAsync, full_queue_rejects_string) {
+    TestDriver driver;
+    std::string too_long(SENDSTRING_ASYNC_BUFFER_SIZE, 'a');
+
+    EXPECT_NO_REPORT(driver);
+    EXPECT_FALSE(send_string_async(too_long.c_str()));
+    EXPECT_FALSE(send_string_async_pending());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringAsync, types_same_text_as_send_string_faster) {
+    TestDriver driver;
+    Host       blocking, batched;
+
+    blocking.listen(driver);
+    const uint16_t start = timer_read();
+    send_string(pangram);
+    const uint16_t blocking_time = TIMER_DIFF_16(timer_read(), start);
+    VERIFY_AND_CLEAR(driver);
+
+    batched.listen(driver);
+    EXPECT_TRUE(send_string_async(pangram));
+    const uint16_t batched_time = drain();
+    VERIFY_AND_CLEAR(driver);
+
+    test_logger.info() << blocking.reports << " reports in " << blocking_time << "ms blocking, " << batched.reports << " reports in " << batched_time << "ms batched" << std::endl;
+    EXPECT_EQ(batched.typed, blocking.typed);
+    EXPECT_LT(batched.reports * 2, blocking.reports);
+}
@@ -0,0 +1,336 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "test_logger.hpp"
+
+extern "C" {
+#include "timer.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class SpeculativeHoldTap : public TestFixture {
+   public:
+    void SetUp() override {
+        speculative_hold_tap_enable(true);
+        speculative_hold_tap_clear_history();
+    }
+};
+
+TEST_F(SpeculativeHoldTap, roll_from_mod_tap_key_sends_tap_immediately) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key      = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({mod_tap_hold_key, regular_key});
+
+    /* Press mod-tap-hold key */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    idle_for(20);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Press regular key, the tap is predicted */
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_REPORT(driver, (KC_P, KC_A));
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release mod-tap-hold key within the tapping term, confirming the tap */
+    EXPECT_REPORT(driver, (KC_A));
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release regular key */
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SpeculativeHoldTap, hold_past_tapping_term_retracts_tap) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key      = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({mod_tap_hold_key, regular_key});
+
+    /* Press mod-tap-hold key, and tap regular key shortly after */
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_REPORT(driver, (KC_P, KC_A));
+    EXPECT_REPORT(driver, (KC_P));
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    idle_for(20);
+    tap_key(regular_key);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Exceed the tapping term, the typed characters are erased and replayed shifted */
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_BACKSPACE));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_BACKSPACE));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_A));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release mod-tap-hold key */
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SpeculativeHoldTap, retracts_keys_still_held) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key      = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({mod_tap_hold_key, regular_key});
+
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_REPORT(driver, (KC_P, KC_A));
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    idle_for(20);
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Both keys are released before erasing, and the regular key is pressed again with shift */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_BACKSPACE));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_BACKSPACE));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_A));
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SpeculativeHoldTap, key_pressed_before_is_not_released_again) {
+    TestDriver driver;
+    InSequence s;
+    auto       shift_key        = KeymapKey(0, 0, 0, KC_LEFT_SHIFT);
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key      = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({shift_key, mod_tap_hold_key, regular_key});
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    shift_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_P));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_P, KC_A));
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    idle_for(20);
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Released during the speculation, but pressed before it */
+    EXPECT_REPORT(driver, (KC_P, KC_A));
+    shift_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* The retraction doesn't release the shift key again, which would drop the shift of the hold */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_BACKSPACE));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_BACKSPACE));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_A));
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SpeculativeHoldTap, keys_held_before_stop_predicting_tap) {
+    TestDriver driver;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key      = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({mod_tap_hold_key, regular_key});
+
+    /* Hold the mod-tap-hold key on its own, twice */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(4);
+    for (int i = 0; i < 2; i++) {
+        mod_tap_hold_key.press();
+        idle_for(TAPPING_TERM + 1);
+        mod_tap_hold_key.release();
+        idle_for(TAPPING_TERM);
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    /* Rolling onto the regular key no longer sends anything early */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    idle_for(20);
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_REPORT(driver, (KC_P, KC_A));
+    EXPECT_REPORT(driver, (KC_A));
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SpeculativeHoldTap, non_typing_key_is_not_speculated) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       arrow_key        = KeymapKey(0, 2, 0, KC_LEFT);
+
+    set_keymap({mod_tap_hold_key, arrow_key});
+
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    idle_for(20);
+    arrow_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_LEFT));
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_EMPTY_REPORT(driver);
+    arrow_key.release();
+    run_one_scan_loop();
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SpeculativeHoldTap, disabled_buffers_roll) {
+    TestDriver driver;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key      = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({mod_tap_hold_key, regular_key});
+    speculative_hold_tap_enable(false);
+    EXPECT_FALSE(speculative_hold_tap_is_enabled());
+
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    idle_for(20);
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(4);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+/* Rolls over a mod-tap key, measuring how long after its press each key first appears in a report */
+static double average_added_latency(TestFixture &fixture, TestDriver &driver, KeymapKey &mod_tap_hold_key, KeymapKey &regular_key) {
+    const int rolls = 20;
+    uint32_t  total = 0;
+
+    for (int i = 0; i < rolls; i++) {
+        uint16_t mod_tap_pressed = 0, regular_pressed = 0;
+        int      mod_tap_latency = -1, regular_latency = -1;
+
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(testing::Invoke([&](const report_keyboard_t &report) {
+            const uint16_t now = timer_read();
+            for (size_t k = 0; k < KEYBOARD_REPORT_KEYS; k++) {
+                if (report.keys[k] == KC_P && mod_tap_latency < 0) mod_tap_latency = TIMER_DIFF_16(now, mod_tap_pressed);
+                if (report.keys[k] == KC_A && regular_latency < 0) regular_latency = TIMER_DIFF_16(now, regular_pressed);
+            }
+        }));
+
+        mod_tap_pressed = timer_read();
+        mod_tap_hold_key.press();
+        fixture.idle_for(15);
+        regular_pressed = timer_read();
+        regular_key.press();
+        fixture.idle_for(30);
+        mod_tap_hold_key.release();
+        fixture.idle_for(15);
+        regular_key.release();
+        fixture.idle_for(TAPPING_TERM);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        EXPECT_GE(mod_tap_latency, 0);
+        EXPECT_GE(regular_latency, 0);
+        total += mod_tap_latency + regular_latency;
+    }
+    return (double)total / (2 * rolls);
+}
+
+TEST_F(SpeculativeHoldTap, reduces_average_latency_of_rolls) {
+    TestDriver driver;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       regular_key      = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({mod_tap_hold_key, regular_key});
+
+    speculative_hold_tap_enable(false);
+    const double baseline = average_added_latency(*this, driver, mod_tap_hold_key, regular_key);
+    speculative_hold_tap_enable(true);
+    const double speculative = average_added_latency(*this, driver, mod_tap_hold_key, regular_key);
+
+    test_logger.info() << "average added latency: " << baseline << "ms buffered, " << speculative << "ms speculative" << std::endl;
+    EXPECT_LT(speculative, baseline);
+}
@@ -0,0 +1,153 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "timer.h"
+}
+
+using testing::_;
+
+struct TypedKey {
+    uint8_t keycode;
+    uint8_t mods;
+
+    bool operator==(const TypedKey &other) const {
+        return keycode == other.keycode && mods == other.mods;
+    }
+};
+
+std::ostream &operator<<(std::ostream &stream, const TypedKey &value) {
+    return stream << "{" << +value.keycode << ", mods " << +value.mods << "}";
+}
+
+class WaitingBuffer : public TestFixture {
+   public:
+    std::vector<TypedKey> typed;
+
+    /* Records every key newly pressed in a report, along with the modifiers held at the time */
+    void capture(TestDriver &driver) {
+        typed.clear();
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(testing::Invoke([this](const report_keyboard_t &report) {
+            for (size_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+                if (report.keys[i] && std::find(m_held.begin(), m_held.end(), report.keys[i]) == m_held.end()) {
+                    typed.push_back({report.keys[i], report.mods});
+                }
+            }
+            m_held.assign(report.keys, report.keys + KEYBOARD_REPORT_KEYS);
+        }));
+    }
+
+    std::vector<KeymapKey> letters(uint8_t count) {
+        std::vector<KeymapKey> keys;
+        for (uint8_t i = 0; i < count; i++) {
+            keys.emplace_back(0, (i + 1) % MATRIX_COLS, (i + 1) / MATRIX_COLS, KC_A + i);
+        }
+        return keys;
+    }
+
+   private:
+    std::vector<uint8_t> m_held;
+};
+
+TEST_F(WaitingBuffer, overlapping_keys_within_tapping_term_are_kept) {
+    TestDriver driver;
+    auto       mod_tap_key = KeymapKey(0, 0, 0, SFT_T(KC_1));
+    auto       keys        = letters(WAITING_BUFFER_SIZE / 2);
+    for (auto &key : keys) {
+        add_key(key);
+    }
+    add_key(mod_tap_key);
+
+    capture(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    for (auto &key : keys) {
+        key.press();
+        run_one_scan_loop();
+        key.release();
+        run_one_scan_loop();
+    }
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Released within the tapping term, so the mod-tap key is a tap followed by every key, unshifted */
+    std::vector<TypedKey> expected = {{KC_1, 0}};
+    for (auto &key : keys) {
+        expected.push_back({static_cast<uint8_t>(key.code), 0});
+    }
+    EXPECT_EQ(typed, expected);
+}
+
+TEST_F(WaitingBuffer, overflow_settles_tapping_key_as_hold_without_losing_events) {
+    TestDriver driver;
+    auto       mod_tap_key = KeymapKey(0, 0, 0, SFT_T(KC_1));
+    auto       keys        = letters(24);
+    for (auto &key : keys) {
+        add_key(key);
+    }
+    add_key(mod_tap_key);
+
+    /* 48 events within the tapping term don't fit in the buffer */
+    capture(driver);
+    const uint16_t start = timer_read();
+    mod_tap_key.press();
+    run_one_scan_loop();
+    for (auto &key : keys) {
+        key.press();
+        run_one_scan_loop();
+        key.release();
+        run_one_scan_loop();
+    }
+    ASSERT_LT(TIMER_DIFF_16(timer_read(), start), TAPPING_TERM);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    std::vector<TypedKey> expected;
+    for (auto &key : keys) {
+        expected.push_back({static_cast<uint8_t>(key.code), MOD_BIT(KC_LEFT_SHIFT)});
+    }
+    EXPECT_EQ(typed, expected);
+}
+
+TEST_F(WaitingBuffer, fast_roll_over_many_mod_tap_keys) {
+    TestDriver             driver;
+    std::vector<KeymapKey> keys;
+    for (uint8_t i = 0; i < 24; i++) {
+        keys.emplace_back(0, i % MATRIX_COLS, i / MATRIX_COLS, (i % 2 ? LCTL_T(KC_A + i) : LSFT_T(KC_A + i)));
+    }
+    for (auto &key : keys) {
+        add_key(key);
+    }
+
+    /* Each key is released two presses later, the whole roll taking less than one tapping term */
+    capture(driver);
+    for (size_t i = 0; i < keys.size() + 2; i++) {
+        if (i < keys.size()) {
+            keys[i].press();
+            run_one_scan_loop();
+        }
+        if (i >= 2) {
+            keys[i - 2].release();
+            run_one_scan_loop();
+        }
+    }
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    std::vector<TypedKey> expected;
+    for (uint8_t i = 0; i < keys.size(); i++) {
+        expected.push_back({static_cast<uint8_t>(KC_A + i), 0});
+    }
+    EXPECT_EQ(typed, expected);
+}
@@ -0,0 +1,201 @@
+/* Copyright 2024 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "task_scheduler.h"
+void advance_time(uint32_t ms);
+void set_time(uint32_t t);
+}
+
+static std::vector<std::string> calls;
+static uint32_t                 slow_task_ms = 0;
+
+static void critical_task(void) {
+    calls.push_back("critical");
+}
+
+static void slow_critical_task(void) {
+    calls.push_back("slow_critical");
+    advance_time(slow_task_ms);
+}
+
+static void normal_task(void) {
+    calls.push_back("normal");
+}
+
+static void slow_normal_task(void) {
+    calls.push_back("slow_normal");
+    advance_time(slow_task_ms);
+}
+
+static void cosmetic_task(void) {
+    calls.push_back("cosmetic");
+}
+
+class TaskScheduler : public TestFixture {
+   public:
+    void SetUp() override {
+        calls.clear();
+        slow_task_ms = 0;
+    }
+
+    template <size_t N>
+    void run_passes(const task_descriptor_t (&tasks)[N], task_state_t (&states)[N], int passes) {
+        for (int i = 0; i < passes; ++i) {
+            task_scheduler_run(tasks, states, N);
+            advance_time(1);
+        }
+    }
+
+    int count(const std::string &name) {
+        int n = 0;
+        for (auto &c : calls) {
+            n += (c == name);
+        }
+        return n;
+    }
+};
+
+TEST_F(TaskScheduler, RunsInRegistryOrder) {
+    const task_descriptor_t tasks[] = {
+        TASK_DESCRIPTOR(critical_task, TASK_PRIORITY_CRITICAL, 0, 0),
+        TASK_DESCRIPTOR(cosmetic_task, TASK_PRIORITY_COSMETIC, 0, 0),
+        TASK_DESCRIPTOR(normal_task, TASK_PRIORITY_NORMAL, 0, 0),
+    };
+    task_state_t states[3] = {};
+
+    run_passes(tasks, states, 2);
+    EXPECT_EQ(calls, (std::vector<std::string>{"critical", "cosmetic", "normal", "critical", "cosmetic", "normal"}));
+}
+
+TEST_F(TaskScheduler, PeriodLimitsRate) {
+    const task_descriptor_t tasks[] = {
+        TASK_DESCRIPTOR(critical_task, TASK_PRIORITY_CRITICAL, 0, 0),
+        TASK_DESCRIPTOR(cosmetic_task, TASK_PRIORITY_COSMETIC, 10, 0),
+    };
+    task_state_t states[2] = {};
+
+    run_passes(tasks, states, 35);
+    EXPECT_EQ(count("critical"), 35);
+    EXPECT_EQ(count("cosmetic"), 4);
+    EXPECT_EQ(states[1].stats.runs, 4);
+}
+
+TEST_F(TaskScheduler, CosmeticDeferredWhenLoopRunsLong) {
+    const task_descriptor_t tasks[] = {
+        TASK_DESCRIPTOR(slow_critical_task, TASK_PRIORITY_CRITICAL, 0, 0),
+        TASK_DESCRIPTOR(normal_task, TASK_PRIORITY_NORMAL, 0, 0),
+        TASK_DESCRIPTOR(cosmetic_task, TASK_PRIORITY_COSMETIC, 0, 0),
+    };
+    task_state_t states[3] = {};
+
+    // Exceeds TASK_SCHEDULER_LOOP_BUDGET_US, so cosmetic work waits -- but not indefinitely
+    slow_task_ms = 3;
+    run_passes(tasks, states, 4);
+    EXPECT_EQ(count("slow_critical"), 4);
+    EXPECT_EQ(count("normal"), 4);
+    EXPECT_EQ(count("cosmetic"), 1);
+    EXPECT_EQ(states[2].stats.deferrals, TASK_SCHEDULER_MAX_DEFERRALS);
+
+    // Within budget, cosmetic tasks run every pass again
+    calls.clear();
+    slow_task_ms = 0;
+    run_passes(tasks, states, 4);
+    EXPECT_EQ(count("cosmetic"), 4);
+}
+
+TEST_F(TaskScheduler, BudgetOverrunSkipsNextRun) {
+    const task_descriptor_t tasks[] = {
+        TASK_DESCRIPTOR(slow_critical_task, TASK_PRIORITY_CRITICAL, 0, 500),
+        TASK_DESCRIPTOR(slow_normal_task, TASK_PRIORITY_NORMAL, 0, 500),
+    };
+    task_state_t states[2] = {};
+
+    slow_task_ms = 1;
+    run_passes(tasks, states, 6);
+
+    // Critical tasks always run, the normal task runs every other pass
+    EXPECT_EQ(count("slow_critical"), 6);
+    EXPECT_EQ(count("slow_normal"), 3);
+    EXPECT_EQ(states[0].stats.overruns, 6);
+    EXPECT_EQ(states[1].stats.overruns, 3);
+    EXPECT_EQ(states[1].stats.deferrals, 3);
+}
+
+TEST_F(TaskScheduler, CollectsRuntimeStatistics) {
+    const task_descriptor_t tasks[] = {
+        TASK_DESCRIPTOR(slow_normal_task, TASK_PRIORITY_NORMAL, 0, 0),
+    };
+    task_state_t states[1] = {};
+
+    slow_task_ms = 1;
+    run_passes(tasks, states, 2);
+    slow_task_ms = 4;
+    run_passes(tasks, states, 1);
+
+    EXPECT_EQ(states[0].stats.runs, 3);
+    EXPECT_EQ(states[0].stats.total_us, 6000);
+    EXPECT_EQ(states[0].stats.max_us, 4000);
+    EXPECT_EQ(states[0].stats.overruns, 0);
+}
+
+TEST_F(TaskScheduler, RuntimeMeasuredAcrossTimerWrap) {
+    const task_descriptor_t tasks[] = {
+        TASK_DESCRIPTOR(slow_normal_task, TASK_PRIORITY_NORMAL, 0, 0),
+    };
+    task_state_t states[1] = {};
+
+    // The microsecond timestamp wraps part way through the task
+    set_time(UINT32_MAX / 1000 - 1);
+    slow_task_ms = 3;
+    run_passes(tasks, states, 1);
+
+    EXPECT_EQ(states[0].stats.total_us, 3000);
+    EXPECT_EQ(states[0].stats.max_us, 3000);
+}
+
+TEST_F(TaskScheduler, TotalRuntimeDoesNotOverflow) {
+    const task_descriptor_t tasks[] = {
+        TASK_DESCRIPTOR(slow_normal_task, TASK_PRIORITY_NORMAL, 0, 0),
+    };
+    task_state_t states[1] = {};
+
+    // Over 71 minutes of accumulated runtime
+    states[0].stats.total_us = UINT32_MAX;
+    slow_task_ms             = 1;
+    run_passes(tasks, states, 1);
+    EXPECT_EQ(states[0].stats.total_us, (uint64_t)UINT32_MAX + 1000);
+}
+
+TEST_F(TaskScheduler, KeyboardTaskStatistics) {
+    TestDriver driver;
+
+    keyboard_task_statistics_reset();
+    idle_for(5);
+
+    ASSERT_GE(keyboard_task_count(), 3);
+    EXPECT_STREQ(keyboard_task_name(0), "keyboard_matrix_task");
+    EXPECT_STREQ(keyboard_task_name(1), "quantum_task");
+    EXPECT_EQ(keyboard_task_name(keyboard_task_count()), nullptr);
+    for (uint8_t i = 0; i < keyboard_task_count(); ++i) {
+        EXPECT_EQ(keyboard_task_statistics(i)->runs, 5) << keyboard_task_name(i);
+    }
+}
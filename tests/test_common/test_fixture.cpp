@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include "gmock/gmock-cardinalities.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -12,6 +13,7 @@
 #include "test_driver.hpp"
 #include "test_logger.hpp"
 #include "test_matrix.h"
+#include "test_polling_host.hpp"
 #include "test_keymap_key.hpp"
 #include "timer.h"
 
@@ -30,6 +32,52 @@ void advance_time(uint32_t ms);
 
 using testing::_;
 
+/* Fast-forwarding skips keyboard task passes which cannot change anything, jumping straight to the next deadline
+ * reported by keyboard_next_deadline(). It is only enabled when build_full_test.mk knows every enabled feature to be
+ * safe, and not for configurations which poll timers or count passes -- nor for test suites defining
+ * TEST_NO_FAST_FORWARD. */
+#if defined(TEST_FAST_FORWARD_FEATURES_KNOWN) && !defined(TEST_NO_FAST_FORWARD) && !defined(TASK_SCHEDULER_STATISTICS)
+#    if !(defined(ONESHOT_TIMEOUT) && ONESHOT_TIMEOUT > 0) && !(defined(RGB_MATRIX_TIMEOUT) && RGB_MATRIX_TIMEOUT > 0) && !(defined(LED_MATRIX_TIMEOUT) && LED_MATRIX_TIMEOUT > 0)
+#        define TEST_FAST_FORWARD
+#    endif
+#endif
+
+#ifdef TEST_FAST_FORWARD
+namespace {
+
+/* The state a keyboard task pass can observably change. */
+struct KeyboardSnapshot {
+    layer_state_t     layers;
+    layer_state_t     default_layers;
+    uint8_t           mods;
+    uint8_t           weak_mods;
+    uint8_t           oneshot_mods;
+    uint32_t          last_input_activity;
+    report_keyboard_t report;
+
+    KeyboardSnapshot() : layers(layer_state), default_layers(default_layer_state), mods(get_mods()), weak_mods(get_weak_mods()), oneshot_mods(get_oneshot_mods()), last_input_activity(last_input_activity_time()), report(*keyboard_report) {}
+
+    bool operator==(const KeyboardSnapshot& other) const {
+        return layers == other.layers && default_layers == other.default_layers && mods == other.mods && weak_mods == other.weak_mods && oneshot_mods == other.oneshot_mods && last_input_activity == other.last_input_activity && memcmp(&report, &other.report, sizeof(report)) == 0;
+    }
+};
+
+/* Number of upcoming passes which can be skipped, given that the pass just run changed nothing. */
+unsigned idle_passes(unsigned remaining) {
+    uint32_t deadline;
+    if (!keyboard_next_deadline(&deadline)) {
+        return remaining;
+    }
+    uint32_t now = timer_read32();
+    if (timer_expired32(now, deadline)) {
+        return 0;
+    }
+    return std::min<uint32_t>(deadline - now, remaining);
+}
+
+} // namespace
+#endif
+
 /* This is used for dynamic dispatching keymap_key_to_keycode calls to the current active test_fixture. */
 TestFixture* TestFixture::m_this = nullptr;
 
@@ -179,9 +227,20 @@ void TestFixture::run_one_scan_loop() {
 void TestFixture::idle_for(unsigned time) {
     test_logger.trace() << +time << " keyboard task " << (time > 1 ? "loops" : "loop") << std::endl;
     for (unsigned i = 0; i < time; i++) {
+#ifdef TEST_FAST_FORWARD
+        KeyboardSnapshot before;
+#endif
         keyboard_task();
         housekeeping_task();
         advance_time(1);
+        TestPollingHost::frame();
+#ifdef TEST_FAST_FORWARD
+        if (before == KeyboardSnapshot() && !TestPollingHost::pending()) {
+            unsigned skip = idle_passes(time - i - 1);
+            advance_time(skip);
+            i += skip;
+        }
+#endif
     }
 }
 
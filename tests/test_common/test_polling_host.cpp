@@ -0,0 +1,88 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_polling_host.hpp"
+
+extern "C" {
+#include "host.h"
+#include "timer.h"
+#ifdef REPORT_LATENCY_ENABLE
+#    include "report_latency.h"
+#endif
+}
+
+TestPollingHost* TestPollingHost::m_this = nullptr;
+
+TestPollingHost::TestPollingHost(uint32_t interval_ms) : m_driver{&TestPollingHost::keyboard_leds, &TestPollingHost::send_keyboard, &TestPollingHost::send_nkro, &TestPollingHost::send_mouse, &TestPollingHost::send_extra}, m_target(host_get_driver()), m_interval(interval_ms ? interval_ms : 1) {
+    host_set_driver(&m_driver);
+    m_this = this;
+}
+
+TestPollingHost::~TestPollingHost() {
+    host_set_driver(m_target);
+    m_this = nullptr;
+}
+
+void TestPollingHost::frame() {
+    if (m_this != nullptr) {
+        uint32_t now = timer_read32();
+        if (now % m_this->m_interval == 0) {
+            m_this->poll(now);
+        }
+    }
+}
+
+bool TestPollingHost::pending() {
+    if (m_this == nullptr) {
+        return false;
+    }
+    for (auto& queue : m_this->m_queues) {
+        if (!queue.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TestPollingHost::enqueue(Endpoint endpoint, std::function<void()> deliver) {
+    m_queues[endpoint].push_back({timer_read32(), std::move(deliver)});
+}
+
+void TestPollingHost::poll(uint32_t now) {
+    for (uint8_t endpoint = 0; endpoint < ENDPOINT_COUNT; endpoint++) {
+        auto& queue = m_queues[endpoint];
+        if (queue.empty()) {
+            continue;
+        }
+        QueuedReport report = std::move(queue.front());
+        queue.pop_front();
+#ifdef REPORT_LATENCY_ENABLE
+        report_latency_record(endpoint, (now - report.time) * 1000);
+#endif
+        report.deliver();
+    }
+}
+
+uint8_t TestPollingHost::keyboard_leds(void) {
+    return m_this->m_target->keyboard_leds();
+}
+
+void TestPollingHost::send_keyboard(report_keyboard_t* report) {
+    report_keyboard_t copy = *report;
+    m_this->enqueue(KEYBOARD_ENDPOINT, [copy]() mutable { m_this->m_target->send_keyboard(&copy); });
+}
+
+void TestPollingHost::send_nkro(report_nkro_t* report) {
+    report_nkro_t copy = *report;
+    m_this->enqueue(SHARED_ENDPOINT, [copy]() mutable { m_this->m_target->send_nkro(&copy); });
+}
+
+void TestPollingHost::send_mouse(report_mouse_t* report) {
+    report_mouse_t copy = *report;
+    m_this->enqueue(MOUSE_ENDPOINT, [copy]() mutable { m_this->m_target->send_mouse(&copy); });
+}
+
+void TestPollingHost::send_extra(report_extra_t* report) {
+    report_extra_t copy = *report;
+    m_this->enqueue(SHARED_ENDPOINT, [copy]() mutable { m_this->m_target->send_extra(&copy); });
+}
@@ -0,0 +1,82 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include "host_driver.h"
+
+/**
+ * @brief Simulates a USB host polling the keyboard's endpoints, rather than reports reaching the TestDriver the
+ * moment they are sent.
+ *
+ * Reports are queued per endpoint. Every `interval_ms` of the test clock the host polls, handing the oldest queued
+ * report of each endpoint on to the TestDriver, so the usual report expectations still apply, just later. With
+ * REPORT_LATENCY_ENABLE, the time each report spent queued is recorded against its endpoint, like the USB driver of
+ * a real keyboard does.
+ *
+ *     TestDriver      driver;
+ *     TestPollingHost host(8);
+ *     tap_key(key_a);
+ *     idle_for(16);
+ *
+ * The host hands reports on to the host driver installed when it is created, so it has to be created after the
+ * TestDriver. The test fixture runs a frame after each keyboard task pass. Reports still queued when the host is
+ * destroyed are dropped.
+ */
+class TestPollingHost {
+   public:
+    /**
+     * @brief Endpoint numbers of the simulated host, NKRO and extra key reports sharing one endpoint.
+     */
+    enum Endpoint : uint8_t {
+        KEYBOARD_ENDPOINT = 1,
+        MOUSE_ENDPOINT    = 2,
+        SHARED_ENDPOINT   = 3,
+        ENDPOINT_COUNT,
+    };
+
+    explicit TestPollingHost(uint32_t interval_ms = 1);
+    ~TestPollingHost();
+
+    /**
+     * @brief Number of reports waiting to be polled on an endpoint.
+     */
+    size_t queued(Endpoint endpoint) const {
+        return m_queues[endpoint].size();
+    }
+
+    /**
+     * @brief Polls the endpoints if a polling interval has elapsed on the test clock.
+     */
+    static void frame();
+
+    /**
+     * @brief Whether the active host, if any, has reports waiting to be polled.
+     */
+    static bool pending();
+
+   private:
+    struct QueuedReport {
+        uint32_t              time;
+        std::function<void()> deliver;
+    };
+
+    static uint8_t keyboard_leds(void);
+    static void    send_keyboard(report_keyboard_t* report);
+    static void    send_nkro(report_nkro_t* report);
+    static void    send_mouse(report_mouse_t* report);
+    static void    send_extra(report_extra_t* report);
+
+    void enqueue(Endpoint endpoint, std::function<void()> deliver);
+    void poll(uint32_t now);
+
+    host_driver_t            m_driver;
+    host_driver_t*           m_target;
+    uint32_t                 m_interval;
+    std::deque<QueuedReport> m_queues[ENDPOINT_COUNT];
+    static TestPollingHost*  m_this;
+};
@@ -0,0 +1,146 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_trace_replay.hpp"
+#include <iomanip>
+#include <sstream>
+#include "gmock/gmock.h"
+#include "test_logger.hpp"
+#include "test_matrix.h"
+
+extern "C" {
+#include "action_layer.h"
+#include "event_trace.h"
+#include "timer.h"
+}
+
+using testing::_;
+
+namespace {
+
+std::vector<uint8_t> encode_layer_state(uint32_t state) {
+    return {static_cast<uint8_t>(state), static_cast<uint8_t>(state >> 8), static_cast<uint8_t>(state >> 16), static_cast<uint8_t>(state >> 24)};
+}
+
+std::vector<uint8_t> encode_report(const report_keyboard_t& report) {
+    std::vector<uint8_t> result = {report.mods};
+    for (size_t i = 0; i < KEYBOARD_REPORT_KEYS && result.size() < EVENT_TRACE_MAX_PAYLOAD; i++) {
+        if (report.keys[i]) {
+            result.emplace_back(report.keys[i]);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+std::ostream& operator<<(std::ostream& stream, const TraceOutput& value) {
+    stream << "@" << value.time << "ms [" << std::hex << std::setfill('0');
+    for (size_t i = 0; i < value.data.size(); i++) {
+        stream << (i ? " " : "") << std::setw(2) << +value.data[i];
+    }
+    return stream << "]" << std::dec;
+}
+
+TraceReplay::TraceReplay(const std::vector<uint8_t>& trace) {
+    parse(trace);
+}
+
+TraceReplay::TraceReplay(const std::string& hex) {
+    std::vector<uint8_t> trace;
+    std::istringstream   stream(hex);
+    unsigned             value;
+    while (stream >> std::hex >> value) {
+        trace.emplace_back(value);
+    }
+    parse(trace);
+}
+
+void TraceReplay::parse(const std::vector<uint8_t>& trace) {
+    uint32_t time = 0;
+    size_t   pos  = 0;
+    while (pos + EVENT_TRACE_HEADER_SIZE <= trace.size()) {
+        uint8_t type   = EVENT_TRACE_RECORD_TYPE(trace[pos]);
+        uint8_t length = EVENT_TRACE_RECORD_PAYLOAD(trace[pos]);
+        if (pos + EVENT_TRACE_HEADER_SIZE + length > trace.size()) {
+            ADD_FAILURE() << "truncated trace record at offset " << pos;
+            break;
+        }
+        // The elapsed time of the oldest record refers to a record which is no longer part of the trace
+        if (pos > 0) {
+            time += trace[pos + 1] | trace[pos + 2] << 8;
+        }
+
+        const uint8_t*       payload = &trace[pos + EVENT_TRACE_HEADER_SIZE];
+        std::vector<uint8_t> data(payload, payload + length);
+        switch (type) {
+            case EVENT_TRACE_KEY:
+                EXPECT_EQ(length, 2) << "malformed key record at offset " << pos;
+                if (length == 2) {
+                    m_key_events.push_back({time, payload[0], static_cast<uint8_t>(payload[1] & ~EVENT_TRACE_KEY_PRESSED), (payload[1] & EVENT_TRACE_KEY_PRESSED) != 0});
+                }
+                break;
+            case EVENT_TRACE_LAYER:
+                m_layer_records.push_back({time, data});
+                break;
+            case EVENT_TRACE_REPORT:
+                m_expected_reports.push_back({time, data});
+                break;
+            default:
+                ADD_FAILURE() << "unknown trace record type " << +type << " at offset " << pos;
+                break;
+        }
+        pos += EVENT_TRACE_HEADER_SIZE + length;
+    }
+    m_duration = time;
+}
+
+uint32_t TraceReplay::duration() const {
+    return m_duration;
+}
+
+void TraceReplay::run(TestFixture& fixture, TestDriver& driver, unsigned settle_ms) {
+    const uint32_t start = timer_read32();
+    uint32_t       layer = layer_state;
+
+    test_logger.info() << "replaying " << m_key_events.size() << " key events over " << m_duration << "ms" << std::endl;
+
+    // Several layer changes within a single scan are only observable as the final state
+    m_expected_layers.clear();
+    uint32_t expected_layer = layer;
+    for (size_t i = 0; i < m_layer_records.size(); i++) {
+        if (i + 1 < m_layer_records.size() && m_layer_records[i + 1].time == m_layer_records[i].time) {
+            continue;
+        }
+        if (m_layer_records[i].data != encode_layer_state(expected_layer)) {
+            m_expected_layers.push_back(m_layer_records[i]);
+            const std::vector<uint8_t>& data = m_layer_records[i].data;
+            expected_layer                   = data[0] | data[1] << 8 | data[2] << 16 | static_cast<uint32_t>(data[3]) << 24;
+        }
+    }
+
+    m_actual_reports.clear();
+    m_actual_layers.clear();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(testing::Invoke([&](report_keyboard_t& report) {
+        m_actual_reports.push_back({TIMER_DIFF_32(timer_read32(), start), encode_report(report)});
+    }));
+
+    size_t next = 0;
+    for (uint32_t time = 0; time <= m_duration + settle_ms; time++) {
+        for (; next < m_key_events.size() && m_key_events[next].time == time; next++) {
+            const KeyEvent& event = m_key_events[next];
+            if (event.pressed) {
+                press_key(event.col, event.row);
+            } else {
+                release_key(event.col, event.row);
+            }
+        }
+        fixture.run_one_scan_loop();
+        if (layer_state != layer) {
+            layer = layer_state;
+            m_actual_layers.push_back({time, encode_layer_state(layer)});
+        }
+    }
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
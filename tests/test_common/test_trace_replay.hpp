@@ -0,0 +1,85 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+
+/**
+ * @brief A keyboard report or layer state seen at a point in time, relative to the start of a trace.
+ */
+struct TraceOutput {
+    uint32_t             time;
+    std::vector<uint8_t> data;
+
+    bool operator==(const TraceOutput& other) const {
+        return time == other.time && data == other.data;
+    }
+};
+
+std::ostream& operator<<(std::ostream& stream, const TraceOutput& value);
+
+/**
+ * @brief Replays an event trace recorded with EVENT_TRACE_ENABLE into the keymap of a TestFixture.
+ *
+ * The recorded key events are fed into the test matrix at their recorded times, and the keyboard reports and layer
+ * changes produced are captured, so they can be compared against the recorded ones:
+ *
+ *     TraceReplay replay("13 00 00 00 81 ...");
+ *     replay.run(*this, driver);
+ *     EXPECT_EQ(replay.actual_reports(), replay.expected_reports());
+ *     EXPECT_EQ(replay.actual_layers(), replay.expected_layers());
+ */
+class TraceReplay {
+   public:
+    explicit TraceReplay(const std::vector<uint8_t>& trace);
+    /**
+     * @brief Parses a trace from hex bytes separated by whitespace, as printed by a dump.
+     */
+    explicit TraceReplay(const std::string& hex);
+
+    /**
+     * @brief Replays the trace, then keeps scanning for `settle_ms` after the last record.
+     */
+    void run(TestFixture& fixture, TestDriver& driver, unsigned settle_ms = 0);
+
+    const std::vector<TraceOutput>& expected_reports() const {
+        return m_expected_reports;
+    }
+    const std::vector<TraceOutput>& expected_layers() const {
+        return m_expected_layers;
+    }
+    const std::vector<TraceOutput>& actual_reports() const {
+        return m_actual_reports;
+    }
+    const std::vector<TraceOutput>& actual_layers() const {
+        return m_actual_layers;
+    }
+    /**
+     * @brief Time of the last record, relative to the first.
+     */
+    uint32_t duration() const;
+
+   private:
+    struct KeyEvent {
+        uint32_t time;
+        uint8_t  row;
+        uint8_t  col;
+        bool     pressed;
+    };
+
+    void parse(const std::vector<uint8_t>& trace);
+
+    std::vector<KeyEvent>    m_key_events;
+    std::vector<TraceOutput> m_layer_records;
+    std::vector<TraceOutput> m_expected_reports;
+    std::vector<TraceOutput> m_expected_layers;
+    std::vector<TraceOutput> m_actual_reports;
+    std::vector<TraceOutput> m_actual_layers;
+    uint32_t                 m_duration = 0;
+};
@@ -0,0 +1,13 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define TAPPING_TERM 200
+#define COMBO_TERM 40
+#define LEADER_TIMEOUT 300
+#define TICKLESS_IDLE_MAX_SLEEP_MS 1000
+#define TICKLESS_IDLE_MATRIX_WAKE_MAX_SLEEP_MS 5000
+#define TICKLESS_IDLE_ACTIVITY_TIMEOUT 50
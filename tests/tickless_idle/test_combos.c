@@ -0,0 +1,10 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+uint16_t const ab_combo[] = {KC_A, KC_B, COMBO_END};
+
+combo_t key_combos[] = {
+    COMBO(ab_combo, KC_C),
+};
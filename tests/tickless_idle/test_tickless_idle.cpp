@@ -0,0 +1,268 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "tickless_idle.h"
+#include "deferred_exec.h"
+
+extern uint32_t tickless_idle_wait_count;
+extern uint32_t tickless_idle_last_timeout;
+extern uint32_t tickless_idle_wake_count;
+
+static bool     matrix_can_arm      = false;
+static uint32_t matrix_arm_count    = 0;
+static uint32_t matrix_disarm_count = 0;
+
+bool tickless_idle_matrix_arm(void) {
+    if (!matrix_can_arm) {
+        return false;
+    }
+    matrix_arm_count++;
+    return true;
+}
+
+void tickless_idle_matrix_disarm(void) {
+    matrix_disarm_count++;
+}
+}
+
+using testing::_;
+
+static uint32_t noop_callback(uint32_t trigger_time, void *cb_arg) {
+    return 0;
+}
+
+class TicklessIdle : public TestFixture {
+   public:
+    void SetUp() override {
+        tickless_idle_wait_count   = 0;
+        tickless_idle_last_timeout = 0;
+        tickless_idle_wake_count   = 0;
+        matrix_can_arm             = false;
+        matrix_arm_count           = 0;
+        matrix_disarm_count        = 0;
+    }
+
+    uint32_t next_deadline(void) {
+        uint32_t deadline = 0;
+        EXPECT_TRUE(tickless_idle_next_deadline(&deadline));
+        return deadline;
+    }
+};
+
+TEST_F(TicklessIdle, SleepsForMaximumWhenNothingIsPending) {
+    TestDriver driver;
+    uint32_t   deadline;
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    EXPECT_FALSE(tickless_idle_next_deadline(&deadline));
+    EXPECT_EQ(tickless_idle_timeout(), TICKLESS_IDLE_MAX_SLEEP_MS);
+
+    tickless_idle_task();
+    EXPECT_EQ(tickless_idle_wait_count, 1);
+    EXPECT_EQ(tickless_idle_last_timeout, TICKLESS_IDLE_MAX_SLEEP_MS);
+}
+
+TEST_F(TicklessIdle, StaysAwakeAfterInputActivity) {
+    TestDriver driver;
+    KeymapKey  key_p(0, 0, 0, KC_P);
+    set_keymap({key_p});
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    EXPECT_REPORT(driver, (KC_P));
+    key_p.press();
+    run_one_scan_loop();
+    EXPECT_EQ(tickless_idle_timeout(), 0);
+
+    tickless_idle_task();
+    EXPECT_EQ(tickless_idle_wait_count, 0);
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    EXPECT_EQ(tickless_idle_timeout(), TICKLESS_IDLE_MAX_SLEEP_MS);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_p.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TicklessIdle, StaysAwakeAfterWakeup) {
+    TestDriver driver;
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    tickless_idle_wake();
+    EXPECT_EQ(tickless_idle_wake_count, 1);
+    EXPECT_EQ(tickless_idle_timeout(), 0);
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    EXPECT_EQ(tickless_idle_timeout(), TICKLESS_IDLE_MAX_SLEEP_MS);
+}
+
+TEST_F(TicklessIdle, WaitsUntilTappingTermExpires) {
+    TestDriver driver;
+    KeymapKey  mod_tap_key(0, 0, 0, LSFT_T(KC_P));
+    set_keymap({mod_tap_key});
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    uint32_t pressed_at = timer_read32();
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    EXPECT_EQ(next_deadline(), pressed_at + TAPPING_TERM);
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    EXPECT_EQ(tickless_idle_timeout(), pressed_at + TAPPING_TERM - timer_read32());
+    VERIFY_AND_CLEAR(driver);
+
+    // Once resolved as a hold, nothing is left to time out
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    idle_for(TAPPING_TERM);
+    uint32_t deadline;
+    EXPECT_FALSE(tickless_idle_next_deadline(&deadline));
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TicklessIdle, WaitsUntilComboTermExpires) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    KeymapKey  key_b(0, 1, 0, KC_B);
+    set_keymap({key_a, key_b});
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    uint32_t pressed_at = timer_read32();
+    EXPECT_NO_REPORT(driver);
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    uint32_t deadline = next_deadline();
+    EXPECT_GT(deadline, pressed_at);
+    EXPECT_LE(deadline, pressed_at + COMBO_TERM + 1);
+
+    // The buffered key is released once the combo term has passed
+    EXPECT_REPORT(driver, (KC_A));
+    idle_for(COMBO_TERM + 1);
+    EXPECT_FALSE(tickless_idle_next_deadline(&deadline));
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TicklessIdle, WaitsUntilLeaderTimeout) {
+    TestDriver driver;
+    KeymapKey  key_leader(0, 0, 0, QK_LEADER);
+    set_keymap({key_leader});
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    uint32_t started_at = timer_read32();
+    tap_key(key_leader);
+    EXPECT_EQ(next_deadline(), started_at + LEADER_TIMEOUT + 1);
+
+    idle_for(LEADER_TIMEOUT + 1);
+    uint32_t deadline;
+    EXPECT_FALSE(tickless_idle_next_deadline(&deadline));
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TicklessIdle, WaitsUntilDeferredExecution) {
+    TestDriver driver;
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    deferred_token token = defer_exec(500, noop_callback, NULL);
+    ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+    EXPECT_EQ(next_deadline(), timer_read32() + 500);
+    EXPECT_EQ(tickless_idle_timeout(), 500);
+
+    tickless_idle_task();
+    EXPECT_EQ(tickless_idle_last_timeout, 500);
+    EXPECT_TRUE(cancel_deferred_exec(token));
+}
+
+TEST_F(TicklessIdle, SoonestDeadlineWins) {
+    TestDriver driver;
+    KeymapKey  mod_tap_key(0, 0, 0, LSFT_T(KC_P));
+    set_keymap({mod_tap_key});
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    deferred_token token = defer_exec(500, noop_callback, NULL);
+    ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+
+    uint32_t pressed_at = timer_read32();
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    EXPECT_EQ(next_deadline(), pressed_at + TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // With the tap resolved, the deferred execution is the soonest deadline again
+    idle_for(TAPPING_TERM);
+    EXPECT_EQ(next_deadline(), pressed_at + 500);
+    EXPECT_TRUE(cancel_deferred_exec(token));
+}
+
+TEST_F(TicklessIdle, SleepsLongerWhileMatrixIsArmed) {
+    TestDriver driver;
+
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    matrix_can_arm = true;
+    tickless_idle_task();
+    EXPECT_EQ(matrix_arm_count, 1);
+    EXPECT_EQ(matrix_disarm_count, 1);
+    EXPECT_EQ(tickless_idle_last_timeout, TICKLESS_IDLE_MATRIX_WAKE_MAX_SLEEP_MS);
+
+    // Deadlines still bound the wait
+    deferred_token token = defer_exec(2000, noop_callback, NULL);
+    ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+    tickless_idle_task();
+    EXPECT_EQ(matrix_disarm_count, 2);
+    EXPECT_EQ(tickless_idle_last_timeout, 2000);
+    EXPECT_TRUE(cancel_deferred_exec(token));
+}
+
+TEST_F(TicklessIdle, MatrixIsNotArmedWhileAwake) {
+    TestDriver driver;
+
+    matrix_can_arm = true;
+    tickless_idle_wake();
+    tickless_idle_task();
+    EXPECT_EQ(matrix_arm_count, 0);
+    EXPECT_EQ(tickless_idle_wait_count, 0);
+}
+
+TEST_F(TicklessIdle, StaysAwakeWhileMouseKeyIsHeld) {
+    TestDriver driver;
+    KeymapKey  key_mouse(0, 0, 0, QK_MOUSE_CURSOR_UP);
+    set_keymap({key_mouse});
+
+    EXPECT_ANY_MOUSE_REPORT(driver).Times(testing::AnyNumber());
+    key_mouse.press();
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    EXPECT_EQ(next_deadline(), timer_read32());
+    EXPECT_EQ(tickless_idle_timeout(), 0);
+
+    key_mouse.release();
+    idle_for(TICKLESS_IDLE_ACTIVITY_TIMEOUT);
+    uint32_t deadline;
+    EXPECT_FALSE(tickless_idle_next_deadline(&deadline));
+    VERIFY_AND_CLEAR(driver);
+}
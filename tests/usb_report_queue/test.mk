@@ -0,0 +1,6 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+MOUSE_ENABLE = yes
+
+SRC += $(TMK_PATH)/protocol/usb_report_queue.c
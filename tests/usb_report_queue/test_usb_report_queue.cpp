@@ -0,0 +1,174 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "report.h"
+#include "usb_report_queue.h"
+}
+
+class UsbReportQueue : public TestFixture {
+   public:
+    uint8_t            reports[USB_REPORT_QUEUE_CAPACITY * sizeof(report_mouse_t)];
+    uint8_t            sizes[USB_REPORT_QUEUE_CAPACITY];
+    usb_report_queue_t queue;
+
+    void SetUp() override {
+        queue             = {};
+        queue.reports     = reports;
+        queue.sizes       = sizes;
+        queue.report_size = sizeof(report_mouse_t);
+        queue.capacity    = USB_REPORT_QUEUE_CAPACITY;
+    }
+
+    report_mouse_t mouse(uint8_t buttons, int16_t x, int16_t y) {
+        report_mouse_t report = {};
+#ifdef MOUSE_SHARED_EP
+        report.report_id = REPORT_ID_MOUSE;
+#endif
+        report.buttons = buttons;
+        report.x       = x;
+        report.y       = y;
+        return report;
+    }
+
+    void push(const report_mouse_t &report) {
+        usb_report_queue_push(&queue, reinterpret_cast<const uint8_t *>(&report), sizeof(report));
+    }
+
+    report_mouse_t pop() {
+        size_t         size   = 0;
+        report_mouse_t report = {};
+
+        const uint8_t *queued = usb_report_queue_peek(&queue, &size);
+        EXPECT_NE(queued, nullptr);
+        EXPECT_EQ(size, sizeof(report_mouse_t));
+        if (queued != nullptr) {
+            memcpy(&report, queued, sizeof(report));
+            usb_report_queue_pop(&queue);
+        }
+        return report;
+    }
+};
+
+TEST_F(UsbReportQueue, pending_reports_are_sent_in_order) {
+    push(mouse(1, 0, 0));
+    push(mouse(0, 0, 0));
+    push(mouse(1, 0, 0));
+
+    EXPECT_EQ(pop().buttons, 1);
+    EXPECT_EQ(pop().buttons, 0);
+    EXPECT_EQ(pop().buttons, 1);
+    EXPECT_TRUE(usb_report_queue_is_empty(&queue));
+    EXPECT_EQ(queue.overflows, 0);
+}
+
+TEST_F(UsbReportQueue, identical_state_reports_are_dropped) {
+    push(mouse(1, 0, 0));
+    push(mouse(1, 0, 0));
+    push(mouse(0, 0, 0));
+    push(mouse(0, 0, 0));
+
+    EXPECT_EQ(pop().buttons, 1);
+    EXPECT_EQ(pop().buttons, 0);
+    EXPECT_TRUE(usb_report_queue_is_empty(&queue));
+}
+
+TEST_F(UsbReportQueue, state_reports_are_compared_against_reports_in_flight) {
+    report_mouse_t in_flight = mouse(1, 0, 0);
+    report_mouse_t same      = mouse(1, 0, 0);
+    report_mouse_t changed   = mouse(0, 0, 0);
+
+    EXPECT_TRUE(usb_report_queue_coalesce(&queue, reinterpret_cast<uint8_t *>(&in_flight), sizeof(in_flight), false, reinterpret_cast<const uint8_t *>(&same), sizeof(same)));
+    EXPECT_FALSE(usb_report_queue_coalesce(&queue, reinterpret_cast<uint8_t *>(&in_flight), sizeof(in_flight), false, reinterpret_cast<const uint8_t *>(&changed), sizeof(changed)));
+}
+
+TEST_F(UsbReportQueue, full_queue_counts_overflow_and_keeps_latest_state) {
+    push(mouse(1, 0, 0));
+    push(mouse(2, 0, 0));
+    push(mouse(3, 0, 0));
+    push(mouse(4, 0, 0));
+    push(mouse(5, 0, 0));
+
+    EXPECT_EQ(queue.overflows, 2);
+    EXPECT_EQ(pop().buttons, 1);
+    EXPECT_EQ(pop().buttons, 2);
+    EXPECT_EQ(pop().buttons, 5);
+    EXPECT_TRUE(usb_report_queue_is_empty(&queue));
+}
+
+TEST_F(UsbReportQueue, queue_wraps_around) {
+    push(mouse(1, 0, 0));
+    push(mouse(2, 0, 0));
+    EXPECT_EQ(pop().buttons, 1);
+    push(mouse(3, 0, 0));
+    push(mouse(4, 0, 0));
+
+    EXPECT_EQ(queue.overflows, 0);
+    EXPECT_EQ(pop().buttons, 2);
+    EXPECT_EQ(pop().buttons, 3);
+    EXPECT_EQ(pop().buttons, 4);
+    EXPECT_TRUE(usb_report_queue_is_empty(&queue));
+}
+
+TEST_F(UsbReportQueue, oversized_reports_are_counted_as_overflow) {
+    uint8_t report[sizeof(report_mouse_t) + 1] = {};
+
+    usb_report_queue_push(&queue, report, sizeof(report));
+
+    EXPECT_EQ(queue.overflows, 1);
+    EXPECT_TRUE(usb_report_queue_is_empty(&queue));
+}
+
+TEST_F(UsbReportQueue, mouse_movement_is_merged_into_waiting_report) {
+    queue.merge_report = usb_mouse_merge_report;
+
+    push(mouse(0, 10, -5));
+    push(mouse(0, 10, -5));
+    push(mouse(0, 3, 2));
+
+    report_mouse_t merged = pop();
+    EXPECT_EQ(merged.x, 23);
+    EXPECT_EQ(merged.y, -8);
+    EXPECT_TRUE(usb_report_queue_is_empty(&queue));
+}
+
+TEST_F(UsbReportQueue, mouse_movement_is_not_merged_into_report_in_flight) {
+    queue.merge_report       = usb_mouse_merge_report;
+    report_mouse_t in_flight = mouse(0, 10, 0);
+    report_mouse_t report    = mouse(0, 10, 0);
+
+    EXPECT_FALSE(usb_report_queue_coalesce(&queue, reinterpret_cast<uint8_t *>(&in_flight), sizeof(in_flight), false, reinterpret_cast<const uint8_t *>(&report), sizeof(report)));
+    EXPECT_TRUE(usb_report_queue_coalesce(&queue, reinterpret_cast<uint8_t *>(&in_flight), sizeof(in_flight), true, reinterpret_cast<const uint8_t *>(&report), sizeof(report)));
+    EXPECT_EQ(in_flight.x, 20);
+}
+
+TEST_F(UsbReportQueue, mouse_button_transitions_are_not_merged) {
+    queue.merge_report = usb_mouse_merge_report;
+
+    push(mouse(1, 5, 0));
+    push(mouse(0, 5, 0));
+    push(mouse(0, 5, 0));
+
+    report_mouse_t pressed = pop();
+    EXPECT_EQ(pressed.buttons, 1);
+    EXPECT_EQ(pressed.x, 5);
+    report_mouse_t released = pop();
+    EXPECT_EQ(released.buttons, 0);
+    EXPECT_EQ(released.x, 10);
+    EXPECT_TRUE(usb_report_queue_is_empty(&queue));
+}
+
+TEST_F(UsbReportQueue, mouse_movement_is_not_merged_past_report_range) {
+    queue.merge_report = usb_mouse_merge_report;
+    int16_t max        = (1 << (sizeof(mouse_xy_report_t) * 8 - 1)) - 1;
+
+    push(mouse(0, max, 0));
+    push(mouse(0, 1, 0));
+
+    EXPECT_EQ(pop().x, max);
+    EXPECT_EQ(pop().x, 1);
+    EXPECT_TRUE(usb_report_queue_is_empty(&queue));
+}
@@ -199,6 +199,12 @@ void protocol_pre_task(void) {
         /* Woken up */
     }
 #endif
+
+#if defined(USB_SOF_ALIGNED_TASK)
+    /* Start the keyboard task at the beginning of a frame, so reports are
+     * queued at a consistent offset from the host polling them. */
+    usb_wait_for_sof();
+#endif
 }
 
 void protocol_post_task(void) {
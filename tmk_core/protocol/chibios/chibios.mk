@@ -8,6 +8,7 @@ SRC += usb_descriptor.c
 SRC += $(CHIBIOS_DIR)/usb_driver.c
 SRC += $(CHIBIOS_DIR)/usb_endpoints.c
 SRC += $(CHIBIOS_DIR)/usb_report_handling.c
+SRC += $(PROTOCOL_DIR)/usb_report_queue.c
 SRC += $(CHIBIOS_DIR)/usb_util.c
 SRC += $(LIBSRC)
 
@@ -12,6 +12,13 @@
 #include "usb_driver.h"
 #include "util.h"
 
+#if defined(REPORT_LATENCY_ENABLE)
+#    include "report_latency.h"
+#endif
+#if defined(TICKLESS_IDLE_ENABLE)
+#    include "tickless_idle.h"
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -56,6 +63,13 @@ static void ibnotify(io_buffers_queue_t *bqp) {
 static void obnotify(io_buffers_queue_t *bqp) {
     usb_endpoint_in_t *endpoint = bqGetLinkX(bqp);
 
+#if defined(REPORT_LATENCY_ENABLE)
+    /* The buffer just posted is the one before the write pointer. */
+    uint8_t *posted = (bqp->bwrptr == bqp->buffers ? bqp->btop : bqp->bwrptr) - bqp->bsize;
+
+    endpoint->enqueue_times[(posted - bqp->buffers) / bqp->bsize] = chVTGetSystemTimeX();
+#endif
+
     /* If the USB endpoint is not in the appropriate state then transactions
        must not be started.*/
     if ((usbGetDriverStateI(endpoint->config.usbp) != USB_ACTIVE)) {
@@ -124,6 +138,9 @@ void usb_endpoint_in_stop(usb_endpoint_in_t *endpoint) {
 
     bqSuspendI(&endpoint->obqueue);
     obqResetI(&endpoint->obqueue);
+    if (endpoint->report_queue != NULL) {
+        usb_report_queue_clear(endpoint->report_queue);
+    }
     if (endpoint->report_storage != NULL) {
         endpoint->report_storage->reset_report(endpoint->report_storage->reports);
     }
@@ -147,6 +164,10 @@ void usb_endpoint_in_suspend_cb(usb_endpoint_in_t *endpoint) {
     bqSuspendI(&endpoint->obqueue);
     obqResetI(&endpoint->obqueue);
 
+    if (endpoint->report_queue != NULL) {
+        usb_report_queue_clear(endpoint->report_queue);
+    }
+
     if (endpoint->report_storage != NULL) {
         endpoint->report_storage->reset_report(endpoint->report_storage->reports);
     }
@@ -183,6 +204,28 @@ void usb_endpoint_out_configure_cb(usb_endpoint_out_t *endpoint) {
     (void)usb_start_receive(endpoint);
 }
 
+/**
+ * @brief Moves the pending reports of an endpoint into its free buffers.
+ */
+static void usb_endpoint_in_post_pending(usb_endpoint_in_t *endpoint) {
+    usb_report_queue_t *queue = endpoint->report_queue;
+    if (queue == NULL) {
+        return;
+    }
+
+    size_t         size;
+    const uint8_t *report;
+    while ((report = usb_report_queue_peek(queue, &size)) != NULL) {
+        uint8_t *buffer = obqGetEmptyBufferI(&endpoint->obqueue);
+        if (buffer == NULL) {
+            return;
+        }
+        memcpy(buffer, report, size);
+        obqPostFullBufferI(&endpoint->obqueue, size);
+        usb_report_queue_pop(queue);
+    }
+}
+
 void usb_endpoint_in_tx_complete_cb(USBDriver *usbp, usbep_t ep) {
     usb_endpoint_in_t *endpoint = usbp->in_params[ep - 1U];
     size_t             n;
@@ -199,6 +242,11 @@ void usb_endpoint_in_tx_complete_cb(USBDriver *usbp, usbep_t ep) {
 
     /* Freeing the buffer just transmitted, if it was not a zero size packet.*/
     if (!obqIsEmptyI(&endpoint->obqueue) && usbp->epc[ep]->in_state->txsize > 0U) {
+#if defined(REPORT_LATENCY_ENABLE)
+        /* The buffer just transmitted is the one at the read pointer. */
+        output_buffers_queue_t *obqp = &endpoint->obqueue;
+        report_latency_record(ep, TIME_I2US(chVTTimeElapsedSinceX(endpoint->enqueue_times[(obqp->brdptr - obqp->buffers) / obqp->bsize])));
+#endif
         /* Store the last send report in the endpoint to be retrieved by a
          * GET_REPORT request or IDLE report handling. */
         if (endpoint->report_storage != NULL) {
@@ -225,7 +273,19 @@ void usb_endpoint_in_tx_complete_cb(USBDriver *usbp, usbep_t ep) {
         /* Nothing to transmit.*/
     }
 
+    /* Reports waiting for a buffer take the one just freed, and are sent
+     * straight away if the endpoint is idle. */
+    usb_endpoint_in_post_pending(endpoint);
+
     osalSysUnlockFromISR();
+
+#if defined(TICKLESS_IDLE_ENABLE)
+    /* Endpoints without a report queue are written from the main loop, which
+     * may be waiting for the buffer just freed, e.g. to drain the console. */
+    if (endpoint->report_queue == NULL) {
+        tickless_idle_wake();
+    }
+#endif
 }
 
 void usb_endpoint_out_rx_complete_cb(USBDriver *usbp, usbep_t ep) {
@@ -248,6 +308,13 @@ void usb_endpoint_out_rx_complete_cb(USBDriver *usbp, usbep_t ep) {
     usb_start_receive(endpoint);
 
     osalSysUnlockFromISR();
+
+#if defined(TICKLESS_IDLE_ENABLE)
+    /* Received packets are handled by the main loop, which may be waiting. */
+    if (size > 0) {
+        tickless_idle_wake();
+    }
+#endif
 }
 
 bool usb_endpoint_in_send(usb_endpoint_in_t *endpoint, const uint8_t *data, size_t size, sysinterval_t timeout, bool buffered) {
@@ -291,6 +358,59 @@ bool usb_endpoint_in_send(usb_endpoint_in_t *endpoint, const uint8_t *data, size
     }
 }
 
+bool usb_endpoint_in_post(usb_endpoint_in_t *endpoint, const uint8_t *data, size_t size) {
+    osalDbgCheck((endpoint != NULL) && (endpoint->report_queue != NULL) && (data != NULL) && (size > 0U) && (size <= endpoint->config.buffer_size));
+
+    output_buffers_queue_t *obqp  = &endpoint->obqueue;
+    usb_report_queue_t *    queue = endpoint->report_queue;
+
+    osalSysLock();
+    if (usbGetDriverStateI(endpoint->config.usbp) != USB_ACTIVE) {
+        osalSysUnlock();
+        return false;
+    }
+
+    /* Reports already waiting for a buffer are older, keep the order. */
+    if (!usb_report_queue_is_empty(queue)) {
+        usb_report_queue_push(queue, data, size);
+        usb_endpoint_in_post_pending(endpoint);
+        osalSysUnlock();
+        return true;
+    }
+
+    /* Full buffers are either waiting to be sent or, for the oldest one, in
+     * flight while the endpoint is transmitting. */
+    size_t full    = obqp->bn - bqSpaceI(obqp);
+    size_t waiting = full;
+    if (full > 0U && usbGetTransmitStatusI(endpoint->config.usbp, endpoint->config.ep)) {
+        waiting--;
+    }
+
+    if (full > 0U) {
+        uint8_t *last = (obqp->bwrptr == obqp->buffers ? obqp->btop : obqp->bwrptr) - obqp->bsize;
+
+        if (usb_report_queue_coalesce(queue, last + sizeof(size_t), *(size_t *)last, waiting > 0U, data, size)) {
+            osalSysUnlock();
+            return true;
+        }
+    }
+
+    uint8_t *buffer = obqGetEmptyBufferI(obqp);
+    if (buffer == NULL) {
+        /* The host isn't keeping up, the report waits for the endpoint to
+         * finish sending one rather than the caller waiting. */
+        usb_report_queue_push(queue, data, size);
+        osalSysUnlock();
+        return true;
+    }
+
+    memcpy(buffer, data, size);
+    obqPostFullBufferI(obqp, size);
+    osalSysUnlock();
+
+    return true;
+}
+
 void usb_endpoint_in_flush(usb_endpoint_in_t *endpoint, bool padded) {
     osalDbgCheck(endpoint != NULL);
 
@@ -320,6 +440,20 @@ bool usb_endpoint_in_is_inactive(usb_endpoint_in_t *endpoint) {
     return inactive;
 }
 
+/**
+ * @brief Whether a packet can be written to the endpoint without waiting,
+ * i.e. the device is configured and one of the endpoint's buffers is empty.
+ */
+bool usb_endpoint_in_is_writable(usb_endpoint_in_t *endpoint) {
+    osalDbgCheck(endpoint != NULL);
+
+    osalSysLock();
+    bool writable = usbGetDriverStateI(endpoint->config.usbp) == USB_ACTIVE && bqSpaceI(&endpoint->obqueue) > 0U;
+    osalSysUnlock();
+
+    return writable;
+}
+
 bool usb_endpoint_out_receive(usb_endpoint_out_t *endpoint, uint8_t *data, size_t size, sysinterval_t timeout) {
     osalDbgCheck((endpoint != NULL) && (data != NULL) && (size > 0U));
 
@@ -21,6 +21,7 @@
 #include "host.h"
 #include "suspend.h"
 #include "timer.h"
+#include "sendchar.h"
 #ifdef SLEEP_LED_ENABLE
 #    include "sleep_led.h"
 #    include "led.h"
@@ -31,6 +32,9 @@
 #include "usb_descriptor.h"
 #include "usb_driver.h"
 #include "usb_types.h"
+#ifdef TICKLESS_IDLE_ENABLE
+#    include "tickless_idle.h"
+#endif
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -113,6 +117,10 @@ static inline bool usb_event_queue_enqueue(usbevent_t event) {
     }
     event_queue[event_queue_head] = event;
     event_queue_head              = next;
+#ifdef TICKLESS_IDLE_ENABLE
+    // Events are handled by the main loop, which may be waiting
+    tickless_idle_wake();
+#endif
     return true;
 }
 
@@ -252,6 +260,9 @@ static void set_led_transfer_cb(USBDriver *usbp) {
     } else {
         usb_device_state_set_leds(set_report_buf[0]);
     }
+#ifdef TICKLESS_IDLE_ENABLE
+    tickless_idle_wake();
+#endif
 }
 
 static bool usb_requests_hook_cb(USBDriver *usbp) {
@@ -329,17 +340,45 @@ static __attribute__((unused)) void dummy_cb(USBDriver *usbp) {
     (void)usbp;
 }
 
+#if defined(USB_SOF_ALIGNED_TASK)
+static binary_semaphore_t sof_semaphore;
+
+static void usb_sof_cb(USBDriver *usbp) {
+    (void)usbp;
+    osalSysLockFromISR();
+    chBSemSignalI(&sof_semaphore);
+    osalSysUnlockFromISR();
+}
+
+void usb_wait_for_sof(void) {
+    if (USB_DRIVER.state != USB_ACTIVE) {
+        return;
+    }
+
+    /* Wait for the next start of frame, not one which was already missed. The
+     * timeout covers the host not sending frames, e.g. while suspending. */
+    chBSemReset(&sof_semaphore, true);
+    chBSemWaitTimeout(&sof_semaphore, TIME_MS2I(2));
+}
+#endif
+
 static const USBConfig usbcfg = {
     usb_event_cb,          /* USB events callback */
     usb_get_descriptor_cb, /* Device GET_DESCRIPTOR request callback */
     usb_requests_hook_cb,  /* Requests hook callback */
-#if STM32_USB_USE_OTG1 == TRUE || STM32_USB_USE_OTG2 == TRUE
+#if defined(USB_SOF_ALIGNED_TASK)
+    usb_sof_cb, /* Start Of Frame callback, also covering the OTG workaround below */
+#elif STM32_USB_USE_OTG1 == TRUE || STM32_USB_USE_OTG2 == TRUE
     dummy_cb, /* Workaround for OTG Peripherals not servicing new interrupts
     after resuming from suspend. */
 #endif
 };
 
 void init_usb_driver(USBDriver *usbp) {
+#if defined(USB_SOF_ALIGNED_TASK)
+    chBSemObjectInit(&sof_semaphore, true);
+#endif
+
     for (int i = 0; i < USB_ENDPOINT_IN_COUNT; i++) {
         usb_endpoint_in_init(&usb_endpoints_in[i]);
         usb_endpoint_in_start(&usb_endpoints_in[i]);
@@ -397,7 +436,9 @@ __attribute__((weak)) void restart_usb_driver(USBDriver *usbp) {
 
 /**
  * @brief Send a report to the host, the report is enqueued into an output
- * queue and send once the USB endpoint becomes empty.
+ * queue and send once the USB endpoint becomes empty. Endpoints with a report
+ * queue coalesce the report with the ones already waiting and never wait,
+ * other endpoints wait up to 100ms for room in the queue if needed.
  *
  * @param endpoint USB IN endpoint to send the report from
  * @param report pointer to the report
@@ -406,6 +447,9 @@ __attribute__((weak)) void restart_usb_driver(USBDriver *usbp) {
  * @return false Failure
  */
 bool send_report(usb_endpoint_in_lut_t endpoint, void *report, size_t size) {
+    if (usb_endpoints_in[endpoint].report_queue != NULL) {
+        return usb_endpoint_in_post(&usb_endpoints_in[endpoint], (uint8_t *)report, size);
+    }
     return usb_endpoint_in_send(&usb_endpoints_in[endpoint], (uint8_t *)report, size, TIME_MS2I(100), false);
 }
 
@@ -512,12 +556,21 @@ void send_digitizer(report_digitizer_t *report) {
 
 #ifdef CONSOLE_ENABLE
 
+/* Printing only queues the characters, so it takes no longer when nobody is
+ * reading the console. They are sent from console_task() as long as the
+ * endpoint has room, a full packet at a time. */
 int8_t sendchar(uint8_t c) {
-    return (int8_t)send_report_buffered(USB_ENDPOINT_IN_CONSOLE, &c, sizeof(uint8_t));
+    return console_buffer_put(c);
 }
 
 void console_task(void) {
-    flush_report_buffered(USB_ENDPOINT_IN_CONSOLE, true);
+    usb_endpoint_in_t *endpoint = &usb_endpoints_in[USB_ENDPOINT_IN_CONSOLE];
+
+    while (console_buffer_available() > 0 && usb_endpoint_in_is_writable(endpoint)) {
+        uint8_t packet[CONSOLE_EPSIZE] = {0};
+        console_buffer_read(packet, sizeof(packet));
+        send_report(USB_ENDPOINT_IN_CONSOLE, packet, sizeof(packet));
+    }
 }
 
 #endif /* CONSOLE_ENABLE */
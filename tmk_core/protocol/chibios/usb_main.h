@@ -34,6 +34,11 @@ void restart_usb_driver(USBDriver *usbp);
 
 bool send_report(usb_endpoint_in_lut_t endpoint, void *report, size_t size);
 
+#if defined(USB_SOF_ALIGNED_TASK)
+/* Block until the host starts the next USB frame */
+void usb_wait_for_sof(void);
+#endif
+
 /* ---------------
  * USB Event queue
  * ---------------
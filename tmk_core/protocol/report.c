@@ -33,8 +33,15 @@ uint8_t has_anykey(void) {
     uint8_t  lp  = sizeof(keyboard_report->keys);
 #ifdef NKRO_ENABLE
     if (usb_device_state_get_protocol() == USB_PROTOCOL_REPORT && keymap_config.nkro) {
+#    ifdef NKRO_AUTO
+        // Keys overflowing the 6KRO report are counted on top of it
+        for (uint8_t i = 0; i < NKRO_REPORT_BITS; i++) {
+            if (nkro_report->bits[i]) cnt++;
+        }
+#    else
         p  = nkro_report->bits;
         lp = sizeof(nkro_report->bits);
+#    endif
     }
 #endif
     while (lp--) {
@@ -53,6 +60,11 @@ uint8_t get_first_key(void) {
         uint8_t i = 0;
         for (; i < NKRO_REPORT_BITS && !nkro_report->bits[i]; i++)
             ;
+#    ifdef NKRO_AUTO
+        if (i == NKRO_REPORT_BITS) {
+            return keyboard_report->keys[0];
+        }
+#    endif
         return i << 3 | biton(nkro_report->bits[i]);
     }
 #endif
@@ -70,11 +82,17 @@ bool is_key_pressed(uint8_t key) {
     }
 #ifdef NKRO_ENABLE
     if (usb_device_state_get_protocol() == USB_PROTOCOL_REPORT && keymap_config.nkro) {
+#    ifdef NKRO_AUTO
+        if ((key >> 3) < NKRO_REPORT_BITS && nkro_report->bits[key >> 3] & 1 << (key & 7)) {
+            return true;
+        }
+#    else
         if ((key >> 3) < NKRO_REPORT_BITS) {
             return nkro_report->bits[key >> 3] & 1 << (key & 7);
         } else {
             return false;
         }
+#    endif
     }
 #endif
     for (int i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
@@ -87,9 +105,9 @@ bool is_key_pressed(uint8_t key) {
 
 /** \brief add key byte
  *
- * FIXME: Needs doc
+ * Returns false if the report is full and the key couldn't be added
  */
-void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+bool add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
     int8_t i     = 0;
     int8_t empty = -1;
     for (; i < KEYBOARD_REPORT_KEYS; i++) {
@@ -101,10 +119,12 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
         }
     }
     if (i == KEYBOARD_REPORT_KEYS) {
-        if (empty != -1) {
-            keyboard_report->keys[empty] = code;
+        if (empty == -1) {
+            return false;
         }
+        keyboard_report->keys[empty] = code;
     }
+    return true;
 }
 
 /** \brief del key byte
@@ -152,7 +172,14 @@ void del_key_bit(report_nkro_t* nkro_report, uint8_t code) {
 void add_key_to_report(uint8_t key) {
 #ifdef NKRO_ENABLE
     if (usb_device_state_get_protocol() == USB_PROTOCOL_REPORT && keymap_config.nkro) {
+#    ifdef NKRO_AUTO
+        // A key stays in the report it was added to until released, so the host never sees it move
+        if (!is_key_pressed(key) && !add_key_byte(keyboard_report, key)) {
+            add_key_bit(nkro_report, key);
+        }
+#    else
         add_key_bit(nkro_report, key);
+#    endif
         return;
     }
 #endif
@@ -167,7 +194,9 @@ void del_key_from_report(uint8_t key) {
 #ifdef NKRO_ENABLE
     if (usb_device_state_get_protocol() == USB_PROTOCOL_REPORT && keymap_config.nkro) {
         del_key_bit(nkro_report, key);
+#    ifndef NKRO_AUTO
         return;
+#    endif
     }
 #endif
     del_key_byte(keyboard_report, key);
@@ -182,7 +211,9 @@ void clear_keys_from_report(void) {
 #ifdef NKRO_ENABLE
     if (usb_device_state_get_protocol() == USB_PROTOCOL_REPORT && keymap_config.nkro) {
         memset(nkro_report->bits, 0, sizeof(nkro_report->bits));
+#    ifndef NKRO_AUTO
         return;
+#    endif
     }
 #endif
     memset(keyboard_report->keys, 0, sizeof(keyboard_report->keys));
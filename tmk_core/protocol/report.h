@@ -336,7 +336,7 @@ uint8_t has_anykey(void);
 uint8_t get_first_key(void);
 bool    is_key_pressed(uint8_t key);
 
-void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code);
+bool add_key_byte(report_keyboard_t* keyboard_report, uint8_t code);
 void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code);
 #ifdef NKRO_ENABLE
 void add_key_bit(report_nkro_t* nkro_report, uint8_t code);
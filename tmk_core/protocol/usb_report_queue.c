@@ -0,0 +1,117 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+
+#include "usb_report_queue.h"
+#include "report.h"
+
+bool usb_report_queue_coalesce(usb_report_queue_t *queue, uint8_t *newest, size_t newest_size, bool newest_waiting, const uint8_t *report, size_t size) {
+    if (queue->merge_report != NULL) {
+        /* Relative reports carry changes rather than state, so they are only
+         * ever merged into a report still waiting, never dropped. */
+        return newest_waiting && newest_size == size && queue->merge_report(newest, report, size);
+    }
+
+    /* Nothing changed since the newest report, the host already has or will
+     * get this state. */
+    return newest_size == size && memcmp(newest, report, size) == 0;
+}
+
+static inline uint8_t *usb_report_queue_slot(usb_report_queue_t *queue, uint8_t index) {
+    return &queue->reports[((queue->head + index) % queue->capacity) * queue->report_size];
+}
+
+void usb_report_queue_push(usb_report_queue_t *queue, const uint8_t *report, size_t size) {
+    if (size > queue->report_size || queue->capacity == 0) {
+        queue->overflows++;
+        return;
+    }
+
+    if (queue->count > 0) {
+        uint8_t  newest_index = (queue->head + queue->count - 1) % queue->capacity;
+        uint8_t *newest       = usb_report_queue_slot(queue, queue->count - 1);
+        if (usb_report_queue_coalesce(queue, newest, queue->sizes[newest_index], true, report, size)) {
+            return;
+        }
+
+        if (queue->count == queue->capacity) {
+            /* The host isn't keeping up at all, give up a transition rather
+             * than wait, but keep the latest state. */
+            queue->overflows++;
+            memcpy(newest, report, size);
+            queue->sizes[newest_index] = size;
+            return;
+        }
+    }
+
+    uint8_t index = (queue->head + queue->count) % queue->capacity;
+    memcpy(usb_report_queue_slot(queue, queue->count), report, size);
+    queue->sizes[index] = size;
+    queue->count++;
+}
+
+const uint8_t *usb_report_queue_peek(usb_report_queue_t *queue, size_t *size) {
+    if (queue->count == 0) {
+        return NULL;
+    }
+    *size = queue->sizes[queue->head];
+    return usb_report_queue_slot(queue, 0);
+}
+
+void usb_report_queue_pop(usb_report_queue_t *queue) {
+    if (queue->count > 0) {
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+    }
+}
+
+void usb_report_queue_clear(usb_report_queue_t *queue) {
+    queue->head  = 0;
+    queue->count = 0;
+}
+
+#if defined(MOUSE_ENABLE)
+bool usb_mouse_merge_report(uint8_t *queued, const uint8_t *report, size_t size) {
+    if (size != sizeof(report_mouse_t)) {
+        return false;
+    }
+
+    report_mouse_t        merged;
+    const report_mouse_t *mouse = (const report_mouse_t *)report;
+    memcpy(&merged, queued, sizeof(report_mouse_t));
+
+#    if defined(MOUSE_SHARED_EP)
+    if (merged.report_id != REPORT_ID_MOUSE || mouse->report_id != REPORT_ID_MOUSE) {
+        return false;
+    }
+#    endif
+
+    /* Every button transition reaches the host, only movement is merged */
+    if (merged.buttons != mouse->buttons) {
+        return false;
+    }
+
+    int32_t x = (int32_t)merged.x + mouse->x;
+    int32_t y = (int32_t)merged.y + mouse->y;
+    int32_t v = (int32_t)merged.v + mouse->v;
+    int32_t h = (int32_t)merged.h + mouse->h;
+
+    /* Queue the report separately rather than lose movement to clamping */
+    if ((mouse_xy_report_t)x != x || (mouse_xy_report_t)y != y || (mouse_hv_report_t)v != v || (mouse_hv_report_t)h != h) {
+        return false;
+    }
+
+    merged.x = x;
+    merged.y = y;
+    merged.v = v;
+    merged.h = h;
+#    if defined(MOUSE_EXTENDED_REPORT)
+    merged.boot_x = (x > 127) ? 127 : ((x < -127) ? -127 : x);
+    merged.boot_y = (y > 127) ? 127 : ((y < -127) ? -127 : y);
+#    endif
+
+    memcpy(queued, &merged, sizeof(report_mouse_t));
+    return true;
+}
+#endif
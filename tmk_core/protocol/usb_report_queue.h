@@ -0,0 +1,82 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Number of reports an endpoint keeps waiting for a free USB buffer */
+#ifndef USB_REPORT_QUEUE_CAPACITY
+#    define USB_REPORT_QUEUE_CAPACITY 8
+#endif
+
+/**
+ * @brief Coalescing policy and pending reports of an IN endpoint
+ *
+ * Posting a report to an endpoint with a report queue never waits. On
+ * endpoints with a merge function, a report is merged into the newest one
+ * still waiting to be sent, if possible. On the others, a report identical to
+ * the newest one queued or in flight is dropped. Every other report gets its
+ * own USB buffer or, once these are all in use, waits in the pending reports
+ * until the endpoint finishes sending one, so no transition is lost. Only
+ * once the pending reports are full too is the newest one replaced, so that
+ * the host still ends up in the latest state, and counted as an overflow.
+ */
+typedef struct {
+    /**
+     * @brief Merges a report into the newest report waiting to be sent,
+     * returning false if the two can't be merged. May be NULL.
+     */
+    bool (*merge_report)(uint8_t *queued, const uint8_t *report, size_t size);
+
+    /**
+     * @brief Number of reports which replaced a pending report
+     */
+    uint32_t overflows;
+
+    /**
+     * @brief Storage for the pending reports, each report_size bytes long
+     */
+    uint8_t *reports;
+    uint8_t *sizes;
+    uint8_t  report_size;
+    uint8_t  capacity;
+    uint8_t  head;
+    uint8_t  count;
+} usb_report_queue_t;
+
+/**
+ * @brief Tries to fold a report into the newest one queued, returning true if
+ * nothing else needs to be sent for it.
+ *
+ * @param newest_waiting false if the newest report is already being sent, so
+ * it can no longer be merged into
+ */
+bool usb_report_queue_coalesce(usb_report_queue_t *queue, uint8_t *newest, size_t newest_size, bool newest_waiting, const uint8_t *report, size_t size);
+
+/**
+ * @brief Adds a report to the pending reports, coalescing it with the newest
+ * one if possible.
+ */
+void usb_report_queue_push(usb_report_queue_t *queue, const uint8_t *report, size_t size);
+
+/**
+ * @brief The oldest pending report, or NULL if there are none.
+ */
+const uint8_t *usb_report_queue_peek(usb_report_queue_t *queue, size_t *size);
+
+/**
+ * @brief Removes the oldest pending report.
+ */
+void usb_report_queue_pop(usb_report_queue_t *queue);
+
+void usb_report_queue_clear(usb_report_queue_t *queue);
+
+static inline bool usb_report_queue_is_empty(usb_report_queue_t *queue) {
+    return queue->count == 0;
+}
+
+// Report queue merge functions
+bool usb_mouse_merge_report(uint8_t *queued, const uint8_t *report, size_t size);